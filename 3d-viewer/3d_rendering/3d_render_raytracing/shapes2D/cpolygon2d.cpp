@@ -655,7 +655,7 @@ void Convert_path_polygon_to_polygon_blocks_and_dummy_blocks(
 
                 for( int idx = 0; idx < solution.OutlineCount(); idx++ )
                 {
-                    const SHAPE_LINE_CHAIN & outline = solution.Outline( idx );
+                    const SHAPE_LINE_CHAIN & outline = solution.COutline( idx );
 
                     SEGMENTS solutionSegment;
 
@@ -668,7 +668,7 @@ void Convert_path_polygon_to_polygon_blocks_and_dummy_blocks(
                          holeIdx < solution.HoleCount( idx );
                          holeIdx++ )
                     {
-                        const SHAPE_LINE_CHAIN & hole = solution.Hole( idx, holeIdx );
+                        const SHAPE_LINE_CHAIN & hole = solution.CHole( idx, holeIdx );
 
                         polygon_Convert( hole, solutionSegment, aBiuTo3DunitsScale );
                         outersAndHoles.m_Holes.push_back( solutionSegment );
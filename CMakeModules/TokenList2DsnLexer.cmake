@@ -57,6 +57,10 @@
 #                  path as the token list file path, with a file name of *_lexer.h
 #
 # Use the max_lexer() CMake function from functions.cmake for invocation convenience.
+#
+# Besides the keywords table, the generated cpp file holds the keyword lookup used by
+# DSNLEXER::NextTok(): a switch on the length of the token, then nested switches on its
+# chars (a trie), and a memcmp() of the remaining chars once a single keyword is left.
 
 
 #message( STATUS "TokenList2DsnLexer.cmake" )    # indicate we are running
@@ -150,6 +154,8 @@ set( sourceFileHeader
  * your DSN lexer.
  */
 
+#include <cstring>
+
 #include <${result}_lexer.h>
 
 using namespace ${enum};
@@ -160,6 +166,92 @@ const KEYWORD ${LEXERCLASS}::keywords[] = {
 "
 )
 
+# Function emit_trie
+# appends to lookupCode the body of a switch case returning the token of the keyword
+# of ARGN matching aText, or breaking if none matches.  The keywords of ARGN all have
+# the same length and share their first aDepth chars.  The code is indented by aIndent.
+function( emit_trie aDepth aIndent )
+    set( group ${ARGN} )
+    list( LENGTH group groupCount )
+    list( GET group 0 first )
+    string( LENGTH "${first}" length )
+
+    if( groupCount EQUAL 1 )
+        math( EXPR restLength "${length} - ${aDepth}" )
+
+        if( restLength EQUAL 0 )
+            set( lookupCode "${lookupCode}${aIndent}return T_${first};\n" )
+        else()
+            string( SUBSTRING "${first}" ${aDepth} ${restLength} rest )
+            set( lookupCode "${lookupCode}${aIndent}if( !memcmp( aText + ${aDepth}, \"${rest}\", ${restLength} ) )\n" )
+            set( lookupCode "${lookupCode}${aIndent}    return T_${first};\n\n${aIndent}break;\n" )
+        endif()
+
+        set( lookupCode "${lookupCode}" PARENT_SCOPE )
+        return()
+    endif()
+
+    # Compare the chars shared by the whole group at once
+    set( depth ${aDepth} )
+    set( shared 1 )
+
+    while( shared EQUAL 1 )
+        string( SUBSTRING "${first}" ${depth} 1 char )
+
+        foreach( token ${group} )
+            string( SUBSTRING "${token}" ${depth} 1 tokenChar )
+
+            if( NOT tokenChar STREQUAL char )
+                set( shared 0 )
+            endif()
+        endforeach()
+
+        if( shared EQUAL 1 )
+            math( EXPR depth "${depth} + 1" )
+        endif()
+    endwhile()
+
+    if( depth GREATER aDepth )
+        math( EXPR sharedLength "${depth} - ${aDepth}" )
+        string( SUBSTRING "${first}" ${aDepth} ${sharedLength} sharedChars )
+        set( lookupCode "${lookupCode}${aIndent}if( memcmp( aText + ${aDepth}, \"${sharedChars}\", ${sharedLength} ) )\n" )
+        set( lookupCode "${lookupCode}${aIndent}    break;\n\n" )
+    endif()
+
+    # Then switch on the first char telling the keywords apart, the group is sorted
+    set( chars "" )
+
+    foreach( token ${group} )
+        string( SUBSTRING "${token}" ${depth} 1 char )
+        list( APPEND chars "${char}" )
+    endforeach()
+
+    list( REMOVE_DUPLICATES chars )
+    math( EXPR nextDepth "${depth} + 1" )
+
+    set( lookupCode "${lookupCode}${aIndent}switch( aText[${depth}] )\n${aIndent}{\n" )
+
+    foreach( char ${chars} )
+        set( subGroup "" )
+
+        foreach( token ${group} )
+            string( SUBSTRING "${token}" ${depth} 1 tokenChar )
+
+            if( tokenChar STREQUAL char )
+                list( APPEND subGroup "${token}" )
+            endif()
+        endforeach()
+
+        set( lookupCode "${lookupCode}${aIndent}case '${char}':\n" )
+        emit_trie( ${nextDepth} "${aIndent}    " ${subGroup} )
+    endforeach()
+
+    set( lookupCode "${lookupCode}${aIndent}}\n\n${aIndent}break;\n" )
+
+    set( lookupCode "${lookupCode}" PARENT_SCOPE )
+endfunction()
+
+
 file( STRINGS ${inputFile} lines NO_HEX_CONVERSION )
 
 foreach( line ${lines} )
@@ -223,6 +315,39 @@ foreach( token ${tokens} )
     math( EXPR lineCount "${lineCount} + 1" )
 endforeach()
 
+# The keyword lookup, grouping the keywords by length
+set( maxLength 0 )
+
+foreach( token ${tokens} )
+    string( LENGTH "${token}" length )
+
+    if( length GREATER maxLength )
+        set( maxLength ${length} )
+    endif()
+endforeach()
+
+set( lookupCode "" )
+
+foreach( length RANGE 1 ${maxLength} )
+    set( group "" )
+
+    foreach( token ${tokens} )
+        string( LENGTH "${token}" tokenLength )
+
+        if( tokenLength EQUAL length )
+            list( APPEND group "${token}" )
+        endif()
+    endforeach()
+
+    list( LENGTH group groupCount )
+
+    if( groupCount GREATER 0 )
+        set( lookupCode "${lookupCode}    case ${length}:\n" )
+        emit_trie( 0 "        " ${group} )
+        set( lookupCode "${lookupCode}\n" )
+    endif()
+endforeach()
+
 file( APPEND "${outHeaderFile}"
 "    };
 }   // namespace ${enum}
@@ -240,6 +365,13 @@ class ${LEXERCLASS} : public DSNLEXER
     static const KEYWORD  keywords[];
     static const unsigned keyword_count;
 
+    /**
+     * Function findKeyword
+     * is the auto generated lookup of the keywords, see TokenList2DsnLexer.cmake.
+     * @return int - the token of the keyword @a aText of @a aLength chars, or DSN_SYMBOL.
+     */
+    static int findKeyword( const char* aText, size_t aLength );
+
 public:
     /**
      * Constructor ( const std::string&, const wxString& )
@@ -250,6 +382,7 @@ public:
     ${LEXERCLASS}( const std::string& aSExpression, const wxString& aSource = wxEmptyString ) :
         DSNLEXER( keywords, keyword_count, aSExpression, aSource )
     {
+        keywordLookup = findKeyword;
     }
 
     /**
@@ -264,6 +397,7 @@ public:
     ${LEXERCLASS}( FILE* aFile, const wxString& aFilename ) :
         DSNLEXER( keywords, keyword_count, aFile, aFilename )
     {
+        keywordLookup = findKeyword;
     }
 
     /**
@@ -280,6 +414,7 @@ public:
     ${LEXERCLASS}( LINE_READER* aLineReader ) :
         DSNLEXER( keywords, keyword_count, aLineReader )
     {
+        keywordLookup = findKeyword;
     }
 
     /**
@@ -370,6 +505,16 @@ file( APPEND "${outCppFile}"
 const unsigned ${LEXERCLASS}::keyword_count = unsigned( sizeof( ${LEXERCLASS}::keywords )/sizeof( ${LEXERCLASS}::keywords[0] ) );
 
 
+int ${LEXERCLASS}::findKeyword( const char* aText, size_t aLength )
+{
+    switch( aLength )
+    {
+${lookupCode}    }
+
+    return DSN_SYMBOL;
+}
+
+
 const char* ${LEXERCLASS}::TokenName( T aTok )
 {
     const char* ret;
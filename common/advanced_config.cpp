@@ -65,6 +65,54 @@ static const wxChar EnableSvgImport[] = wxT( "EnableSvgImport" );
  */
 static const wxChar RealtimeConnectivity[] = wxT( "RealtimeConnectivity" );
 
+/**
+ * Testing mode for incremental DRC.  Setting this to on keeps the DRC indexes after a full
+ * DRC run and re-tests the tracks, vias and pads modified by each edit, updating their
+ * clearance markers on the fly.
+ */
+static const wxChar RealtimeDrc[] = wxT( "RealtimeDrc" );
+
+/**
+ * Testing mode for tiled zone filling.  Zones with at least this number of clearance holes
+ * are split in tiles, filled in parallel and stitched back together, so the fill of a single
+ * large zone uses all the cores.  0 (the default) disables the tiled fill.
+ */
+static const wxChar ZoneFillTilingThreshold[] = wxT( "ZoneFillTilingThreshold" );
+
+/**
+ * Number of worker threads of the thread pool shared by the parallel algorithms (zone
+ * filling, DRC, connectivity, 3D raytracing...).  0 (the default) uses one thread per core.
+ * The pool is created on first use, so changes need a restart.
+ */
+static const wxChar ThreadPoolSize[] = wxT( "ThreadPoolSize" );
+
+/**
+ * Update the connectivity clusters from the added and removed items only, instead of
+ * searching all the items of the board again after each change.
+ */
+static const wxChar IncrementalConnectivity[] = wxT( "IncrementalConnectivity" );
+
+/**
+ * Record the calls made to the push and shove router by the routing tools to this file.
+ * The calls are saved along with the router debug log, and can be replayed with the
+ * router_replay tool of qa_pcbnew_tools to profile the router. Nothing is recorded if
+ * the path is empty.
+ */
+static const wxChar RouterEventLog[] = wxT( "RouterEventLog" );
+
+/**
+ * Walk around the obstacles in both directions concurrently on the thread pool, and keep
+ * the cheapest of the two paths instead of the first one to get around.
+ */
+static const wxChar RouterParallelCandidates[] = wxT( "RouterParallelCandidates" );
+
+/**
+ * Parse the footprints, tracks, zones and drawings of the .kicad_pcb files on the worker
+ * threads of the thread pool.  The records of the items are split by a scan matching their
+ * parentheses, and the parsed items are added to the board in file order.
+ */
+static const wxChar ParallelBoardLoad[] = wxT( "ParallelBoardLoad" );
+
 /**
  * Allow legacy canvas to be shown in GTK3. Legacy canvas is generally pretty
  * broken, but this avoids code in an ifdef where it could become broken
@@ -152,6 +200,12 @@ ADVANCED_CFG::ADVANCED_CFG()
     m_enableSvgImport = false;
     m_allowLegacyCanvasInGtk3 = false;
     m_realTimeConnectivity = true;
+    m_realTimeDrc = false;
+    m_zoneFillTilingThreshold = 0;
+    m_threadPoolSize = 0;
+    m_incrementalConnectivity = false;
+    m_routerParallelCandidates = false;
+    m_parallelBoardLoad = false;
 
     loadFromConfigFile();
 }
@@ -194,6 +248,27 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
     configParams.push_back(
             new PARAM_CFG_BOOL( true, AC_KEYS::RealtimeConnectivity, &m_realTimeConnectivity, false ) );
 
+    configParams.push_back(
+            new PARAM_CFG_BOOL( true, AC_KEYS::RealtimeDrc, &m_realTimeDrc, false ) );
+
+    configParams.push_back( new PARAM_CFG_INT(
+            true, AC_KEYS::ZoneFillTilingThreshold, &m_zoneFillTilingThreshold, 0, 0 ) );
+
+    configParams.push_back( new PARAM_CFG_INT(
+            true, AC_KEYS::ThreadPoolSize, &m_threadPoolSize, 0, 0 ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL(
+            true, AC_KEYS::IncrementalConnectivity, &m_incrementalConnectivity, false ) );
+
+    configParams.push_back( new PARAM_CFG_WXSTRING(
+            true, AC_KEYS::RouterEventLog, &m_routerEventLog, wxEmptyString ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL(
+            true, AC_KEYS::RouterParallelCandidates, &m_routerParallelCandidates, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL(
+            true, AC_KEYS::ParallelBoardLoad, &m_parallelBoardLoad, false ) );
+
     wxConfigLoadSetups( &aCfg, configParams );
 
     dumpCfg( configParams );
@@ -57,6 +57,7 @@ void DHEAD::DeleteAll()
     first = 0;
     last  = 0;
     count = 0;
+    ++changes;
 }
 
 
@@ -91,6 +92,7 @@ void DHEAD::append( EDA_ITEM* aNewElement )
     aNewElement->SetList( this );
 
     ++count;
+    ++changes;
 }
 
 
@@ -120,8 +122,10 @@ void DHEAD::append( DHEAD& aList )
         }
 
         count += aList.count;
+        ++changes;
 
         aList.count = 0;
+        ++aList.changes;
         aList.first = NULL;
         aList.last  = NULL;
     }
@@ -166,6 +170,7 @@ void DHEAD::insert( EDA_ITEM* aNewElement, EDA_ITEM* aAfterMe )
         aNewElement->SetList( this );
 
         ++count;
+        ++changes;
     }
 }
 
@@ -199,9 +204,25 @@ void DHEAD::remove( EDA_ITEM* aElement )
     aElement->SetList( 0 );
 
     --count;
+    ++changes;
     wxASSERT( ( first && last ) || count == 0 );
 }
 
+
+void DHEAD::BuildTable()
+{
+    if( tableChanges == changes )
+        return;
+
+    table.clear();
+    table.reserve( count );
+
+    for( EDA_ITEM* item = first;  item;  item = item->Next() )
+        table.push_back( item );
+
+    tableChanges = changes;
+}
+
 #if defined(DEBUG)
 
 void DHEAD::VerifyListIntegrity()
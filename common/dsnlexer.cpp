@@ -28,6 +28,7 @@
 #include <cstdio>
 #include <cstdlib>         // bsearch()
 #include <cctype>
+#include <cstring>         // strcmp()
 
 #include <macros.h>
 #include <fctsys.h>
@@ -53,23 +54,6 @@ void DSNLEXER::init()
     commentsAreTokens = false;
 
     curOffset = 0;
-
-#if 1
-    if( keywordCount > 11 )
-    {
-        // resize the hashtable bucket count
-        keyword_hash.reserve( keywordCount );
-    }
-
-    // fill the specialized "C string" hashtable from keywords[]
-    const KEYWORD*  it  = keywords;
-    const KEYWORD*  end = it + keywordCount;
-
-    for( ; it < end; ++it )
-    {
-        keyword_hash[it->name] = it->token;
-    }
-#endif
 }
 
 
@@ -81,7 +65,8 @@ DSNLEXER::DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
     limit( NULL ),
     reader( NULL ),
     keywords( aKeywordTable ),
-    keywordCount( aKeywordCount )
+    keywordCount( aKeywordCount ),
+    keywordLookup( NULL )
 {
     FILE_LINE_READER* fileReader = new FILE_LINE_READER( aFile, aFilename );
     PushReader( fileReader );
@@ -97,7 +82,8 @@ DSNLEXER::DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
     limit( NULL ),
     reader( NULL ),
     keywords( aKeywordTable ),
-    keywordCount( aKeywordCount )
+    keywordCount( aKeywordCount ),
+    keywordLookup( NULL )
 {
     STRING_LINE_READER* stringReader = new STRING_LINE_READER( aClipboardTxt, aSource.IsEmpty() ?
                                         wxString( FMT_CLIPBOARD ) : aSource );
@@ -114,7 +100,8 @@ DSNLEXER::DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
     limit( NULL ),
     reader( NULL ),
     keywords( aKeywordTable ),
-    keywordCount( aKeywordCount )
+    keywordCount( aKeywordCount ),
+    keywordLookup( NULL )
 {
     if( aLineReader )
         PushReader( aLineReader );
@@ -131,7 +118,8 @@ DSNLEXER::DSNLEXER( const std::string& aSExpression, const wxString& aSource ) :
     limit( NULL ),
     reader( NULL ),
     keywords( empty_keywords ),
-    keywordCount( 0 )
+    keywordCount( 0 ),
+    keywordLookup( NULL )
 {
     STRING_LINE_READER* stringReader = new STRING_LINE_READER( aSExpression, aSource.IsEmpty() ?
                                         wxString( FMT_CLIPBOARD ) : aSource );
@@ -230,7 +218,6 @@ LINE_READER* DSNLEXER::PopReader()
 }
 
 
-#if 0
 static int compare( const void* a1, const void* a2 )
 {
     const KEYWORD* k1 = (const KEYWORD*) a1;
@@ -242,6 +229,10 @@ static int compare( const void* a1, const void* a2 )
 
 int DSNLEXER::findToken( const std::string& tok )
 {
+    // The lexers generated by CMake know their keywords
+    if( keywordLookup )
+        return keywordLookup( tok.data(), tok.size() );
+
     KEYWORD search;
 
     search.name = tok.c_str();
@@ -255,18 +246,6 @@ int DSNLEXER::findToken( const std::string& tok )
         return DSN_SYMBOL;      // not a keyword, some arbitrary symbol.
 }
 
-#else
-
-inline int DSNLEXER::findToken( const std::string& tok )
-{
-    KEYWORD_MAP::const_iterator it = keyword_hash.find( tok.c_str() );
-    if( it != keyword_hash.end() )
-        return it->second;
-
-    return DSN_SYMBOL;      // not a keyword, some arbitrary symbol.
-}
-#endif
-
 
 const char* DSNLEXER::Syntax( int aTok )
 {
@@ -623,13 +602,25 @@ L_read:
         // a quoted string, will return DSN_STRING
         if( *cur == stringDelimiter )
         {
-            // copy the token, character by character so we can remove doubled up quotes.
-            curText.clear();
-
             ++cur;  // skip over the leading delimiter, which is always " in non-specctraMode
 
             head = cur;
 
+            // Fast path: most strings have no escape sequence, copy them at once.
+            while( head<limit && *head != '"' && *head != '\\' )
+                ++head;
+
+            curText.assign( cur, head );
+
+            if( head<limit && *head == '"' )
+            {
+                curTok = DSN_STRING;
+                ++head;                     // omit this trailing double quote
+                goto exit;
+            }
+
+            // copy the rest of the token character by character so we can decode the
+            // escape sequences.
             while( head<limit )
             {
                 // ESCAPE SEQUENCES:
@@ -655,7 +646,7 @@ L_read:
                     case 'v':   c = '\x0b';     break;
 
                     case 'x':   // 1 or 2 byte hex escape sequence
-                        for( i=0; i<2; ++i )
+                        for( i=0; i<2 && head+i<limit; ++i )
                         {
                             if( !isxdigit( head[i] ) )
                                 break;
@@ -671,7 +662,7 @@ L_read:
 
                     default:    // 1-3 byte octal escape sequence
                         --head;
-                        for( i=0; i<3; ++i )
+                        for( i=0; i<3 && head+i<limit; ++i )
                         {
                             if( head[i] < '0' || head[i] > '7' )
                                 break;
@@ -776,14 +767,14 @@ L_read:
         }
     }           // specctraMode
 
-    // non-quoted token, read it into curText.
-    curText.clear();
-
+    // non-quoted token, read it into curText at once.
     head = cur;
     while( head<limit && !isSep( *head ) )
-        curText += *head++;
+        ++head;
+
+    curText.assign( cur, head );
 
-    if( isNumber( curText.c_str(), curText.c_str() + curText.size() ) )
+    if( isNumber( cur, head ) )
     {
         curTok = DSN_NUMBER;
         goto exit;
@@ -296,24 +296,18 @@ bool TRIANGULATION::removeLeadingEdgeFromList( EDGE_PTR& aLeadingEdge )
     // Remove the edge from the list of leading edges,
     // but don't delete it.
     // Also set flag for leading edge to false.
-    // Must search from start of list. Since edges are added to the
-    // start of the list during triangulation, this operation will
-    // normally be fast (when used in the triangulation algorithm)
-    std::list<EDGE_PTR>::iterator it;
-    for( it = m_leadingEdges.begin(); it != m_leadingEdges.end(); ++it )
-    {
-        EDGE_PTR edge = *it;
+    // The edge knows its position in the list, so the removal of edges
+    // far from the start of the list (e.g. when nodes are inserted in or
+    // removed from an existing triangulation) does not search the list.
+    EDGE_PTR edge = aLeadingEdge;
 
-        if( edge == aLeadingEdge )
-        {
-            edge->SetAsLeadingEdge( false );
-            it = m_leadingEdges.erase( it );
+    if( !edge->IsLeadingEdge() )
+        return false;
 
-            return true;
-        }
-    }
+    edge->SetAsLeadingEdge( false );
+    m_leadingEdges.erase( edge->m_leadingEdgeIt );
 
-    return false;
+    return true;
 }
 
 
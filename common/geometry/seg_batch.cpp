@@ -0,0 +1,448 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <geometry/seg_batch.h>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define SEG_BATCH_SSE2
+
+#if defined( __AVX__ )
+#include <immintrin.h>
+#define SEG_BATCH_AVX
+#define SEG_BATCH_AVX_TARGET
+#elif defined( __GNUC__ )
+// The AVX code is compiled even when the compiler does not target AVX, and only used when
+// the CPU supports it
+#include <immintrin.h>
+#define SEG_BATCH_AVX
+#define SEG_BATCH_AVX_TARGET __attribute__( ( target( "avx" ) ) )
+#endif
+#endif
+
+
+// The approximate distances computed in double precision differ from the exact ones of
+// SEG::Distance() by less than this: the nearest point of SEG::NearestPoint() is truncated
+// to integer coordinates, which moves it by less than sqrt( 2 ), and the rounding errors of
+// the double precision are much smaller than 1.
+static const double approxDistanceMargin = 4.0;
+
+
+/**
+ * Returns a value close to the squared distance between aP and the segment aA-aB, see
+ * approxDistanceMargin.
+ */
+static inline double approxSquaredDistance( const VECTOR2I& aA, const VECTOR2I& aB,
+                                            const VECTOR2I& aP )
+{
+    double dx = (double) aB.x - aA.x;
+    double dy = (double) aB.y - aA.y;
+    double px = (double) aP.x - aA.x;
+    double py = (double) aP.y - aA.y;
+    double l2 = dx * dx + dy * dy;
+    double t = std::min( std::max( dx * px + dy * py, 0.0 ), l2 );
+    double u = t / std::max( l2, 1.0 );
+    double ex = px - dx * u;
+    double ey = py - dy * u;
+
+    return ex * ex + ey * ey;
+}
+
+
+#ifdef SEG_BATCH_SSE2
+
+static_assert( sizeof( VECTOR2I ) == 2 * sizeof( int ), "VECTOR2I must be two packed ints" );
+
+
+/**
+ * Loads the 4 points starting at aPoints, as their x and y coordinates.
+ */
+static inline void loadPoints( const VECTOR2I* aPoints, __m128i& aX, __m128i& aY )
+{
+    // x0 y0 x1 y1 and x2 y2 x3 y3, reordered to x0 x1 y0 y1 and x2 x3 y2 y3
+    __m128i p01 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( aPoints ) );
+    __m128i p23 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( aPoints + 2 ) );
+
+    p01 = _mm_shuffle_epi32( p01, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+    p23 = _mm_shuffle_epi32( p23, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+
+    aX = _mm_unpacklo_epi64( p01, p23 );
+    aY = _mm_unpackhi_epi64( p01, p23 );
+}
+
+
+/**
+ * Returns a mask of the 4 segments starting at aPoints whose bounding box overlaps the box
+ * [aMin, aMax].
+ */
+static inline unsigned int overlappingBoxes4( const VECTOR2I* aPoints, __m128i aMinX,
+                                              __m128i aMinY, __m128i aMaxX, __m128i aMaxY )
+{
+    __m128i ax, ay, bx, by;
+
+    loadPoints( aPoints, ax, ay );
+    loadPoints( aPoints + 1, bx, by );
+
+    // The boxes overlap when one of the ends is not below the minimum and one of the ends is
+    // not above the maximum, on both axes.  This needs no min/max instructions.
+    const __m128i ones = _mm_set1_epi32( -1 );
+
+    auto notBelow = [&]( __m128i aA, __m128i aB, __m128i aMin )
+    {
+        __m128i below = _mm_and_si128( _mm_cmplt_epi32( aA, aMin ), _mm_cmplt_epi32( aB, aMin ) );
+        return _mm_xor_si128( below, ones );
+    };
+
+    auto notAbove = [&]( __m128i aA, __m128i aB, __m128i aMax )
+    {
+        __m128i above = _mm_and_si128( _mm_cmpgt_epi32( aA, aMax ), _mm_cmpgt_epi32( aB, aMax ) );
+        return _mm_xor_si128( above, ones );
+    };
+
+    __m128i overlap = _mm_and_si128( notBelow( ax, bx, aMinX ), notAbove( ax, bx, aMaxX ) );
+    overlap = _mm_and_si128( overlap, notBelow( ay, by, aMinY ) );
+    overlap = _mm_and_si128( overlap, notAbove( ay, by, aMaxY ) );
+
+    return _mm_movemask_ps( _mm_castsi128_ps( overlap ) );
+}
+
+
+/**
+ * Returns a mask of the 4 values starting at aValues which are below aBound.
+ */
+static inline int belowMask4( const double* aValues, double aBound )
+{
+    const __m128d bound = _mm_set1_pd( aBound );
+
+    return _mm_movemask_pd( _mm_cmplt_pd( _mm_loadu_pd( aValues ), bound ) )
+           | _mm_movemask_pd( _mm_cmplt_pd( _mm_loadu_pd( aValues + 2 ), bound ) ) << 2;
+}
+
+
+/**
+ * Stores in aDist the approximate squared distances between aP and the aCount segments
+ * starting at aPoints, and returns the smallest one.
+ */
+static double approxSquaredDistancesSSE2( const VECTOR2I* aPoints, int aCount,
+                                          const VECTOR2I& aP, double* aDist )
+{
+    const __m128d px = _mm_set1_pd( aP.x );
+    const __m128d py = _mm_set1_pd( aP.y );
+    __m128d       nearest = _mm_set1_pd( std::numeric_limits<double>::max() );
+    int           i = 0;
+
+    // The blocks of 4 segments read the points i to i + 4, and are computed as 2 halves
+    for( ; i + 4 <= aCount; i += 4 )
+    {
+        __m128i iax, iay, ibx, iby;
+
+        loadPoints( aPoints + i, iax, iay );
+        loadPoints( aPoints + i + 1, ibx, iby );
+
+        for( int half = 0; half < 2; half++ )
+        {
+            __m128d ax = _mm_cvtepi32_pd( iax );
+            __m128d ay = _mm_cvtepi32_pd( iay );
+            __m128d dx = _mm_sub_pd( _mm_cvtepi32_pd( ibx ), ax );
+            __m128d dy = _mm_sub_pd( _mm_cvtepi32_pd( iby ), ay );
+            __m128d vx = _mm_sub_pd( px, ax );
+            __m128d vy = _mm_sub_pd( py, ay );
+
+            __m128d l2 = _mm_add_pd( _mm_mul_pd( dx, dx ), _mm_mul_pd( dy, dy ) );
+            __m128d t = _mm_add_pd( _mm_mul_pd( dx, vx ), _mm_mul_pd( dy, vy ) );
+            t = _mm_min_pd( _mm_max_pd( t, _mm_setzero_pd() ), l2 );
+
+            __m128d u = _mm_div_pd( t, _mm_max_pd( l2, _mm_set1_pd( 1.0 ) ) );
+            __m128d ex = _mm_sub_pd( vx, _mm_mul_pd( dx, u ) );
+            __m128d ey = _mm_sub_pd( vy, _mm_mul_pd( dy, u ) );
+            __m128d d2 = _mm_add_pd( _mm_mul_pd( ex, ex ), _mm_mul_pd( ey, ey ) );
+
+            _mm_storeu_pd( aDist + i + 2 * half, d2 );
+            nearest = _mm_min_pd( nearest, d2 );
+
+            iax = _mm_srli_si128( iax, 8 );
+            iay = _mm_srli_si128( iay, 8 );
+            ibx = _mm_srli_si128( ibx, 8 );
+            iby = _mm_srli_si128( iby, 8 );
+        }
+    }
+
+    double result = std::min( _mm_cvtsd_f64( nearest ),
+                              _mm_cvtsd_f64( _mm_unpackhi_pd( nearest, nearest ) ) );
+
+    for( ; i < aCount; i++ )
+    {
+        aDist[i] = approxSquaredDistance( aPoints[i], aPoints[i + 1], aP );
+        result = std::min( result, aDist[i] );
+    }
+
+    return result;
+}
+
+#endif
+
+
+#ifdef SEG_BATCH_AVX
+
+/**
+ * The AVX version of approxSquaredDistancesSSE2(), computing 4 segments at once.
+ */
+SEG_BATCH_AVX_TARGET
+static double approxSquaredDistancesAVX( const VECTOR2I* aPoints, int aCount,
+                                         const VECTOR2I& aP, double* aDist )
+{
+    const __m256d px = _mm256_set1_pd( aP.x );
+    const __m256d py = _mm256_set1_pd( aP.y );
+    __m256d       nearest = _mm256_set1_pd( std::numeric_limits<double>::max() );
+    int           i = 0;
+
+    // The blocks of 4 segments read the points i to i + 4
+    for( ; i + 4 <= aCount; i += 4 )
+    {
+        __m128i iax, iay, ibx, iby;
+
+        loadPoints( aPoints + i, iax, iay );
+        loadPoints( aPoints + i + 1, ibx, iby );
+
+        __m256d ax = _mm256_cvtepi32_pd( iax );
+        __m256d ay = _mm256_cvtepi32_pd( iay );
+        __m256d dx = _mm256_sub_pd( _mm256_cvtepi32_pd( ibx ), ax );
+        __m256d dy = _mm256_sub_pd( _mm256_cvtepi32_pd( iby ), ay );
+        __m256d vx = _mm256_sub_pd( px, ax );
+        __m256d vy = _mm256_sub_pd( py, ay );
+
+        __m256d l2 = _mm256_add_pd( _mm256_mul_pd( dx, dx ), _mm256_mul_pd( dy, dy ) );
+        __m256d t = _mm256_add_pd( _mm256_mul_pd( dx, vx ), _mm256_mul_pd( dy, vy ) );
+        t = _mm256_min_pd( _mm256_max_pd( t, _mm256_setzero_pd() ), l2 );
+
+        __m256d u = _mm256_div_pd( t, _mm256_max_pd( l2, _mm256_set1_pd( 1.0 ) ) );
+        __m256d ex = _mm256_sub_pd( vx, _mm256_mul_pd( dx, u ) );
+        __m256d ey = _mm256_sub_pd( vy, _mm256_mul_pd( dy, u ) );
+        __m256d d2 = _mm256_add_pd( _mm256_mul_pd( ex, ex ), _mm256_mul_pd( ey, ey ) );
+
+        _mm256_storeu_pd( aDist + i, d2 );
+        nearest = _mm256_min_pd( nearest, d2 );
+    }
+
+    __m128d m = _mm_min_pd( _mm256_castpd256_pd128( nearest ),
+                            _mm256_extractf128_pd( nearest, 1 ) );
+    double  result = std::min( _mm_cvtsd_f64( m ), _mm_cvtsd_f64( _mm_unpackhi_pd( m, m ) ) );
+
+    for( ; i < aCount; i++ )
+    {
+        aDist[i] = approxSquaredDistance( aPoints[i], aPoints[i + 1], aP );
+        result = std::min( result, aDist[i] );
+    }
+
+    return result;
+}
+
+
+static bool cpuSupportsAVX()
+{
+#ifdef __AVX__
+    return true;
+#else
+    static const bool supported = __builtin_cpu_supports( "avx" );
+
+    return supported;
+#endif
+}
+
+#endif
+
+
+namespace SEG_BATCH
+{
+
+SEG::ecoord SquaredDistance( const VECTOR2I* aPoints, int aPointCount, bool aClosed,
+                             const VECTOR2I& aP )
+{
+    SEG::ecoord best = VECTOR2I::ECOORD_MAX;
+
+    auto test = [&]( int aIndex )
+    {
+        const VECTOR2I& b = aIndex + 1 < aPointCount ? aPoints[aIndex + 1] : aPoints[0];
+
+        best = std::min( best, SEG( aPoints[aIndex], b ).SquaredDistance( aP ) );
+    };
+
+    const int openCount = aPointCount - 1;
+
+#ifdef SEG_BATCH_SSE2
+    auto approxSquaredDistances = approxSquaredDistancesSSE2;
+
+#ifdef SEG_BATCH_AVX
+    if( cpuSupportsAVX() )
+        approxSquaredDistances = approxSquaredDistancesAVX;
+#endif
+
+    // The nearest segment is less than 2 margins farther than the nearest approximate
+    // distance.  The approximate distances are computed for chunks of segments, and the
+    // exact distance is only computed for the segments less than 2 margins farther than the
+    // nearest approximate distance found so far.
+    const int chunkSize = 256;
+    double    dist[chunkSize];
+    double    nearest = std::numeric_limits<double>::max();
+
+    for( int chunk = 0; chunk < openCount; chunk += chunkSize )
+    {
+        int count = std::min( chunkSize, openCount - chunk );
+        int i = 0;
+
+        nearest = std::min( nearest, approxSquaredDistances( aPoints + chunk, count, aP, dist ) );
+
+        double bound = std::sqrt( nearest ) + 2 * approxDistanceMargin;
+        bound *= bound;
+
+        for( ; i + 4 <= count; i += 4 )
+        {
+            for( int mask = belowMask4( dist + i, bound ), j = 0; mask; j++, mask >>= 1 )
+            {
+                if( mask & 1 )
+                    test( chunk + i + j );
+            }
+        }
+
+        for( ; i < count; i++ )
+        {
+            if( dist[i] < bound )
+                test( chunk + i );
+        }
+    }
+#else
+    for( int i = 0; i < openCount; i++ )
+        test( i );
+#endif
+
+    if( aClosed && aPointCount > 0 )
+        test( openCount );
+
+    return best;
+}
+
+
+unsigned int OverlappingBoxes( const VECTOR2I* aPoints, int aIndex, int aCount,
+                               const VECTOR2I& aMin, const VECTOR2I& aMax )
+{
+    const VECTOR2I* pts = aPoints + aIndex;
+    unsigned int    mask = 0;
+    int             i = 0;
+
+#ifdef SEG_BATCH_SSE2
+    const __m128i minX = _mm_set1_epi32( aMin.x );
+    const __m128i minY = _mm_set1_epi32( aMin.y );
+    const __m128i maxX = _mm_set1_epi32( aMax.x );
+    const __m128i maxY = _mm_set1_epi32( aMax.y );
+
+    // The blocks of 4 segments read the points i to i + 4
+    for( ; i + 4 <= aCount; i += 4 )
+        mask |= overlappingBoxes4( pts + i, minX, minY, maxX, maxY ) << i;
+#endif
+
+    for( ; i < aCount; i++ )
+    {
+        const VECTOR2I& a = pts[i];
+        const VECTOR2I& b = pts[i + 1];
+
+        if( std::max( a.x, b.x ) >= aMin.x && std::min( a.x, b.x ) <= aMax.x
+                && std::max( a.y, b.y ) >= aMin.y && std::min( a.y, b.y ) <= aMax.y )
+            mask |= 1u << i;
+    }
+
+    return mask;
+}
+
+
+int Distance( const VECTOR2I* aPoints, int aPointCount, bool aClosed, const SEG& aSeg,
+              int aMaxDistance )
+{
+    int      best = aMaxDistance;
+    VECTOR2I bmin, bmax;
+
+    // The box of aSeg grown by the best distance, saturated to the coordinate range.  A
+    // segment whose box does not touch it is farther than the best distance.
+    auto growBox = [&]()
+    {
+        auto grow = []( int aValue, int aDelta )
+        {
+            int64_t v = (int64_t) aValue + aDelta;
+            return (int) std::max<int64_t>( INT_MIN, std::min<int64_t>( INT_MAX, v ) );
+        };
+
+        bmin = VECTOR2I( grow( std::min( aSeg.A.x, aSeg.B.x ), -best ),
+                         grow( std::min( aSeg.A.y, aSeg.B.y ), -best ) );
+        bmax = VECTOR2I( grow( std::max( aSeg.A.x, aSeg.B.x ), best ),
+                         grow( std::max( aSeg.A.y, aSeg.B.y ), best ) );
+    };
+
+    auto test = [&]( const SEG& aEdge )
+    {
+        int d = aEdge.Distance( aSeg );
+
+        if( d < best )
+        {
+            best = d;
+            growBox();
+        }
+    };
+
+    growBox();
+
+    const int openCount = aPointCount - 1;
+
+    for( int i = 0; i < openCount && best > 0; i += 8 )
+    {
+        int          count = std::min( 8, openCount - i );
+        unsigned int mask = OverlappingBoxes( aPoints, i, count, bmin, bmax );
+
+        for( int j = 0; mask; j++, mask >>= 1 )
+        {
+            if( mask & 1 )
+                test( SEG( aPoints[i + j], aPoints[i + j + 1] ) );
+        }
+    }
+
+    if( aClosed && aPointCount > 0 && best > 0 )
+        test( SEG( aPoints[openCount], aPoints[0] ) );
+
+    return best;
+}
+
+
+const char* InstructionSet()
+{
+#if defined( SEG_BATCH_AVX )
+    return cpuSupportsAVX() ? "AVX" : "SSE2";
+#elif defined( SEG_BATCH_SSE2 )
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+}
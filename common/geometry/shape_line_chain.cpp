@@ -26,6 +26,7 @@
 
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_circle.h>
+#include <geometry/seg_batch.h>
 #include <trigo.h>
 #include "clipper.hpp"
 
@@ -71,21 +72,18 @@ bool SHAPE_LINE_CHAIN::Collide( const SEG& aSeg, int aClearance ) const
     BOX2I box_a( aSeg.A, aSeg.B - aSeg.A );
     BOX2I::ecoord_type dist_sq = (BOX2I::ecoord_type) aClearance * aClearance;
 
-    for( int i = 0; i < SegmentCount(); i++ )
+    // The segments far from aSeg are rejected in batches, the others are tested here
+    auto collide = [&]( const SEG& s )
     {
-        const SEG& s = CSegment( i );
         BOX2I box_b( s.A, s.B - s.A );
 
         BOX2I::ecoord_type d = box_a.SquaredDistance( box_b );
 
-        if( d < dist_sq )
-        {
-            if( s.Collide( aSeg, aClearance ) )
-                return true;
-        }
-    }
+        return d < dist_sq && s.Collide( aSeg, aClearance );
+    };
 
-    return false;
+    return SEG_BATCH::FindCollision( m_points.data(), PointCount(), m_closed, aSeg, aClearance,
+                                     collide ) >= 0;
 }
 
 
@@ -161,8 +159,8 @@ int SHAPE_LINE_CHAIN::Distance( const VECTOR2I& aP, bool aOutlineOnly ) const
     if( IsClosed() && PointInside( aP ) && !aOutlineOnly )
         return 0;
 
-    for( int s = 0; s < SegmentCount(); s++ )
-        d = std::min( d, CSegment( s ).Distance( aP ) );
+    if( SegmentCount() > 0 )
+        d = sqrt( SEG_BATCH::SquaredDistance( m_points.data(), PointCount(), m_closed, aP ) );
 
     return d;
 }
@@ -39,12 +39,14 @@
 #include <map>
 
 #include <make_unique.h>
+#include <math/math_util.h>
 
 #include <geometry/geometry_utils.h>
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_poly_set.h>
 #include <geometry/polygon_triangulation.h>
+#include <geometry/seg_batch.h>
 
 using namespace ClipperLib;
 
@@ -57,15 +59,21 @@ SHAPE_POLY_SET::SHAPE_POLY_SET() :
 SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther, bool aDeepCopy ) :
     SHAPE( SH_POLY_SET ), m_polys( aOther.m_polys )
 {
-    if( aOther.IsTriangulationUpToDate() )
+    // The copy has the same contours, so it can share the point-in-polygon index
     {
-        for( unsigned i = 0; i < aOther.TriangulatedPolyCount(); i++ )
-            m_triangulatedPolys.push_back(
-                    std::make_unique<TRIANGULATED_POLYGON>( *aOther.TriangulatedPolygon( i ) ) );
-
-        m_hash = aOther.GetHash();
-        m_triangulationValid = true;
+        std::lock_guard<std::mutex> lock( aOther.m_containsIndexLock );
+        m_containsIndexOwner = aOther.m_containsIndexOwner;
+        m_containsIndex = m_containsIndexOwner.get();
     }
+
+    // The triangulation is copied with the hash it was made for, so the copy knows as well
+    // as aOther whether it is up to date.  This is only checked when it is used.
+    for( unsigned i = 0; i < aOther.TriangulatedPolyCount(); i++ )
+        m_triangulatedPolys.push_back(
+                std::make_unique<TRIANGULATED_POLYGON>( *aOther.TriangulatedPolygon( i ) ) );
+
+    m_hash = aOther.m_hash;
+    m_triangulationValid = aOther.m_triangulationValid;
 }
 
 
@@ -121,7 +129,7 @@ bool SHAPE_POLY_SET::GetRelativeIndices( int aGlobalIdx,
 
 
 bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndices,
-        int& aGlobalIdx )
+        int& aGlobalIdx ) const
 {
     int selectedVertex = aRelativeIndices.m_vertex;
     unsigned int    selectedContour = aRelativeIndices.m_contour;
@@ -165,6 +173,8 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
 
 int SHAPE_POLY_SET::NewOutline()
 {
+    invalidateContainsIndex();
+
     SHAPE_LINE_CHAIN empty_path;
     POLYGON poly;
 
@@ -177,6 +187,8 @@ int SHAPE_POLY_SET::NewOutline()
 
 int SHAPE_POLY_SET::NewHole( int aOutline )
 {
+    invalidateContainsIndex();
+
     SHAPE_LINE_CHAIN empty_path;
 
     empty_path.SetClosed( true );
@@ -194,6 +206,8 @@ int SHAPE_POLY_SET::NewHole( int aOutline )
 
 int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDuplication )
 {
+    invalidateContainsIndex();
+
     if( aOutline < 0 )
         aOutline += m_polys.size();
 
@@ -215,6 +229,8 @@ int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDu
 
 void SHAPE_POLY_SET::InsertVertex( int aGlobalIndex, VECTOR2I aNewVertex )
 {
+    invalidateContainsIndex();
+
     VERTEX_INDEX index;
 
     if( aGlobalIndex < 0 )
@@ -260,7 +276,7 @@ int SHAPE_POLY_SET::VertexCount( int aOutline, int aHole  ) const
 }
 
 
-SHAPE_POLY_SET SHAPE_POLY_SET::Subset( int aFirstPolygon, int aLastPolygon )
+SHAPE_POLY_SET SHAPE_POLY_SET::Subset( int aFirstPolygon, int aLastPolygon ) const
 {
     assert( aFirstPolygon >= 0 && aLastPolygon <= OutlineCount() );
 
@@ -268,7 +284,7 @@ SHAPE_POLY_SET SHAPE_POLY_SET::Subset( int aFirstPolygon, int aLastPolygon )
 
     for( int index = aFirstPolygon; index < aLastPolygon; index++ )
     {
-        newPolySet.m_polys.push_back( Polygon( index ) );
+        newPolySet.m_polys.push_back( CPolygon( index ) );
     }
 
     return newPolySet;
@@ -277,6 +293,8 @@ SHAPE_POLY_SET SHAPE_POLY_SET::Subset( int aFirstPolygon, int aLastPolygon )
 
 VECTOR2I& SHAPE_POLY_SET::Vertex( int aIndex, int aOutline, int aHole )
 {
+    invalidateContainsIndex();
+
     if( aOutline < 0 )
         aOutline += m_polys.size();
 
@@ -315,6 +333,8 @@ const VECTOR2I& SHAPE_POLY_SET::CVertex( int aIndex, int aOutline, int aHole ) c
 
 VECTOR2I& SHAPE_POLY_SET::Vertex( int aGlobalIndex )
 {
+    invalidateContainsIndex();
+
     SHAPE_POLY_SET::VERTEX_INDEX index;
 
     // Assure the passed index references a legal position; abort otherwise
@@ -437,6 +457,8 @@ bool SHAPE_POLY_SET::IsSelfIntersecting()
 
 int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 {
+    invalidateContainsIndex();
+
     assert( aOutline.IsClosed() );
 
     POLYGON poly;
@@ -451,6 +473,8 @@ int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 
 int SHAPE_POLY_SET::AddHole( const SHAPE_LINE_CHAIN& aHole, int aOutline )
 {
+    invalidateContainsIndex();
+
     assert( m_polys.size() );
 
     if( aOutline < 0 )
@@ -605,6 +629,8 @@ void SHAPE_POLY_SET::Inflate( int aFactor, int aCircleSegmentsCount, bool aPrese
 
 void SHAPE_POLY_SET::importTree( PolyTree* tree )
 {
+    invalidateContainsIndex();
+
     m_polys.clear();
 
     for( PolyNode* n = tree->GetFirst(); n; n = n->GetNext() )
@@ -843,6 +869,8 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 
 void SHAPE_POLY_SET::Fracture( POLYGON_MODE aFastMode )
 {
+    invalidateContainsIndex();
+
     Simplify( aFastMode );    // remove overlapping holes/degeneracy
 
     for( POLYGON& paths : m_polys )
@@ -1030,6 +1058,8 @@ bool SHAPE_POLY_SET::HasHoles() const
 
 void SHAPE_POLY_SET::Unfracture( POLYGON_MODE aFastMode )
 {
+    invalidateContainsIndex();
+
     for( POLYGON& path : m_polys )
     {
         unfractureSingle( path );
@@ -1049,6 +1079,8 @@ void SHAPE_POLY_SET::Simplify( POLYGON_MODE aFastMode )
 
 int SHAPE_POLY_SET::NormalizeAreaOutlines()
 {
+    invalidateContainsIndex();
+
     // We are expecting only one main outline, but this main outline can have holes
     // if holes: combine holes and remove them from the main outline.
     // Note also we are using SHAPE_POLY_SET::PM_STRICTLY_SIMPLE in polygon
@@ -1107,6 +1139,8 @@ const std::string SHAPE_POLY_SET::Format() const
 
 bool SHAPE_POLY_SET::Parse( std::stringstream& aStream )
 {
+    invalidateContainsIndex();
+
     std::string tmp;
 
     aStream >> tmp;
@@ -1200,16 +1234,19 @@ bool SHAPE_POLY_SET::PointOnEdge( const VECTOR2I& aP ) const
 
 bool SHAPE_POLY_SET::Collide( const SEG& aSeg, int aClearance ) const
 {
-
-    SHAPE_POLY_SET polySet = SHAPE_POLY_SET( *this );
+    std::unique_ptr<SHAPE_POLY_SET> inflated;
 
     // Inflate the polygon if necessary.
     if( aClearance > 0 )
     {
+        inflated = std::make_unique<SHAPE_POLY_SET>( *this );
+
         // fixme: the number of arc segments should not be hardcoded
-        polySet.Inflate( aClearance, 8 );
+        inflated->Inflate( aClearance, 8 );
     }
 
+    const SHAPE_POLY_SET& polySet = inflated ? *inflated : *this;
+
     // We are going to check to see if the segment crosses an external
     // boundary.  However, if the full segment is inside the polyset, this
     // will not be true.  So we first test to see if one of the points is
@@ -1217,12 +1254,20 @@ bool SHAPE_POLY_SET::Collide( const SEG& aSeg, int aClearance ) const
     if( polySet.Contains( aSeg.A ) )
         return true;
 
-    for( SEGMENT_ITERATOR iterator = polySet.IterateSegmentsWithHoles(); iterator; iterator++ )
+    for( const POLYGON& poly : polySet.m_polys )
     {
-        SEG polygonEdge = *iterator;
+        for( const SHAPE_LINE_CHAIN& contour : poly )
+        {
+            // Only the edges whose bounding box touches the one of aSeg can intersect it
+            auto intersect = [&]( const SEG& aEdge )
+            {
+                return bool( aEdge.Intersect( aSeg, true ) );
+            };
 
-        if( polygonEdge.Intersect( aSeg, true ) )
-            return true;
+            if( SEG_BATCH::FindCollision( contour.CPoints().data(), contour.PointCount(),
+                                          contour.IsClosed(), aSeg, 0, intersect ) >= 0 )
+                return true;
+        }
     }
 
     return false;
@@ -1231,6 +1276,10 @@ bool SHAPE_POLY_SET::Collide( const SEG& aSeg, int aClearance ) const
 
 bool SHAPE_POLY_SET::Collide( const VECTOR2I& aP, int aClearance ) const
 {
+    // No need to copy the set (and lose its point-in-polygon index) if it is not inflated
+    if( aClearance <= 0 )
+        return Contains( aP );
+
     SHAPE_POLY_SET polySet = SHAPE_POLY_SET( *this );
 
     // Inflate the polygon if necessary.
@@ -1247,12 +1296,16 @@ bool SHAPE_POLY_SET::Collide( const VECTOR2I& aP, int aClearance ) const
 
 void SHAPE_POLY_SET::RemoveAllContours()
 {
+    invalidateContainsIndex();
+
     m_polys.clear();
 }
 
 
 void SHAPE_POLY_SET::RemoveContour( int aContourIdx, int aPolygonIdx )
 {
+    invalidateContainsIndex();
+
     // Default polygon is the last one
     if( aPolygonIdx < 0 )
         aPolygonIdx += m_polys.size();
@@ -1263,6 +1316,8 @@ void SHAPE_POLY_SET::RemoveContour( int aContourIdx, int aPolygonIdx )
 
 int SHAPE_POLY_SET::RemoveNullSegments()
 {
+    invalidateContainsIndex();
+
     int removed = 0;
 
     ITERATOR iterator = IterateWithHoles();
@@ -1316,12 +1371,16 @@ int SHAPE_POLY_SET::RemoveNullSegments()
 
 void SHAPE_POLY_SET::DeletePolygon( int aIdx )
 {
+    invalidateContainsIndex();
+
     m_polys.erase( m_polys.begin() + aIdx );
 }
 
 
 void SHAPE_POLY_SET::Append( const SHAPE_POLY_SET& aSet )
 {
+    invalidateContainsIndex();
+
     m_polys.insert( m_polys.end(), aSet.m_polys.begin(), aSet.m_polys.end() );
 }
 
@@ -1345,7 +1404,7 @@ bool SHAPE_POLY_SET::CollideVertex( const VECTOR2I& aPoint,
     // Convert clearance to double for precission when comparing distances
     clearance = aClearance;
 
-    for( ITERATOR iterator = IterateWithHoles(); iterator; iterator++ )
+    for( CONST_ITERATOR iterator = CIterateWithHoles(); iterator; iterator++ )
     {
         // Get the difference vector between current vertex and aPoint
         delta = *iterator - aPoint;
@@ -1400,19 +1459,208 @@ bool SHAPE_POLY_SET::CollideEdge( const VECTOR2I& aPoint,
 }
 
 
+// Contours with fewer points are tested by walking all their edges
+static const int containsIndexMinPoints = 32;
+
+// Number of Contains() queries after which the index of a set is built
+static const int containsIndexMinQueries = 8;
+
+
+/**
+ * Class CONTOUR_SLABS
+ *
+ * Splits the bounding box of a closed contour into horizontal slabs, each one listing the
+ * edges which cross it or pass near it, so only the edges of the slab of a point need to
+ * be tested.  The tests are the ones of SHAPE_LINE_CHAIN::PointInside() and PointOnEdge(),
+ * so the results are the same as the ones of the contour.
+ */
+class CONTOUR_SLABS
+{
+public:
+    CONTOUR_SLABS( const SHAPE_LINE_CHAIN& aContour ) :
+        m_bbox( aContour.BBox() )
+    {
+        const std::vector<VECTOR2I>& pts = aContour.CPoints();
+        const int n = pts.size();
+
+        int64_t sumDy = 0;
+
+        for( int i = 0; i < n; i++ )
+            sumDy += std::abs( (int64_t) pts[ next( i, n ) ].y - pts[i].y ) + 2 * margin;
+
+        // About one slab per 4 edges, but no more than needed to store each edge ~8 times
+        m_y0 = m_bbox.GetY();
+        m_height = (int64_t) m_bbox.GetHeight() + 1;
+
+        int64_t count = std::max( n / 4, 1 );
+        count = std::min( count, 7 * n * m_height / std::max<int64_t>( sumDy, 1 ) + 1 );
+        count = std::min( count, m_height );
+        m_slabCount = std::max<int>( count, 1 );
+
+        // Edge lists of the slabs, stored one after the other
+        m_start.assign( m_slabCount + 1, 0 );
+
+        for( int i = 0; i < n; i++ )
+        {
+            for( int s = firstSlab( pts, i ); s <= lastSlab( pts, i ); s++ )
+                m_start[s + 1]++;
+        }
+
+        for( int s = 0; s < m_slabCount; s++ )
+            m_start[s + 1] += m_start[s];
+
+        std::vector<int> fill( m_start.begin(), m_start.end() - 1 );
+        m_edges.resize( m_start.back() );
+
+        for( int i = 0; i < n; i++ )
+        {
+            for( int s = firstSlab( pts, i ); s <= lastSlab( pts, i ); s++ )
+                m_edges[ fill[s]++ ] = i;
+        }
+    }
+
+    ///> Same as aContour.PointInside( aP ), aContour being the contour the slabs were built for
+    bool PointInside( const SHAPE_LINE_CHAIN& aContour, const VECTOR2I& aP ) const
+    {
+        if( !m_bbox.Contains( aP ) )
+            return false;
+
+        const std::vector<VECTOR2I>& pts = aContour.CPoints();
+        const int n = pts.size();
+        const int s = slab( aP.y );
+
+        bool inside = false;
+
+        for( int k = m_start[s]; k < m_start[s + 1]; k++ )
+        {
+            const int i = m_edges[k];
+            const VECTOR2I& p1 = pts[i];
+            const VECTOR2I& p2 = pts[ next( i, n ) ];
+            const VECTOR2I diff = p2 - p1;
+
+            if( p1 == aP || p2 == aP || SEG( p1, p2 ).Distance( aP ) <= 1 )
+                return false;   // on the edge
+
+            if( diff.y != 0 )
+            {
+                const int d = rescale( diff.x, ( aP.y - p1.y ), diff.y );
+
+                if( ( ( p1.y > aP.y ) != ( p2.y > aP.y ) ) && ( aP.x - p1.x < d ) )
+                    inside = !inside;
+            }
+        }
+
+        return inside;
+    }
+
+private:
+    // Distance at which SHAPE_LINE_CHAIN::PointOnEdge() still finds an edge, with some slack
+    static const int margin = 3;
+
+    static int next( int aIdx, int aCount )
+    {
+        return aIdx + 1 < aCount ? aIdx + 1 : 0;
+    }
+
+    int slab( int64_t aY ) const
+    {
+        int64_t s = ( aY - m_y0 ) * m_slabCount / m_height;
+        return std::max<int64_t>( 0, std::min<int64_t>( s, m_slabCount - 1 ) );
+    }
+
+    ///> Slab range of the aEdge-th edge, widened by the margin
+    int firstSlab( const std::vector<VECTOR2I>& aPts, int aEdge ) const
+    {
+        const int n = aPts.size();
+        return slab( (int64_t) std::min( aPts[aEdge].y, aPts[ next( aEdge, n ) ].y ) - margin );
+    }
+
+    int lastSlab( const std::vector<VECTOR2I>& aPts, int aEdge ) const
+    {
+        const int n = aPts.size();
+        return slab( (int64_t) std::max( aPts[aEdge].y, aPts[ next( aEdge, n ) ].y ) + margin );
+    }
+
+    BOX2I            m_bbox;
+    int64_t          m_y0;
+    int64_t          m_height;
+    int              m_slabCount;
+    std::vector<int> m_start;
+    std::vector<int> m_edges;
+};
+
+
+class SHAPE_POLY_SET::CONTAINS_INDEX
+{
+public:
+    CONTAINS_INDEX( const SHAPE_POLY_SET& aSet )
+    {
+        for( const POLYGON& poly : aSet.m_polys )
+        {
+            m_slabs.emplace_back();
+
+            for( const SHAPE_LINE_CHAIN& contour : poly )
+            {
+                if( contour.IsClosed() && contour.PointCount() >= containsIndexMinPoints )
+                    m_slabs.back().push_back( std::make_unique<CONTOUR_SLABS>( contour ) );
+                else
+                    m_slabs.back().emplace_back();
+            }
+        }
+    }
+
+    ///> Same as aContour.PointInside( aP ), aContour being the aContourIdx-th one of aPolyIdx
+    bool PointInside( const SHAPE_LINE_CHAIN& aContour, int aPolyIdx, int aContourIdx,
+                      const VECTOR2I& aP ) const
+    {
+        const auto& slabs = m_slabs[aPolyIdx][aContourIdx];
+
+        return slabs ? slabs->PointInside( aContour, aP ) : aContour.PointInside( aP );
+    }
+
+private:
+    std::vector<std::vector<std::unique_ptr<CONTOUR_SLABS>>> m_slabs;
+};
+
+
+const SHAPE_POLY_SET::CONTAINS_INDEX* SHAPE_POLY_SET::containsIndex() const
+{
+    const CONTAINS_INDEX* index = m_containsIndex.load( std::memory_order_acquire );
+
+    if( index )
+        return index;
+
+    // A set queried only a few times between modifications is not worth indexing
+    if( ++m_containsQueries < containsIndexMinQueries )
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock( m_containsIndexLock );
+
+    if( !m_containsIndexOwner )
+    {
+        m_containsIndexOwner = std::make_shared<const CONTAINS_INDEX>( *this );
+        m_containsIndex.store( m_containsIndexOwner.get(), std::memory_order_release );
+    }
+
+    return m_containsIndexOwner.get();
+}
+
+
 bool SHAPE_POLY_SET::Contains( const VECTOR2I& aP, int aSubpolyIndex, bool aIgnoreHoles ) const
 {
     if( m_polys.size() == 0 ) // empty set?
         return false;
 
+    const CONTAINS_INDEX* index = containsIndex();
+
     // If there is a polygon specified, check the condition against that polygon
     if( aSubpolyIndex >= 0 )
-        return containsSingle( aP, aSubpolyIndex, aIgnoreHoles );
+        return containsSingle( aP, aSubpolyIndex, aIgnoreHoles, index );
 
     // In any other case, check it against all polygons in the set
     for( int polygonIdx = 0; polygonIdx < OutlineCount(); polygonIdx++ )
     {
-        if( containsSingle( aP, polygonIdx, aIgnoreHoles ) )
+        if( containsSingle( aP, polygonIdx, aIgnoreHoles, index ) )
             return true;
     }
 
@@ -1434,25 +1682,36 @@ void SHAPE_POLY_SET::RemoveVertex( int aGlobalIndex )
 
 void SHAPE_POLY_SET::RemoveVertex( VERTEX_INDEX aIndex )
 {
+    invalidateContainsIndex();
+
     m_polys[aIndex.m_polygon][aIndex.m_contour].Remove( aIndex.m_vertex );
 }
 
 
-bool SHAPE_POLY_SET::containsSingle( const VECTOR2I& aP, int aSubpolyIndex, bool aIgnoreHoles ) const
+bool SHAPE_POLY_SET::containsSingle( const VECTOR2I& aP, int aSubpolyIndex, bool aIgnoreHoles,
+                                     const CONTAINS_INDEX* aIndex ) const
 {
+    const POLYGON& poly = m_polys[aSubpolyIndex];
+
+    auto inside = [&]( int aContourIdx )
+    {
+        if( aIndex )
+            return aIndex->PointInside( poly[aContourIdx], aSubpolyIndex, aContourIdx, aP );
+
+        return pointInPolygon( aP, poly[aContourIdx] );
+    };
+
     // Check that the point is inside the outline
-    if( pointInPolygon( aP, m_polys[aSubpolyIndex][0] ) )
+    if( inside( 0 ) )
     {
         if( !aIgnoreHoles )
         {
             // Check that the point is not in any of the holes
             for( int holeIdx = 0; holeIdx < HoleCount( aSubpolyIndex ); holeIdx++ )
             {
-                const SHAPE_LINE_CHAIN hole = CHole( aSubpolyIndex, holeIdx );
-
-                // If the point is inside a hole (and not on its edge),
-                // it is outside of the polygon
-                if( pointInPolygon( aP, hole ) && !hole.PointOnEdge( aP ) )
+                // If the point is inside a hole (and not on its edge, which PointInside()
+                // already checks), it is outside of the polygon
+                if( inside( holeIdx + 1 ) )
                     return false;
             }
         }
@@ -1472,6 +1731,8 @@ bool SHAPE_POLY_SET::pointInPolygon( const VECTOR2I& aP, const SHAPE_LINE_CHAIN&
 
 void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
 {
+    invalidateContainsIndex();
+
     for( POLYGON& poly : m_polys )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
@@ -1484,6 +1745,8 @@ void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
 
 void SHAPE_POLY_SET::Rotate( double aAngle, const VECTOR2I& aCenter )
 {
+    invalidateContainsIndex();
+
     for( POLYGON& poly : m_polys )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
@@ -1533,22 +1796,21 @@ int SHAPE_POLY_SET::DistanceToPolygon( VECTOR2I aPoint, int aPolygonIndex )
     if( containsSingle( aPoint, aPolygonIndex ) )
         return 0;
 
-    SEGMENT_ITERATOR iterator = IterateSegmentsWithHoles( aPolygonIndex );
+    SEG::ecoord minDistance = VECTOR2I::ECOORD_MAX;
 
-    SEG polygonEdge = *iterator;
-    int minDistance = polygonEdge.Distance( aPoint );
-
-    for( iterator++; iterator && minDistance > 0; iterator++ )
+    // The edges of each contour are tested in batches
+    for( const SHAPE_LINE_CHAIN& contour : m_polys[aPolygonIndex] )
     {
-        polygonEdge = *iterator;
+        SEG::ecoord currentDistance = SEG_BATCH::SquaredDistance( contour.CPoints().data(),
+                contour.PointCount(), contour.IsClosed(), aPoint );
 
-        int currentDistance = polygonEdge.Distance( aPoint );
+        minDistance = std::min( minDistance, currentDistance );
 
-        if( currentDistance < minDistance )
-            minDistance = currentDistance;
+        if( minDistance == 0 )
+            break;
     }
 
-    return minDistance;
+    return sqrt( minDistance );
 }
 
 
@@ -1561,19 +1823,17 @@ int SHAPE_POLY_SET::DistanceToPolygon( SEG aSegment, int aPolygonIndex, int aSeg
     if( containsSingle( aSegment.A, aPolygonIndex ) )
         return 0;
 
-    SEGMENT_ITERATOR iterator = IterateSegmentsWithHoles( aPolygonIndex );
-
-    SEG polygonEdge = *iterator;
-    int minDistance = polygonEdge.Distance( aSegment );
+    int minDistance = std::numeric_limits<int>::max();
 
-    for( iterator++; iterator && minDistance > 0; iterator++ )
+    // The edges of each contour are tested in batches, the ones farther than the nearest
+    // edge found so far being skipped
+    for( const SHAPE_LINE_CHAIN& contour : m_polys[aPolygonIndex] )
     {
-        polygonEdge = *iterator;
+        minDistance = SEG_BATCH::Distance( contour.CPoints().data(), contour.PointCount(),
+                                           contour.IsClosed(), aSegment, minDistance );
 
-        int currentDistance = polygonEdge.Distance( aSegment );
-
-        if( currentDistance < minDistance )
-            minDistance = currentDistance;
+        if( minDistance == 0 )
+            break;
     }
 
     // Take into account the width of the segment
@@ -1822,12 +2082,31 @@ SHAPE_POLY_SET::POLYGON SHAPE_POLY_SET::chamferFilletPolygon( CORNER_MODE aMode,
 SHAPE_POLY_SET &SHAPE_POLY_SET::operator=( const SHAPE_POLY_SET& aOther )
 {
     static_cast<SHAPE&>(*this) = aOther;
-    m_polys = aOther.m_polys;
 
-    // reset poly cache:
-    m_hash = MD5_HASH{};
-    m_triangulationValid = false;
-    m_triangulatedPolys.clear();
+    if( &aOther != this )
+    {
+        invalidateContainsIndex();
+        m_polys = aOther.m_polys;
+
+        // Share the point-in-polygon index, like the copy constructor does
+        std::lock_guard<std::mutex> lock( aOther.m_containsIndexLock );
+        m_containsIndexOwner = aOther.m_containsIndexOwner;
+        m_containsIndex = m_containsIndexOwner.get();
+    }
+
+    // Copy the triangulation with its hash, like the copy constructor does
+    if( &aOther != this )
+    {
+        m_triangulatedPolys.clear();
+
+        for( unsigned i = 0; i < aOther.TriangulatedPolyCount(); i++ )
+            m_triangulatedPolys.push_back(
+                    std::make_unique<TRIANGULATED_POLYGON>( *aOther.TriangulatedPolygon( i ) ) );
+
+        m_hash = aOther.m_hash;
+        m_triangulationValid = aOther.m_triangulationValid;
+    }
+
     return *this;
 }
 
@@ -1876,12 +2155,14 @@ void SHAPE_POLY_SET::CacheTriangulation()
     if( !recalculate )
         return;
 
+    // The outdated triangulation is dropped first, so it is not copied to tmpSet
+    m_triangulatedPolys.clear();
+
     SHAPE_POLY_SET tmpSet = *this;
 
     if( tmpSet.HasHoles() )
         tmpSet.Fracture( PM_FAST );
 
-    m_triangulatedPolys.clear();
     m_triangulationValid = true;
 
     while( tmpSet.OutlineCount() > 0 )
@@ -28,6 +28,16 @@
 
 #include <richio.h>
 
+#if defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN 1
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 // Fall back to getc() when getc_unlocked() is not available on the target platform.
 #if !defined( HAVE_FGETC_NOLOCK )
@@ -225,6 +235,145 @@ char* FILE_LINE_READER::ReadLine()
 }
 
 
+MAPPED_FILE_LINE_READER::MAPPED_FILE_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber, unsigned aMaxLineLength ) :
+    LINE_READER( aMaxLineLength ), m_data( NULL ), m_size( 0 ), m_ndx( 0 )
+{
+    bool mapped = false;
+
+#if defined( _WIN32 )
+    HANDLE file = CreateFileW( aFileName.wc_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+
+    if( file != INVALID_HANDLE_VALUE )
+    {
+        LARGE_INTEGER size;
+
+        if( GetFileSizeEx( file, &size ) )
+        {
+            m_size = (size_t) size.QuadPart;
+            mapped = m_size == 0;
+        }
+
+        if( m_size )
+        {
+            // The view keeps the mapping alive, so both handles can be closed once it exists.
+            HANDLE mapping = CreateFileMappingW( file, NULL, PAGE_READONLY, 0, 0, NULL );
+
+            if( mapping )
+            {
+                m_data = (const char*) MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+                mapped = m_data != NULL;
+                CloseHandle( mapping );
+            }
+        }
+
+        CloseHandle( file );
+    }
+#else
+    int fd = open( aFileName.fn_str(), O_RDONLY );
+
+    if( fd >= 0 )
+    {
+        struct stat fileStat;
+
+        if( fstat( fd, &fileStat ) == 0 )
+        {
+            m_size = (size_t) fileStat.st_size;
+            mapped = m_size == 0;   // mmap() fails on empty files, which have no lines anyway
+        }
+
+        if( m_size )
+        {
+            void* data = mmap( NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+            if( data != MAP_FAILED )
+            {
+                madvise( data, m_size, MADV_SEQUENTIAL );
+                m_data = (const char*) data;
+                mapped = true;
+            }
+        }
+
+        // The mapping keeps a reference to the file.
+        close( fd );
+    }
+#endif
+
+    if( !mapped )
+    {
+        wxString msg = wxString::Format(
+            _( "Unable to open filename \"%s\" for reading" ), aFileName.GetData() );
+        THROW_IO_ERROR( msg );
+    }
+
+    m_source  = aFileName;
+    m_lineNum = aStartingLineNumber;
+}
+
+
+MAPPED_FILE_LINE_READER::~MAPPED_FILE_LINE_READER()
+{
+    if( m_data )
+    {
+#if defined( _WIN32 )
+        UnmapViewOfFile( m_data );
+#else
+        munmap( (void*) m_data, m_size );
+#endif
+    }
+}
+
+
+const char* MAPPED_FILE_LINE_READER::nextLine()
+{
+    const char* line = m_data + m_ndx;
+    size_t      remaining = m_size - m_ndx;
+    const char* nl = remaining ? (const char*) memchr( line, '\n', remaining ) : NULL;
+
+    size_t length = nl ? nl - line + 1 : remaining;     // include the newline, so +1
+
+    if( length >= m_maxLineLength )
+        THROW_IO_ERROR( _( "Maximum line length exceeded" ) );
+
+    m_length = length;
+    m_ndx += length;
+
+    // m_lineNum is incremented even if there was no line read, because this
+    // leads to better error reporting when we hit an end of file.
+    ++m_lineNum;
+
+    return m_length ? line : NULL;
+}
+
+
+char* MAPPED_FILE_LINE_READER::ReadLine()
+{
+    const char* line = nextLine();
+
+    if( m_length + 1 > m_capacity )     // +1 for terminating nul
+        expandCapacity( m_length + 1 );
+
+    if( line )
+        memcpy( m_line, line, m_length );
+
+    m_line[m_length] = 0;
+
+    return line ? m_line : NULL;
+}
+
+
+const char* MAPPED_FILE_LINE_READER::ReadLineView()
+{
+    const char* line = nextLine();
+
+    // Line() is not the line read, leave it empty rather than stale.
+    m_line[0] = 0;
+
+    return line;
+}
+
+
 STRING_LINE_READER::STRING_LINE_READER( const std::string& aString, const wxString& aSource ):
     LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
     m_lines( aString ), m_ndx( 0 )
@@ -0,0 +1,315 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <thread_pool.h>
+
+#include <advanced_config.h>
+
+
+// The pool and index of the worker running on the current thread, if any
+static thread_local const THREAD_POOL* currentPool = nullptr;
+static thread_local size_t             currentWorker = 0;
+
+
+THREAD_POOL::THREAD_POOL( size_t aThreadCount ) :
+        m_queuedCount( 0 ),
+        m_stop( false )
+{
+    if( aThreadCount == 0 )
+        aThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 1 );
+
+    // All the workers must exist before any of them looks for a task to steal
+    for( size_t ii = 0; ii < aThreadCount; ++ii )
+        m_workers.emplace_back( new WORKER );
+
+    for( size_t ii = 0; ii < aThreadCount; ++ii )
+        m_workers[ii]->m_thread = std::thread( &THREAD_POOL::workerLoop, this, ii );
+}
+
+
+THREAD_POOL::~THREAD_POOL()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_sleepMutex );
+        m_stop = true;
+    }
+
+    m_wakeUp.notify_all();
+
+    for( auto& worker : m_workers )
+        worker->m_thread.join();
+}
+
+
+THREAD_POOL& THREAD_POOL::GetInstance()
+{
+    static THREAD_POOL instance( std::max( ADVANCED_CFG::GetCfg().m_threadPoolSize, 0 ) );
+    return instance;
+}
+
+
+bool THREAD_POOL::IsWorkerThread() const
+{
+    return currentPool == this;
+}
+
+
+void THREAD_POOL::Submit( TASK aTask )
+{
+    if( IsWorkerThread() )
+    {
+        WORKER& worker = *m_workers[ currentWorker ];
+        std::lock_guard<std::mutex> lock( worker.m_mutex );
+        worker.m_tasks.push_back( std::move( aTask ) );
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock( m_sharedMutex );
+        m_sharedTasks.push_back( std::move( aTask ) );
+    }
+
+    m_queuedCount++;
+
+    // Taking the lock ensures a worker checking m_queuedCount before going to sleep
+    // cannot miss the notification
+    {
+        std::lock_guard<std::mutex> lock( m_sleepMutex );
+    }
+
+    m_wakeUp.notify_one();
+}
+
+
+bool THREAD_POOL::popTask( size_t aIndex, TASK& aTask )
+{
+    if( m_queuedCount == 0 )
+        return false;
+
+    // Own tasks first, newest first
+    if( aIndex < m_workers.size() )
+    {
+        WORKER& worker = *m_workers[ aIndex ];
+        std::lock_guard<std::mutex> lock( worker.m_mutex );
+
+        if( !worker.m_tasks.empty() )
+        {
+            aTask = std::move( worker.m_tasks.back() );
+            worker.m_tasks.pop_back();
+            m_queuedCount--;
+            return true;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( m_sharedMutex );
+
+        if( !m_sharedTasks.empty() )
+        {
+            aTask = std::move( m_sharedTasks.front() );
+            m_sharedTasks.pop_front();
+            m_queuedCount--;
+            return true;
+        }
+    }
+
+    // Steal the oldest task of another worker, starting from the next one so the
+    // victims are spread over the workers
+    for( size_t ii = 1; ii <= m_workers.size(); ++ii )
+    {
+        size_t victimIndex = ( aIndex + ii ) % m_workers.size();
+
+        if( victimIndex == aIndex )
+            continue;
+
+        WORKER& victim = *m_workers[ victimIndex ];
+        std::lock_guard<std::mutex> lock( victim.m_mutex );
+
+        if( !victim.m_tasks.empty() )
+        {
+            aTask = std::move( victim.m_tasks.front() );
+            victim.m_tasks.pop_front();
+            m_queuedCount--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void THREAD_POOL::workerLoop( size_t aIndex )
+{
+    currentPool = this;
+    currentWorker = aIndex;
+
+    TASK task;
+
+    while( true )
+    {
+        if( popTask( aIndex, task ) )
+        {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock( m_sleepMutex );
+
+        m_wakeUp.wait( lock, [&]() { return m_stop || m_queuedCount > 0; } );
+
+        if( m_stop )
+            break;
+    }
+
+    currentPool = nullptr;
+}
+
+
+TASK_GROUP::TASK_GROUP( THREAD_POOL& aPool ) :
+        m_pool( aPool ),
+        m_queue( std::make_shared<QUEUE>() ),
+        m_pending( 0 )
+{
+}
+
+
+TASK_GROUP::~TASK_GROUP()
+{
+    // The tasks use the group, so they must be finished before it is destroyed
+    while( !WaitFor( std::chrono::milliseconds( 100 ) ) )
+        ;
+}
+
+
+void TASK_GROUP::Run( THREAD_POOL::TASK aTask )
+{
+    m_pending++;
+
+    {
+        std::lock_guard<std::mutex> lock( m_queue->m_mutex );
+
+        m_queue->m_tasks.push_back( [this, aTask]()
+        {
+            try
+            {
+                aTask();
+            }
+            catch( ... )
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+
+                if( !m_exception )
+                    m_exception = std::current_exception();
+            }
+
+            taskDone();
+        } );
+    }
+
+    std::shared_ptr<QUEUE> queue = m_queue;
+
+    m_pool.Submit( [queue]() { runQueuedTask( *queue ); } );
+}
+
+
+bool TASK_GROUP::runQueuedTask( QUEUE& aQueue )
+{
+    THREAD_POOL::TASK task;
+
+    {
+        std::lock_guard<std::mutex> lock( aQueue.m_mutex );
+
+        if( aQueue.m_tasks.empty() )
+            return false;
+
+        task = std::move( aQueue.m_tasks.front() );
+        aQueue.m_tasks.pop_front();
+    }
+
+    task();
+    return true;
+}
+
+
+void TASK_GROUP::taskDone()
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    // Decrementing under the lock ensures a waiting thread cannot miss the notification,
+    // nor see the count reach 0 and destroy the group before the notification is sent
+    if( --m_pending == 0 )
+        m_done.notify_all();
+}
+
+
+bool TASK_GROUP::WaitFor( std::chrono::milliseconds aTimeout )
+{
+    auto deadline = std::chrono::steady_clock::now() + aTimeout;
+
+    if( m_pool.IsWorkerThread() )
+    {
+        // A worker waiting for the tasks of the group runs the queued ones meanwhile (they
+        // would never run if all the workers were waiting).
+        while( m_pending > 0 )
+        {
+            if( runQueuedTask( *m_queue ) )
+                continue;
+
+            std::unique_lock<std::mutex> lock( m_mutex );
+
+            // Tasks of the group can still be queued by the running ones, so only block
+            // for a short time before looking for them again
+            if( std::chrono::steady_clock::now() >= deadline )
+                break;
+
+            m_done.wait_for( lock, std::chrono::milliseconds( 1 ),
+                             [&]() { return m_pending == 0; } );
+        }
+    }
+    else
+    {
+        std::unique_lock<std::mutex> lock( m_mutex );
+        m_done.wait_until( lock, deadline, [&]() { return m_pending == 0; } );
+    }
+
+    // Synchronize with the last taskDone(), which may still hold the lock
+    std::lock_guard<std::mutex> lock( m_mutex );
+    return m_pending == 0;
+}
+
+
+void TASK_GROUP::Wait()
+{
+    while( !WaitFor( std::chrono::hours( 1 ) ) )
+        ;
+
+    std::exception_ptr exception;
+
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        std::swap( exception, m_exception );
+    }
+
+    if( exception )
+        std::rethrow_exception( exception );
+}
@@ -24,6 +24,8 @@
 #ifndef ADVANCED_CFG__H
 #define ADVANCED_CFG__H
 
+#include <wx/string.h>
+
 class wxConfigBase;
 
 /**
@@ -78,6 +80,43 @@ public:
      */
     bool m_realTimeConnectivity;
 
+    /**
+     * Re-test the items changed by each board commit after a full DRC run
+     */
+    bool m_realTimeDrc;
+
+    /**
+     * Minimum number of clearance holes for a zone to be filled by tiles in parallel
+     * (0 to never fill by tiles)
+     */
+    int m_zoneFillTilingThreshold;
+
+    /**
+     * Number of worker threads of the shared thread pool (0 for the hardware concurrency)
+     */
+    int m_threadPoolSize;
+
+    /**
+     * Update the connectivity clusters incrementally
+     */
+    bool m_incrementalConnectivity;
+
+    /**
+     * File the router calls of the interactive routing tools are recorded to, when the
+     * router log is saved, to be replayed by qa_pcbnew_tools. Empty to record nothing.
+     */
+    wxString m_routerEventLog;
+
+    /**
+     * Evaluate the walkaround directions of the router concurrently
+     */
+    bool m_routerParallelCandidates;
+
+    /**
+     * Parse the items of the boards on worker threads
+     */
+    bool m_parallelBoardLoad;
+
     /**
      * Helper to determine if legacy canvas is allowed (according to platform
      * and config)
@@ -28,6 +28,7 @@
 
 
 #include <stdio.h>          // NULL definition.
+#include <vector>
 
 
 class EDA_ITEM;
@@ -44,6 +45,14 @@ protected:
     EDA_ITEM*     last;           ///< last elment in list, or NULL if empty
     unsigned      count;          ///< how many elements are in the list, automatically maintained.
     bool          meOwner;        ///< I must delete the objects I hold in my destructor
+    unsigned      changes;        ///< number of insertions and removals since construction
+
+    /**
+     * The elements in list order, as of the last call to BuildTable().  It is not updated
+     * when the list changes, tableChanges is the change count it was built at.
+     */
+    std::vector<EDA_ITEM*> table;
+    unsigned               tableChanges;
 
     /**
      * Constructor DHEAD
@@ -54,7 +63,9 @@ protected:
         first(0),
         last(0),
         count(0),
-        meOwner(true)
+        meOwner(true),
+        changes(0),
+        tableChanges(0)
     {
     }
 
@@ -125,6 +136,29 @@ public:
      */
     unsigned GetCount() const { return count; }
 
+    /**
+     * Function GetChangeCount
+     * returns the number of times elements were added to or removed from the list.
+     * Caches of the list contents can compare it to the value they were built with
+     * to detect any change, including the ones made by DeleteAll().
+     */
+    unsigned GetChangeCount() const { return changes; }
+
+    /**
+     * Function BuildTable
+     * fills a table of the elements in list order, for the scans which index the
+     * elements, e.g. to split them between threads.  The table is only rebuilt if the
+     * list changed since the previous call, and is not updated when the list changes:
+     * call it again after any change, before reading the table from several threads.
+     */
+    void BuildTable();
+
+    /**
+     * Function GetSlotCount
+     * returns the number of elements in the table built by BuildTable().
+     */
+    unsigned GetSlotCount() const { return table.size(); }
+
 #if defined(DEBUG)
     void VerifyListIntegrity();
 #endif
@@ -169,6 +203,12 @@ public:
      */
     T*  GetLast() const { return (T*) last; }
 
+    /**
+     * Function GetSlot
+     * returns the T* in the slot \a aSlot of the table built by BuildTable().
+     */
+    T*  GetSlot( unsigned aSlot ) const { return (T*) table[aSlot]; }
+
     /**
      * Function Append
      * adds \a aNewElement to the end of the list.
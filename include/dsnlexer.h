@@ -42,6 +42,14 @@ struct KEYWORD
     const char* name;       ///< unique keyword.
     int         token;      ///< a zero based index into an array of KEYWORDs
 };
+
+/**
+ * Type KEYWORD_LOOKUP
+ * is a function returning the token of the keyword @a aText of @a aLength chars, or
+ * DSN_SYMBOL if it is not a keyword.  Such functions are generated by CMake along with
+ * the KEYWORD tables.
+ */
+typedef int (*KEYWORD_LOOKUP)( const char* aText, size_t aLength );
 #endif
 
 // something like this macro can be used to help initialize a KEYWORD table.
@@ -107,10 +115,13 @@ protected:
 
     int                 curTok;                 ///< the current token obtained on last NextTok()
     std::string         curText;                ///< the text of the current token
+    std::string         curLine;                ///< copy of the current line for CurLine(),
+                                                ///< when it is a view in the reader's input
 
     const KEYWORD*      keywords;               ///< table sorted by CMake for bsearch()
     unsigned            keywordCount;           ///< count of keywords table
-    KEYWORD_MAP         keyword_hash;           ///< fast, specialized "C string" hashtable
+    KEYWORD_LOOKUP      keywordLookup;          ///< lookup generated by CMake for keywords,
+                                                ///< or NULL to bsearch() it
 
     void init();
 
@@ -118,13 +129,15 @@ protected:
     {
         if( reader )
         {
-            reader->ReadLine();
+            // The line is used in place when the reader allows it, it does not have to be
+            // nul terminated since it is only scanned up to limit.
+            const char* line = reader->ReadLineView();
 
             unsigned len = reader->Length();
 
             // start may have changed in ReadLine(), which can resize and
             // relocate reader's line buffer.
-            start = reader->Line();
+            start = line ? line : reader->Line();
 
             next  = start;
             limit = next + len;
@@ -516,6 +529,13 @@ public:
      */
     const char* CurLine()
     {
+        // A line read by ReadLineView() is not nul terminated, copy it for the caller.
+        if( reader && start != reader->Line() )
+        {
+            curLine.assign( start, limit );
+            return curLine.c_str();
+        }
+
         return (const char*)(*reader);
     }
 
@@ -0,0 +1,146 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file seg_batch.h
+ * @brief Tests of a point or a segment against all the segments of a polyline at once.
+ *
+ * The segments are the ones joining the consecutive points of an array (and the last point
+ * to the first one for a closed polyline), as in SHAPE_LINE_CHAIN.  Several segments are
+ * rejected at once with SSE2 or AVX instructions when the compiler targets them (scalar code
+ * is used otherwise), and the remaining ones are tested with the SEG methods, so the results
+ * are exactly the ones of the SEG methods.
+ */
+
+#ifndef __SEG_BATCH_H
+#define __SEG_BATCH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+
+#include <geometry/seg.h>
+
+namespace SEG_BATCH
+{
+
+/**
+ * Returns the smallest SEG::SquaredDistance() between aP and the segments of a polyline.
+ *
+ * @param aPoints the points of the polyline
+ * @param aPointCount the number of points
+ * @param aClosed true to test the segment joining the last point to the first one too
+ * @param aP the point to test
+ * @return the squared distance, or VECTOR2I::ECOORD_MAX if there is no segment
+ */
+SEG::ecoord SquaredDistance( const VECTOR2I* aPoints, int aPointCount, bool aClosed,
+                             const VECTOR2I& aP );
+
+/**
+ * Returns the smallest SEG::Distance() between aSeg and the segments of a polyline, if it is
+ * less than aMaxDistance.
+ *
+ * The segments whose bounding box is farther from the one of aSeg than the smallest distance
+ * found so far are rejected in batches (see OverlappingBoxes()).
+ *
+ * @return the distance, or aMaxDistance if no segment is closer
+ */
+int Distance( const VECTOR2I* aPoints, int aPointCount, bool aClosed, const SEG& aSeg,
+              int aMaxDistance = std::numeric_limits<int>::max() );
+
+/**
+ * Finds a segment of a polyline colliding with aSeg, that is a segment for which
+ * aSegFilter( segment ) is true.
+ *
+ * Only the segments whose bounding box is closer to the one of aSeg than aClearance (or
+ * touching it) are given to aSegFilter, so aSegFilter must be false for all the others.
+ *
+ * @return the index of the first segment found, or -1
+ */
+template <class FILTER>
+int FindCollision( const VECTOR2I* aPoints, int aPointCount, bool aClosed, const SEG& aSeg,
+                   int aClearance, FILTER aSegFilter );
+
+/**
+ * Returns a mask of the segments aIndex to aIndex + aCount - 1 (at most 8) of a polyline
+ * whose bounding box overlaps the box [aMin, aMax].  Used by FindCollision().
+ */
+unsigned int OverlappingBoxes( const VECTOR2I* aPoints, int aIndex, int aCount,
+                               const VECTOR2I& aMin, const VECTOR2I& aMax );
+
+/**
+ * Returns the name of the instruction set used by the batch tests ("AVX", "SSE2" or
+ * "scalar").
+ */
+const char* InstructionSet();
+
+
+template <class FILTER>
+int FindCollision( const VECTOR2I* aPoints, int aPointCount, bool aClosed, const SEG& aSeg,
+                   int aClearance, FILTER aSegFilter )
+{
+    const int margin = std::abs( aClearance );
+
+    // The box of aSeg grown by the clearance, saturated to the coordinate range
+    auto grow = []( int aValue, int aDelta )
+    {
+        int64_t v = (int64_t) aValue + aDelta;
+        return (int) std::max<int64_t>( INT_MIN, std::min<int64_t>( INT_MAX, v ) );
+    };
+
+    VECTOR2I bmin( grow( std::min( aSeg.A.x, aSeg.B.x ), -margin ),
+                   grow( std::min( aSeg.A.y, aSeg.B.y ), -margin ) );
+    VECTOR2I bmax( grow( std::max( aSeg.A.x, aSeg.B.x ), margin ),
+                   grow( std::max( aSeg.A.y, aSeg.B.y ), margin ) );
+
+    const int openCount = aPointCount - 1;
+
+    for( int i = 0; i < openCount; i += 8 )
+    {
+        int          count = std::min( 8, openCount - i );
+        unsigned int mask = OverlappingBoxes( aPoints, i, count, bmin, bmax );
+
+        for( int j = 0; mask; j++, mask >>= 1 )
+        {
+            if( ( mask & 1 ) && aSegFilter( SEG( aPoints[i + j], aPoints[i + j + 1], i + j ) ) )
+                return i + j;
+        }
+    }
+
+    if( aClosed && aPointCount > 0 )
+    {
+        SEG s( aPoints[openCount], aPoints[0], openCount );
+
+        if( std::max( s.A.x, s.B.x ) >= bmin.x && std::min( s.A.x, s.B.x ) <= bmax.x
+                && std::max( s.A.y, s.B.y ) >= bmin.y && std::min( s.A.y, s.B.y ) <= bmax.y
+                && aSegFilter( s ) )
+            return openCount;
+    }
+
+    return -1;
+}
+
+}
+
+#endif // __SEG_BATCH_H
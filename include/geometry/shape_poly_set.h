@@ -28,7 +28,9 @@
 
 #include <vector>
 #include <cstdio>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
 
@@ -226,7 +228,8 @@ class SHAPE_POLY_SET : public SHAPE
 
             T& Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].Point( m_currentVertex );
+                // Iterate() already invalidated the caches of a modifiable set
+                return m_poly->m_polys[m_currentPolygon][m_currentContour].Point( m_currentVertex );
             }
 
             T& operator*()
@@ -348,7 +351,7 @@ class SHAPE_POLY_SET : public SHAPE
 
             T Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].Segment( m_currentSegment );
+                return m_poly->CPolygon( m_currentPolygon )[m_currentContour].CSegment( m_currentSegment );
             }
 
             T operator*()
@@ -455,7 +458,7 @@ class SHAPE_POLY_SET : public SHAPE
          * @return bool - true if the relative indices are correct; false otherwise. The computed
          *              global index is returned in the \p aGlobalIdx reference.
          */
-        bool GetGlobalIndex( VERTEX_INDEX aRelativeIndices, int& aGlobalIdx );
+        bool GetGlobalIndex( VERTEX_INDEX aRelativeIndices, int& aGlobalIdx ) const;
 
         /// @copydoc SHAPE::Clone()
         SHAPE* Clone() const override;
@@ -574,6 +577,7 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aIndex-th outline in the set
         SHAPE_LINE_CHAIN& Outline( int aIndex )
         {
+            invalidateContainsIndex();
             return m_polys[aIndex][0];
         }
 
@@ -586,9 +590,9 @@ class SHAPE_POLY_SET : public SHAPE
          * @return SHAPE_POLY_SET - a set containing the polygons between aFirstPolygon (included)
          *                        and aLastPolygon (excluded).
          */
-        SHAPE_POLY_SET Subset( int aFirstPolygon, int aLastPolygon );
+        SHAPE_POLY_SET Subset( int aFirstPolygon, int aLastPolygon ) const;
 
-        SHAPE_POLY_SET UnitSet( int aPolygonIndex )
+        SHAPE_POLY_SET UnitSet( int aPolygonIndex ) const
         {
             return Subset( aPolygonIndex, aPolygonIndex + 1 );
         }
@@ -596,12 +600,14 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aHole-th hole in the aIndex-th outline
         SHAPE_LINE_CHAIN& Hole( int aOutline, int aHole )
         {
+            invalidateContainsIndex();
             return m_polys[aOutline][aHole + 1];
         }
 
         ///> Returns the aIndex-th subpolygon in the set
         POLYGON& Polygon( int aIndex )
         {
+            invalidateContainsIndex();
             return m_polys[aIndex];
         }
 
@@ -644,6 +650,8 @@ class SHAPE_POLY_SET : public SHAPE
         {
             ITERATOR iter;
 
+            invalidateContainsIndex();
+
             iter.m_poly = this;
             iter.m_currentPolygon = aFirst;
             iter.m_lastPolygon = aLast < 0 ? OutlineCount() - 1 : aLast;
@@ -1115,6 +1123,8 @@ class SHAPE_POLY_SET : public SHAPE
         bool IsVertexInHole( int aGlobalIdx );
 
     private:
+        ///> Point-in-polygon index of the contours, see containsIndex()
+        class CONTAINS_INDEX;
 
         SHAPE_LINE_CHAIN& getContourForCorner( int aCornerId, int& aIndexWithinContour );
         VECTOR2I& vertex( int aCornerId );
@@ -1157,7 +1167,35 @@ class SHAPE_POLY_SET : public SHAPE
          * @return bool - true if aP is inside aSubpolyIndex-th polygon; false in any other
          *         case.
          */
-        bool containsSingle( const VECTOR2I& aP, int aSubpolyIndex, bool aIgnoreHoles = false ) const;
+        bool containsSingle( const VECTOR2I& aP, int aSubpolyIndex, bool aIgnoreHoles = false,
+                             const CONTAINS_INDEX* aIndex = nullptr ) const;
+
+        /**
+         * Function containsIndex
+         * Returns the point-in-polygon index of the set, which is built once the set has
+         * answered a few Contains() queries since it was last modified, or nullptr before.
+         * It can be called from several threads at once.
+         */
+        const CONTAINS_INDEX* containsIndex() const;
+
+        /**
+         * Drops the point-in-polygon index.  Called by the methods which modify the set and
+         * by the non-const accessors, which hand out references to modify it: read-only code
+         * should use the const accessors (COutline(), CHole(), CPolygon(), CVertex(),
+         * CIterate()...), which keep the index.
+         */
+        void invalidateContainsIndex()
+        {
+            // Nothing to drop, the usual case while the set is built
+            if( !m_containsIndex.load( std::memory_order_relaxed ) && !m_containsQueries )
+                return;
+
+            std::lock_guard<std::mutex> lock( m_containsIndexLock );
+
+            m_containsIndex = nullptr;
+            m_containsIndexOwner.reset();
+            m_containsQueries = 0;
+        }
 
         /**
          * Operations ChamferPolygon and FilletPolygon are computed under the private chamferFillet
@@ -1213,6 +1251,16 @@ class SHAPE_POLY_SET : public SHAPE
         bool m_triangulationValid = false;
         MD5_HASH m_hash;
 
+        /**
+         * The point-in-polygon index, shared by the copies of the set and read without
+         * locking.  As it is dropped by the non-const accessors, references to the contours
+         * must not be kept to modify them after Contains() queries.
+         */
+        mutable std::shared_ptr<const CONTAINS_INDEX> m_containsIndexOwner;
+        mutable std::atomic<const CONTAINS_INDEX*>    m_containsIndex{ nullptr };
+        mutable std::atomic<int>                      m_containsQueries{ 0 };
+        mutable std::mutex                            m_containsIndexLock;
+
 };
 
 #endif
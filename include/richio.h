@@ -120,6 +120,20 @@ public:
      */
     virtual char* ReadLine() = 0;
 
+    /**
+     * Function ReadLineView
+     * reads a line of text like ReadLine(), but may return it in place in the input of
+     * the reader instead of copying it into the line buffer.  Such a line is not nul
+     * terminated, is only valid until the next read, and is not the one returned by Line().
+     * Use Length() for its size.
+     * @return const char* - The beginning of the read line, or NULL if EOF.
+     * @throw IO_ERROR when a line is too long.
+     */
+    virtual const char* ReadLineView()
+    {
+        return ReadLine();
+    }
+
     /**
      * Function GetSource
      * returns the name of the source of the lines in an abstract sense.
@@ -247,6 +261,63 @@ public:
 };
 
 
+/**
+ * Class MAPPED_FILE_LINE_READER
+ * is a LINE_READER that reads from a file mapped into memory.  ReadLineView() returns
+ * the lines in place in the mapping, without copying them, which makes it the fastest
+ * reader for the large files read by a DSNLEXER.  The end of line characters are not
+ * translated, so the lines of a file written on Windows end with "\r\n".
+ */
+class MAPPED_FILE_LINE_READER : public LINE_READER
+{
+protected:
+
+    const char* m_data;     ///< the mapped file, or NULL if the file is empty.
+    size_t      m_size;     ///< the size of the mapped file.
+    size_t      m_ndx;      ///< the offset of the next line to read.
+
+    /**
+     * Function nextLine
+     * finds the next line of the file, increments the line number counter and returns
+     * the beginning of the line, or NULL if EOF.  Its length is put in m_length.
+     */
+    const char* nextLine();
+
+public:
+
+    /**
+     * Constructor MAPPED_FILE_LINE_READER
+     * maps @a aFileName into memory for reading.
+     *
+     * @param aFileName is the name of the file to map and to use for error reporting purposes.
+     * @param aStartingLineNumber is the initial line number to report on error.
+     * @param aMaxLineLength is the maximum allowed length of a line.
+     *
+     * @throw IO_ERROR if @a aFileName cannot be opened or mapped.
+     */
+    MAPPED_FILE_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber = 0,
+            unsigned aMaxLineLength = LINE_READER_LINE_DEFAULT_MAX );
+
+    ~MAPPED_FILE_LINE_READER();
+
+    char* ReadLine() override;
+
+    const char* ReadLineView() override;
+
+    /**
+     * Function Rewind
+     * rewinds the file and resets the line number back to zero.  Line number
+     * will go to 1 on first ReadLine().
+     */
+    void Rewind()
+    {
+        m_ndx = 0;
+        m_lineNum = 0;
+    }
+};
+
+
 /**
  * Class STRING_LINE_READER
  * is a LINE_READER that reads from a multiline 8 bit wide std::string
@@ -0,0 +1,251 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef THREAD_POOL__H
+#define THREAD_POOL__H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Class THREAD_POOL
+ * A fixed set of worker threads running short tasks, shared by all the parallel
+ * algorithms of the application instead of each of them starting its own threads.
+ *
+ * Each worker has its own task queue: tasks submitted from a worker are queued on this
+ * worker (and run last in, first out, while the data is still in cache), tasks submitted
+ * from other threads go to a shared queue.  An idle worker takes tasks from the shared
+ * queue, then steals the oldest tasks of the other workers.
+ *
+ * Tasks are not submitted directly, but through a TASK_GROUP, which is used to wait for
+ * them.
+ */
+class THREAD_POOL
+{
+public:
+    typedef std::function<void()> TASK;
+
+    /**
+     * Creates a pool of aThreadCount workers (the hardware concurrency if 0).
+     * Most callers should use the shared pool returned by GetInstance().
+     */
+    explicit THREAD_POOL( size_t aThreadCount = 0 );
+    ~THREAD_POOL();
+
+    THREAD_POOL( const THREAD_POOL& ) = delete;
+    THREAD_POOL& operator=( const THREAD_POOL& ) = delete;
+
+    /**
+     * Function GetInstance()
+     * @return the pool shared by the whole application.  Its size is the ThreadPoolSize
+     * advanced config option, or the hardware concurrency if not set.
+     */
+    static THREAD_POOL& GetInstance();
+
+    /**
+     * Function GetThreadCount()
+     * @return the number of workers.
+     */
+    size_t GetThreadCount() const { return m_workers.size(); }
+
+    /**
+     * Function IsWorkerThread()
+     * @return true if the calling thread is one of the workers of this pool.
+     */
+    bool IsWorkerThread() const;
+
+    /**
+     * Function Submit()
+     * Queues a task.  Tasks must not throw: use a TASK_GROUP to forward exceptions.
+     */
+    void Submit( TASK aTask );
+
+private:
+    struct WORKER
+    {
+        std::mutex        m_mutex;
+        std::deque<TASK>  m_tasks;
+        std::thread       m_thread;
+    };
+
+    void workerLoop( size_t aIndex );
+
+    /**
+     * Takes the next task to run by worker aIndex (or by a non-worker thread if aIndex
+     * is out of range).
+     */
+    bool popTask( size_t aIndex, TASK& aTask );
+
+    std::vector<std::unique_ptr<WORKER>> m_workers;
+
+    std::mutex              m_sharedMutex;
+    std::deque<TASK>        m_sharedTasks;  ///< tasks submitted from non-worker threads
+
+    std::mutex              m_sleepMutex;
+    std::condition_variable m_wakeUp;
+    std::atomic<size_t>     m_queuedCount;  ///< tasks queued but not started yet
+    std::atomic<bool>       m_stop;
+};
+
+
+/**
+ * Class TASK_GROUP
+ * A set of tasks run by a THREAD_POOL, which can be waited for together.
+ *
+ * Tasks may add tasks to their own group or create nested groups: a worker waiting for
+ * a group runs the tasks of this group which are still queued meanwhile, so nested waits
+ * do not starve the pool.  It never runs the tasks of other groups, which could take
+ * much longer than the ones it waits for.
+ * The first exception thrown by a task is rethrown by Wait().
+ * The destructor waits for the remaining tasks, discarding their exceptions.
+ */
+class TASK_GROUP
+{
+public:
+    explicit TASK_GROUP( THREAD_POOL& aPool = THREAD_POOL::GetInstance() );
+    ~TASK_GROUP();
+
+    TASK_GROUP( const TASK_GROUP& ) = delete;
+    TASK_GROUP& operator=( const TASK_GROUP& ) = delete;
+
+    /**
+     * Function Run()
+     * Queues aTask in the pool.
+     */
+    void Run( THREAD_POOL::TASK aTask );
+
+    /**
+     * Function Wait()
+     * Blocks until all the tasks of the group are finished, then rethrows the first
+     * exception thrown by a task, if any.
+     */
+    void Wait();
+
+    /**
+     * Function WaitFor()
+     * Blocks until all the tasks of the group are finished or aTimeout is elapsed, so
+     * the main thread can keep its progress reporter refreshed while waiting.
+     * Exceptions thrown by the tasks are only reported by Wait().
+     * @return true if all the tasks are finished.
+     */
+    bool WaitFor( std::chrono::milliseconds aTimeout );
+
+    /**
+     * Function GetPendingCount()
+     * @return the number of tasks queued or running.
+     */
+    size_t GetPendingCount() const { return m_pending; }
+
+    THREAD_POOL& GetPool() const { return m_pool; }
+
+private:
+    /**
+     * The tasks of a group which are not started yet.  Each of them is run by the first
+     * of the pool task submitted for it and a worker waiting for the group.  The pool
+     * tasks share the queue, because they can run after the group is destroyed (when
+     * their task was already run by a waiting worker).
+     */
+    struct QUEUE
+    {
+        std::mutex                    m_mutex;
+        std::deque<THREAD_POOL::TASK> m_tasks;
+    };
+
+    /**
+     * Runs the oldest task of aQueue in the calling thread, if any.
+     * @return true if a task was run.
+     */
+    static bool runQueuedTask( QUEUE& aQueue );
+
+    void taskDone();
+
+    THREAD_POOL&            m_pool;
+    std::shared_ptr<QUEUE>  m_queue;
+    std::atomic<size_t>     m_pending;
+
+    std::mutex              m_mutex;
+    std::condition_variable m_done;
+    std::exception_ptr      m_exception;
+};
+
+
+/**
+ * Function ParallelFor()
+ * Calls aFunc( i ) for i in [0, aCount) from the workers of aPool and the calling thread,
+ * and returns once all the calls are finished.  Indices are dispatched one at a time, so
+ * calls of uneven cost are balanced between the threads.  Can be nested.
+ *
+ * @param aMaxThreads if not 0, limits the number of threads working on the loop.
+ */
+template <typename FUNC>
+void ParallelFor( size_t aCount, FUNC&& aFunc, size_t aMaxThreads = 0,
+                  THREAD_POOL& aPool = THREAD_POOL::GetInstance() )
+{
+    if( aCount == 0 )
+        return;
+
+    size_t threadCount = std::min( aCount, aPool.GetThreadCount() + 1 );
+
+    if( aMaxThreads > 0 )
+        threadCount = std::min( threadCount, aMaxThreads );
+
+    std::atomic<size_t> next( 0 );
+
+    auto loop = [&]()
+    {
+        for( size_t i = next.fetch_add( 1 ); i < aCount; i = next.fetch_add( 1 ) )
+            aFunc( i );
+    };
+
+    TASK_GROUP group( aPool );
+
+    // The calling thread works on the loop too
+    for( size_t ii = 1; ii < threadCount; ++ii )
+        group.Run( loop );
+
+    try
+    {
+        loop();
+    }
+    catch( ... )
+    {
+        // Stop the other threads before the locals they use are destroyed
+        next = aCount;
+        throw;
+    }
+
+    group.Wait();
+}
+
+
+#endif // THREAD_POOL__H
@@ -270,6 +270,12 @@ protected:
     EDGE_WEAK_PTR   m_twinEdge;
     EDGE_PTR        m_nextEdgeInFace;
     bool            m_isLeadingEdge;
+
+    /// Position in the leading edges of the triangulation (if a leading edge), so the
+    /// edge can be removed from the list without searching it
+    std::list<EDGE_PTR>::iterator m_leadingEdgeIt;
+
+    friend class TRIANGULATION;
 };
 
 class DART; // Forward declaration (class in this namespace)
@@ -290,6 +296,7 @@ protected:
     {
         aEdge->SetAsLeadingEdge();
         m_leadingEdges.push_front( aEdge );
+        aEdge->m_leadingEdgeIt = m_leadingEdges.begin();
     }
 
     bool removeLeadingEdgeFromList( EDGE_PTR& aLeadingEdge );
@@ -164,7 +164,7 @@ bool AR_AUTOPLACER::fillMatrix()
     // Create a single board outline:
     SHAPE_POLY_SET brd_shape = m_boardShape;
     brd_shape.Fracture( SHAPE_POLY_SET::PM_FAST );
-    const SHAPE_LINE_CHAIN& outline = brd_shape.Outline(0);
+    const SHAPE_LINE_CHAIN& outline = brd_shape.COutline(0);
     const BOX2I& rect = outline.BBox();
 
     // Creates the horizontal segments
@@ -32,6 +32,7 @@
 #include <tools/pcb_tool_base.h>
 #include <tools/pcb_actions.h>
 #include <connectivity/connectivity_data.h>
+#include <drc.h>
 
 #include <functional>
 using namespace std::placeholders;
@@ -67,10 +68,14 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
     auto              connectivity = board->GetConnectivity();
     std::set<EDA_ITEM*>      savedModules;
     std::vector<BOARD_ITEM*> itemsToDeselect;
+    std::vector<BOARD_ITEM*> changedItems;      // for the incremental DRC
+    std::vector<BOARD_ITEM*> removedItems;
 
     if( Empty() )
         return;
 
+    const unsigned listChangeCount = board->GetItemListsChangeCount();
+
     for( COMMIT_LINE& ent : m_changes )
     {
         int changeType = ent.m_type & CHT_TYPE;
@@ -123,6 +128,7 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
                     if( !( changeFlags & CHT_DONE ) )
                         board->Add( boardItem );        // handles connectivity
 
+                    changedItems.push_back( boardItem );
                 }
                 else
                 {
@@ -144,6 +150,9 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
                 if( !m_editModules && aCreateUndoEntry )
                     undoList.PushItem( ITEM_PICKER( boardItem, UR_DELETED ) );
 
+                if( !m_editModules )
+                    removedItems.push_back( boardItem );
+
                 switch( boardItem->Type() )
                 {
                 // Module items
@@ -237,6 +246,9 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
                 connectivity->Update( boardItem );
                 view->Update( boardItem );
 
+                if( !m_editModules )
+                    changedItems.push_back( boardItem );
+
                 // if no undo entry is needed, the copy would create a memory leak
                 if( !aCreateUndoEntry )
                     delete ent.m_copy;
@@ -305,6 +317,16 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
     frame->UpdateMsgPanel();
 
     clear();
+
+    // Keep the DRC markers up to date if the incremental DRC is enabled.
+    // The removed items are still alive here (they are owned by the undo list or the caller).
+    if( !m_editModules && frame->IsType( FRAME_PCB ) )
+    {
+        DRC* drc = static_cast<PCB_EDIT_FRAME*>( frame )->GetDrcController();
+
+        if( drc && drc->IsIncrementalMode() )
+            drc->UpdateIncremental( changedItems, removedItems, listChangeCount );
+    }
 }
 
 
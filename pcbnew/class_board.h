@@ -280,6 +280,16 @@ public:
 
     void Remove( BOARD_ITEM* aBoardItem ) override;
 
+    /**
+     * Function GetItemListsChangeCount
+     * @return a number which changes each time a track, a via or a footprint is added to
+     * or removed from the board, by any means (see DHEAD::GetChangeCount()).
+     */
+    unsigned GetItemListsChangeCount() const
+    {
+        return m_Track.GetChangeCount() + m_Modules.GetChangeCount();
+    }
+
     BOARD_ITEM* GetItem( void* aWeakReference );
 
     BOARD_ITEM* Duplicate( const BOARD_ITEM* aItem, bool aAddToBoard = false );
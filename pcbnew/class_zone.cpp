@@ -562,7 +562,7 @@ void ZONE_CONTAINER::DrawWhileCreateOutline( EDA_DRAW_PANEL* panel, wxDC* DC,
     }
 
     // Object to iterate through the corners of the outlines
-    SHAPE_POLY_SET::ITERATOR iterator = m_Poly->Iterate();
+    SHAPE_POLY_SET::CONST_ITERATOR iterator = m_Poly->CIterate();
 
     // Segment start and end
     VECTOR2I seg_start, seg_end;
@@ -750,8 +750,8 @@ bool ZONE_CONTAINER::HitTest( const EDA_RECT& aRect, bool aContained, int aAccur
         int count = m_Poly->TotalVertices();
         for( int ii =0; ii < count; ii++ )
         {
-            auto vertex = m_Poly->Vertex( ii );
-            auto vertexNext = m_Poly->Vertex( ( ii + 1 ) % count );
+            auto vertex = m_Poly->CVertex( ii );
+            auto vertexNext = m_Poly->CVertex( ( ii + 1 ) % count );
 
             // Test if the point is within the rect
             if( arect.Contains( ( wxPoint ) vertex ) )
@@ -1124,12 +1124,12 @@ void ZONE_CONTAINER::Hatch()
         return;
 
     // define range for hatch lines
-    int min_x = m_Poly->Vertex( 0 ).x;
-    int max_x = m_Poly->Vertex( 0 ).x;
-    int min_y = m_Poly->Vertex( 0 ).y;
-    int max_y = m_Poly->Vertex( 0 ).y;
+    int min_x = m_Poly->CVertex( 0 ).x;
+    int max_x = m_Poly->CVertex( 0 ).x;
+    int min_y = m_Poly->CVertex( 0 ).y;
+    int max_y = m_Poly->CVertex( 0 ).y;
 
-    for( auto iterator = m_Poly->IterateWithHoles(); iterator; iterator++ )
+    for( auto iterator = m_Poly->CIterateWithHoles(); iterator; iterator++ )
     {
         if( iterator->x < min_x )
             min_x = iterator->x;
@@ -502,8 +502,8 @@ public:
         // Convert global to relative indices
         if( m_Poly->GetRelativeIndices( aCornerIndex, &relativeIndices ) )
         {
-            if( m_Poly->Vertex( relativeIndices ).x != new_pos.x ||
-                m_Poly->Vertex( relativeIndices ).y != new_pos.y )
+            if( m_Poly->CVertex( relativeIndices ).x != new_pos.x ||
+                m_Poly->CVertex( relativeIndices ).y != new_pos.y )
                 SetNeedRefill( true );
 
             m_Poly->Vertex( relativeIndices ).x = new_pos.x;
@@ -711,6 +711,28 @@ public:
      */
     void BuildHashValue() { m_filledPolysHash = m_FilledPolysList.GetHash(); }
 
+    /**
+     * Function SetFillCache
+     * stores the filled polygons computed by the zone filler, before the removal of the
+     * insulated islands, and the hash of the fill inputs (outline, settings and obstacles)
+     * they were computed from.  The zone filler reuses these polygons instead of filling
+     * the zone again as long as the inputs hash is the same.
+     * Like m_RawPolysList, the cache is not copied with the zone.
+     */
+    void SetFillCache( const MD5_HASH& aInputsHash, const SHAPE_POLY_SET& aPolys )
+    {
+        m_fillCacheHash = aInputsHash;
+        m_fillCachePolys = aPolys;
+    }
+
+    /** @return the inputs hash stored by SetFillCache(), invalid if no fill is cached.
+     */
+    const MD5_HASH& GetFillCacheHash() const { return m_fillCacheHash; }
+
+    /** @return the filled polygons stored by SetFillCache().
+     */
+    const SHAPE_POLY_SET& GetFillCachePolys() const { return m_fillCachePolys; }
+
 
 
 #if defined(DEBUG)
@@ -811,6 +833,8 @@ private:
     SHAPE_POLY_SET        m_RawPolysList;
     MD5_HASH              m_filledPolysHash;    // A hash value used in zone filling calculations
                                                 // to see if the filled areas are up to date
+    MD5_HASH              m_fillCacheHash;      // Hash of the inputs of the cached fill
+    SHAPE_POLY_SET        m_fillCachePolys;     // Cached fill, insulated islands not removed
 
     HATCH_STYLE           m_hatchStyle;     // hatch style, see enum above
     int                   m_hatchPitch;     // for DIAGONAL_EDGE, distance between 2 hatch lines
@@ -26,17 +26,367 @@
 #include <widgets/progress_reporter.h>
 #include <geometry/geometry_utils.h>
 #include <board_commit.h>
+#include <thread_pool.h>
+#include <advanced_config.h>
 
-#include <thread>
 #include <mutex>
 #include <algorithm>
-#include <future>
+#include <atomic>
+#include <functional>
 
 #ifdef PROFILE
 #include <profile.h>
 #endif
 
 
+CN_INCREMENTAL_CLUSTERS::CN_INCREMENTAL_CLUSTERS( bool aWithinNet, bool aWithZones ) :
+    m_withinNet( aWithinNet ),
+    m_withZones( aWithZones ),
+    m_built( false ),
+    m_sorted( true )
+{
+}
+
+
+void CN_INCREMENTAL_CLUSTERS::Clear()
+{
+    m_built = false;
+    m_sorted = true;
+    m_clusters.clear();
+    m_dead.clear();
+    m_modified.clear();
+    m_membership.clear();
+}
+
+
+void CN_INCREMENTAL_CLUSTERS::Build( const CLUSTERS& aClusters )
+{
+    Clear();
+
+    m_built = true;
+    m_clusters = aClusters;
+
+    for( const auto& cluster : m_clusters )
+    {
+        for( auto item : *cluster )
+            m_membership[ item ] = cluster.get();
+    }
+}
+
+
+bool CN_INCREMENTAL_CLUSTERS::accepts( const CN_ITEM* aItem ) const
+{
+    if( !aItem->Valid() )
+        return false;
+
+    if( !m_withZones && aItem->Parent()->Type() == PCB_ZONE_AREA_T )
+        return false;
+
+    return !m_withinNet || aItem->Net() > 0;
+}
+
+
+bool CN_INCREMENTAL_CLUSTERS::isMember( const CN_ITEM* aItem, const CN_CLUSTER* aCluster ) const
+{
+    auto it = m_membership.find( aItem );
+
+    return it != m_membership.end() && it->second == aCluster;
+}
+
+
+CN_CLUSTER* CN_INCREMENTAL_CLUSTERS::newCluster()
+{
+    m_clusters.emplace_back( new CN_CLUSTER() );
+    m_sorted = false;
+
+    CN_CLUSTER* cluster = m_clusters.back().get();
+    m_modified.insert( cluster );
+
+    return cluster;
+}
+
+
+CN_CLUSTER* CN_INCREMENTAL_CLUSTERS::merge( CN_CLUSTER* aA, CN_CLUSTER* aB )
+{
+    if( aA->Size() < aB->Size() )
+        std::swap( aA, aB );
+
+    for( auto item : *aB )
+    {
+        aA->Add( item );
+        m_membership[ item ] = aA;
+    }
+
+    m_dead.insert( aB );
+    m_modified.erase( aB );
+    m_modified.insert( aA );
+    m_sorted = false;
+
+    return aA;
+}
+
+
+void CN_INCREMENTAL_CLUSTERS::AddItems( const std::vector<CN_ITEM*>& aItems )
+{
+    if( !m_built )
+        return;
+
+    for( auto item : aItems )
+    {
+        if( !accepts( item ) )
+            continue;
+
+        // Dirty items already in a cluster may have new connections to other clusters
+        auto        member = m_membership.find( item );
+        CN_CLUSTER* cluster = member != m_membership.end() ? member->second : nullptr;
+
+        for( auto neighbour : item->ConnectedItems() )
+        {
+            if( !neighbour->Valid() )
+                continue;
+
+            if( m_withinNet && neighbour->Net() != item->Net() )
+                continue;
+
+            auto it = m_membership.find( neighbour );
+
+            // Neighbours added in the same batch join the cluster when they are added
+            if( it == m_membership.end() || it->second == cluster )
+                continue;
+
+            cluster = cluster ? merge( cluster, it->second ) : it->second;
+        }
+
+        if( !cluster )
+            cluster = newCluster();
+
+        if( m_membership[ item ] != cluster )
+        {
+            cluster->Add( item );
+            m_membership[ item ] = cluster;
+        }
+
+        m_modified.insert( cluster );
+        m_sorted = false;
+    }
+}
+
+
+void CN_INCREMENTAL_CLUSTERS::RemoveItems( const std::vector<CN_ITEM*>& aItems )
+{
+    if( !m_built )
+        return;
+
+    // Seeds of the split searches (the neighbours of the removed items), by cluster
+    std::unordered_map<CN_CLUSTER*, std::vector<CN_ITEM*>> seeds;
+    std::unordered_set<const CN_ITEM*>                     removed;
+
+    for( auto item : aItems )
+    {
+        auto it = m_membership.find( item );
+
+        if( it == m_membership.end() )
+            continue;
+
+        std::vector<CN_ITEM*>& clusterSeeds = seeds[ it->second ];
+
+        // The connections are only followed while the item is allocated
+        for( auto neighbour : item->ConnectedItems() )
+            clusterSeeds.push_back( neighbour );
+
+        removed.insert( item );
+        m_membership.erase( it );
+    }
+
+    for( auto& entry : seeds )
+        split( entry.first, entry.second, removed );
+}
+
+
+void CN_INCREMENTAL_CLUSTERS::split( CN_CLUSTER* aCluster, const std::vector<CN_ITEM*>& aSeeds,
+                                     const std::unordered_set<const CN_ITEM*>& aRemoved )
+{
+    struct SEARCH
+    {
+        int                   m_parent;     ///< the search this one was merged into
+        bool                  m_done;       ///< ran out of items
+        std::deque<CN_ITEM*>  m_queue;
+        std::vector<CN_ITEM*> m_visited;
+    };
+
+    std::vector<SEARCH>                  searches;
+    std::unordered_map<const CN_ITEM*, int> owner;
+
+    for( auto seed : aSeeds )
+    {
+        // Removed items are no longer members, so they are skipped here
+        if( !isMember( seed, aCluster ) || !seed->Valid() || owner.count( seed ) )
+            continue;
+
+        owner[ seed ] = (int) searches.size();
+        searches.push_back( { (int) searches.size(), false, { seed }, { seed } } );
+    }
+
+    auto root = [&searches]( int aSearch )
+    {
+        while( searches[ aSearch ].m_parent != aSearch )
+            aSearch = searches[ aSearch ].m_parent;
+
+        return aSearch;
+    };
+
+    std::unordered_set<const CN_ITEM*> splitOff;
+    int                                live = (int) searches.size();
+
+    while( live > 1 )
+    {
+        for( int ii = 0; ii < (int) searches.size() && live > 1; ++ii )
+        {
+            SEARCH& search = searches[ii];
+
+            if( search.m_parent != ii || search.m_done )
+                continue;
+
+            if( search.m_queue.empty() )
+            {
+                // This part of the cluster is not connected to the others any more
+                CN_CLUSTER* part = newCluster();
+
+                for( auto item : search.m_visited )
+                {
+                    part->Add( item );
+                    m_membership[ item ] = part;
+                    splitOff.insert( item );
+                }
+
+                search.m_done = true;
+                live--;
+                continue;
+            }
+
+            CN_ITEM* current = search.m_queue.front();
+            search.m_queue.pop_front();
+
+            for( auto neighbour : current->ConnectedItems() )
+            {
+                if( !isMember( neighbour, aCluster ) || !neighbour->Valid() )
+                    continue;
+
+                if( m_withinNet && neighbour->Net() != current->Net() )
+                    continue;
+
+                auto it = owner.find( neighbour );
+
+                if( it == owner.end() )
+                {
+                    owner[ neighbour ] = ii;
+                    search.m_queue.push_back( neighbour );
+                    search.m_visited.push_back( neighbour );
+                    continue;
+                }
+
+                int other = root( it->second );
+
+                if( other == ii )
+                    continue;
+
+                // The two searches met: they explore the same part of the cluster
+                SEARCH& merged = searches[ other ];
+
+                search.m_queue.insert( search.m_queue.end(), merged.m_queue.begin(),
+                                       merged.m_queue.end() );
+                search.m_visited.insert( search.m_visited.end(), merged.m_visited.begin(),
+                                         merged.m_visited.end() );
+                merged.m_queue.clear();
+                merged.m_visited.clear();
+                merged.m_parent = ii;
+
+                if( --live <= 1 )
+                    break;
+            }
+        }
+    }
+
+    // The removed and split off items leave the cluster
+    aCluster->RemoveIf( [&]( CN_ITEM* aItem )
+            {
+                return aRemoved.count( aItem ) || splitOff.count( aItem );
+            } );
+
+    if( aCluster->Size() == 0 )
+    {
+        m_dead.insert( aCluster );
+        m_modified.erase( aCluster );
+    }
+    else
+    {
+        m_modified.insert( aCluster );
+    }
+
+    m_sorted = false;
+}
+
+
+const CN_INCREMENTAL_CLUSTERS::CLUSTERS& CN_INCREMENTAL_CLUSTERS::Clusters()
+{
+    if( !m_sorted )
+    {
+        if( !m_dead.empty() )
+        {
+            m_clusters.erase( std::remove_if( m_clusters.begin(), m_clusters.end(),
+                    [this]( const CN_CLUSTER_PTR& aCluster )
+                    {
+                        return m_dead.count( aCluster.get() ) > 0;
+                    } ), m_clusters.end() );
+
+            m_dead.clear();
+        }
+
+        std::sort( m_clusters.begin(), m_clusters.end(), []( CN_CLUSTER_PTR a, CN_CLUSTER_PTR b ) {
+            return a->OriginNet() < b->OriginNet();
+        } );
+
+        m_sorted = true;
+    }
+
+    return m_clusters;
+}
+
+
+CN_INCREMENTAL_CLUSTERS::CLUSTERS CN_INCREMENTAL_CLUSTERS::TakeModifiedClusters()
+{
+    CLUSTERS modified;
+
+    for( const auto& cluster : Clusters() )
+    {
+        if( m_modified.count( cluster.get() ) )
+            modified.push_back( cluster );
+    }
+
+    m_modified.clear();
+
+    return modified;
+}
+
+
+CN_CONNECTIVITY_ALGO::CN_CONNECTIVITY_ALGO() :
+    m_incremental( ADVANCED_CFG::GetCfg().m_incrementalConnectivity ),
+    m_propagateIndex( false, false ),
+    m_ratsnestIndex( true, true )
+{
+}
+
+
+void CN_CONNECTIVITY_ALGO::SetIncremental( bool aIncremental )
+{
+    m_incremental = aIncremental;
+
+    // The clusters are searched again the next time they are needed
+    m_propagateIndex.Clear();
+    m_ratsnestIndex.Clear();
+}
+
+
 bool CN_CONNECTIVITY_ALGO::Remove( BOARD_ITEM* aItem )
 {
     markItemNetAsDirty( aItem );
@@ -198,6 +548,12 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 
     m_itemList.RemoveInvalidItems( garbage );
 
+    if( m_incremental )
+    {
+        m_propagateIndex.RemoveItems( garbage );
+        m_ratsnestIndex.RemoveItems( garbage );
+    }
+
     for( auto item : garbage )
         delete item;
 
@@ -218,14 +574,14 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 
     if( m_itemList.IsDirty() )
     {
-        size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+        TASK_GROUP group;
+        size_t     parallelThreadCount = std::min<size_t>( group.GetPool().GetThreadCount(),
                 ( dirtyItems.size() + 7 ) / 8 );
 
         std::atomic<size_t> nextItem( 0 );
-        std::vector<std::future<size_t>> returns( parallelThreadCount );
 
         auto conn_lambda = [&nextItem, &dirtyItems]
-                            ( CN_LIST* aItemList, PROGRESS_REPORTER* aReporter) -> size_t
+                            ( CN_LIST* aItemList, PROGRESS_REPORTER* aReporter)
         {
             for( size_t i = nextItem++; i < dirtyItems.size(); i = nextItem++ )
             {
@@ -235,8 +591,6 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
                 if( aReporter )
                     aReporter->AdvanceProgress();
             }
-
-            return 1;
         };
 
         if( parallelThreadCount <= 1 )
@@ -244,27 +598,28 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
         else
         {
             for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-                returns[ii] = std::async( std::launch::async, conn_lambda,
-                        &m_itemList, m_progressReporter );
+                group.Run( std::bind( conn_lambda, &m_itemList, m_progressReporter ) );
 
-            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            // Here we wait with a 100ms timeout to allow UI updating
+            while( !group.WaitFor( std::chrono::milliseconds( 100 ) ) )
             {
-                // Here we balance returns with a 100ms timeout to allow UI updating
-                std::future_status status;
-                do
-                {
-                    if( m_progressReporter )
-                        m_progressReporter->KeepRefreshing();
-
-                    status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-                } while( status != std::future_status::ready );
+                if( m_progressReporter )
+                    m_progressReporter->KeepRefreshing();
             }
+
+            group.Wait();
         }
 
         if( m_progressReporter )
             m_progressReporter->KeepRefreshing();
     }
 
+    if( m_incremental )
+    {
+        m_propagateIndex.AddItems( dirtyItems );
+        m_ratsnestIndex.AddItems( dirtyItems );
+    }
+
 #ifdef PROFILE
         search_basic.Show();
 #endif
@@ -447,6 +802,8 @@ void CN_CONNECTIVITY_ALGO::Build( const std::vector<BOARD_ITEM*>& aItems )
 
 void CN_CONNECTIVITY_ALGO::propagateConnections( BOARD_COMMIT* aCommit )
 {
+    std::vector<CN_ITEM*> changedItems;
+
     for( const auto& cluster : m_connClusters )
     {
         if( cluster->IsConflicting() )
@@ -476,6 +833,7 @@ void CN_CONNECTIVITY_ALGO::propagateConnections( BOARD_COMMIT* aCommit )
                             aCommit->Modify( item->Parent() );
 
                         item->Parent()->SetNetCode( cluster->OriginNet() );
+                        changedItems.push_back( item );
                         n_changed++;
                     }
                 }
@@ -492,12 +850,34 @@ void CN_CONNECTIVITY_ALGO::propagateConnections( BOARD_COMMIT* aCommit )
             wxLogTrace( "CN", "Cluster %p : connected to unused net\n", cluster.get() );
         }
     }
+
+    // The ratsnest clusters only connect items of the same net
+    if( m_incremental && !changedItems.empty() )
+    {
+        m_ratsnestIndex.RemoveItems( changedItems );
+        m_ratsnestIndex.AddItems( changedItems );
+    }
 }
 
 
 void CN_CONNECTIVITY_ALGO::PropagateNets( BOARD_COMMIT* aCommit )
 {
-    m_connClusters = SearchClusters( CSM_PROPAGATE );
+    if( m_incremental && m_propagateIndex.IsBuilt() )
+    {
+        if( m_itemList.IsDirty() )
+            searchConnections();
+
+        // Nets only need to be propagated again in the clusters which have changed
+        m_connClusters = m_propagateIndex.TakeModifiedClusters();
+    }
+    else
+    {
+        m_connClusters = SearchClusters( CSM_PROPAGATE );
+
+        if( m_incremental )
+            m_propagateIndex.Build( m_connClusters );
+    }
+
     propagateConnections( aCommit );
 }
 
@@ -568,7 +948,21 @@ void CN_CONNECTIVITY_ALGO::FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLAT
 
 const CN_CONNECTIVITY_ALGO::CLUSTERS& CN_CONNECTIVITY_ALGO::GetClusters()
 {
-    m_ratsnestClusters = SearchClusters( CSM_RATSNEST );
+    if( m_incremental && m_ratsnestIndex.IsBuilt() )
+    {
+        if( m_itemList.IsDirty() )
+            searchConnections();
+
+        m_ratsnestClusters = m_ratsnestIndex.Clusters();
+    }
+    else
+    {
+        m_ratsnestClusters = SearchClusters( CSM_RATSNEST );
+
+        if( m_incremental )
+            m_ratsnestIndex.Build( m_ratsnestClusters );
+    }
+
     return m_ratsnestClusters;
 }
 
@@ -602,9 +996,9 @@ void CN_VISITOR::checkZoneItemConnection( CN_ZONE* aZone, CN_ITEM* aItem )
     if( zoneItem->Net() != aItem->Net() && !aItem->CanChangeNet() )
         return;
 
-    if( zoneItem->ContainsPoint( aItem->GetAnchor( 0 ) ) ||
+    if( zoneItem->ContainsPoint( aItem->AnchorPos( 0 ) ) ||
             ( aItem->Parent()->Type() == PCB_TRACE_T &&
-              zoneItem->ContainsPoint( aItem->GetAnchor( 1 ) ) ) )
+              zoneItem->ContainsPoint( aItem->AnchorPos( 1 ) ) ) )
     {
         zoneItem->Connect( aItem );
         aItem->Connect( zoneItem );
@@ -625,11 +1019,10 @@ void CN_VISITOR::checkZoneZoneConnection( CN_ZONE* aZoneA, CN_ZONE* aZoneB )
     if( aZoneB->Net() != aZoneA->Net() )
         return; // we only test zones belonging to the same net
 
-    const auto& outline = refParent->GetFilledPolysList().COutline( aZoneA->SubpolyIndex() );
-
-    for( int i = 0; i < outline.PointCount(); i++ )
+    // The anchors of a zone item are the points of its outline
+    for( int i = 0; i < (int) aZoneA->Anchors().size(); i++ )
     {
-        if( aZoneB->ContainsPoint( outline.CPoint( i ) ) )
+        if( aZoneB->ContainsPoint( aZoneA->AnchorPos( i ) ) )
         {
             aZoneA->Connect( aZoneB );
             aZoneB->Connect( aZoneA );
@@ -637,11 +1030,9 @@ void CN_VISITOR::checkZoneZoneConnection( CN_ZONE* aZoneA, CN_ZONE* aZoneB )
         }
     }
 
-    const auto& outline2 = testedParent->GetFilledPolysList().COutline( aZoneB->SubpolyIndex() );
-
-    for( int i = 0; i < outline2.PointCount(); i++ )
+    for( int i = 0; i < (int) aZoneB->Anchors().size(); i++ )
     {
-        if( aZoneA->ContainsPoint( outline2.CPoint( i ) ) )
+        if( aZoneA->ContainsPoint( aZoneB->AnchorPos( i ) ) )
         {
             aZoneA->Connect( aZoneB );
             aZoneB->Connect( aZoneA );
@@ -694,13 +1085,15 @@ bool CN_VISITOR::operator()( CN_ITEM* aCandidate )
     // Items do not necessarily have reciprocity as we only check for anchors
     //  therefore, we check HitTest both directions A->B & B->A
     // TODO: Check for collision geometry on extended features
-    wxPoint ptA1( aCandidate->GetAnchor( 0 ).x, aCandidate->GetAnchor( 0 ).y );
-    wxPoint ptA2( aCandidate->GetAnchor( 1 ).x, aCandidate->GetAnchor( 1 ).y );
-    wxPoint ptB1( m_item->GetAnchor( 0 ).x, m_item->GetAnchor( 0 ).y );
-    wxPoint ptB2( m_item->GetAnchor( 1 ).x, m_item->GetAnchor( 1 ).y );
-    if( parentA->HitTest( ptB1 ) || parentB->HitTest( ptA1 ) ||
-            ( parentA->Type() == PCB_TRACE_T && parentB->HitTest( ptA2 ) ) ||
-            ( parentB->Type() == PCB_TRACE_T && parentA->HitTest( ptB2 ) ) )
+    auto hitsAnchor = [] ( BOARD_CONNECTED_ITEM* aParent, const CN_ITEM* aItem, int n )
+    {
+        const VECTOR2I& p = aItem->AnchorPos( n );
+        return aParent->HitTest( wxPoint( p.x, p.y ) );
+    };
+
+    if( hitsAnchor( parentA, m_item, 0 ) || hitsAnchor( parentB, aCandidate, 0 ) ||
+            ( parentA->Type() == PCB_TRACE_T && hitsAnchor( parentB, aCandidate, 1 ) ) ||
+            ( parentB->Type() == PCB_TRACE_T && hitsAnchor( parentA, m_item, 1 ) ) )
     {
         m_item->Connect( aCandidate );
         aCandidate->Connect( m_item );
@@ -714,6 +1107,8 @@ void CN_CONNECTIVITY_ALGO::Clear()
 {
     m_ratsnestClusters.clear();
     m_connClusters.clear();
+    m_propagateIndex.Clear();
+    m_ratsnestIndex.Clear();
     m_itemMap.clear();
     m_itemList.Clear();
 
@@ -41,6 +41,8 @@
 #include <functional>
 #include <vector>
 #include <deque>
+#include <unordered_map>
+#include <unordered_set>
 #include <intrusive_list.h>
 
 #include <connectivity/connectivity_rtree.h>
@@ -99,6 +101,93 @@ private:
     bool m_visible = true;
 };
 
+/**
+ * Class CN_INCREMENTAL_CLUSTERS
+ * Maintains the clusters (connected sets of items) found by a cluster search when items
+ * are added to or removed from the connectivity graph, instead of searching all the
+ * items of the board again.
+ *
+ * Added items are merged with the clusters of their neighbours (the items of the smallest
+ * cluster are moved to the largest one, as in a union-find with union by size).
+ * When items are removed, their cluster may be split: a search is started from each of
+ * their neighbours, all searches advancing one item at a time.  Searches which meet are
+ * merged, and a search which runs out of items before meeting the others has found a
+ * separated part of the cluster.  So the work done is proportional to the size of the
+ * split parts, not to the size of the cluster, and is small when the neighbours are still
+ * connected through a short path (e.g. a pad moved on a large ground plane).
+ */
+class CN_INCREMENTAL_CLUSTERS
+{
+public:
+    using CLUSTERS = std::vector<CN_CLUSTER_PTR>;
+
+    /**
+     * @param aWithinNet if true, only items of the same (valid) net are connected, as in
+     *                   CSM_RATSNEST searches.
+     * @param aWithZones if false, zones are not part of the clusters, as in CSM_PROPAGATE
+     *                   searches.
+     */
+    CN_INCREMENTAL_CLUSTERS( bool aWithinNet, bool aWithZones );
+
+    /**
+     * Function Build()
+     * Starts tracking the clusters found by a full search.  Until then, the other calls
+     * do nothing.
+     */
+    void Build( const CLUSTERS& aClusters );
+
+    bool IsBuilt() const { return m_built; }
+
+    void Clear();
+
+    /**
+     * Function AddItems()
+     * Adds items to the clusters.  Their connections must be up to date.
+     */
+    void AddItems( const std::vector<CN_ITEM*>& aItems );
+
+    /**
+     * Function RemoveItems()
+     * Removes items from their cluster, splitting it if needed.  Items which are removed
+     * from the board must still be allocated, and the references to them must have already
+     * been removed from the connections of the valid items.  Items which stay on the board
+     * (e.g. because their net is changed) can be added back afterwards.
+     */
+    void RemoveItems( const std::vector<CN_ITEM*>& aItems );
+
+    /**
+     * Function Clusters()
+     * @return all the clusters, sorted by net.
+     */
+    const CLUSTERS& Clusters();
+
+    /**
+     * Function TakeModifiedClusters()
+     * @return the clusters created or modified since the previous call or the Build().
+     */
+    CLUSTERS TakeModifiedClusters();
+
+private:
+    bool accepts( const CN_ITEM* aItem ) const;
+    bool isMember( const CN_ITEM* aItem, const CN_CLUSTER* aCluster ) const;
+
+    CN_CLUSTER* newCluster();
+    CN_CLUSTER* merge( CN_CLUSTER* aA, CN_CLUSTER* aB );
+    void        split( CN_CLUSTER* aCluster, const std::vector<CN_ITEM*>& aSeeds,
+                       const std::unordered_set<const CN_ITEM*>& aRemoved );
+
+    bool m_withinNet;
+    bool m_withZones;
+    bool m_built;
+    bool m_sorted;
+
+    CLUSTERS                                                m_clusters;
+    std::unordered_set<const CN_CLUSTER*>                   m_dead;
+    std::unordered_set<const CN_CLUSTER*>                   m_modified;
+    std::unordered_map<const CN_ITEM*, CN_CLUSTER*>         m_membership;
+};
+
+
 class CN_CONNECTIVITY_ALGO
 {
 public:
@@ -152,6 +241,11 @@ private:
     std::vector<bool> m_dirtyNets;
     PROGRESS_REPORTER* m_progressReporter = nullptr;
 
+    ///> update the propagation and ratsnest clusters incrementally
+    bool m_incremental;
+    CN_INCREMENTAL_CLUSTERS m_propagateIndex;
+    CN_INCREMENTAL_CLUSTERS m_ratsnestIndex;
+
     void    searchConnections();
 
     void    update();
@@ -170,9 +264,18 @@ private:
 
 public:
 
-    CN_CONNECTIVITY_ALGO() {}
+    CN_CONNECTIVITY_ALGO();
     ~CN_CONNECTIVITY_ALGO() { Clear(); }
 
+    /**
+     * Enables the incremental update of the clusters: after a first full search, the
+     * clusters are updated from the added and removed items only.  The default is given
+     * by the IncrementalConnectivity advanced config option.
+     */
+    void SetIncremental( bool aIncremental );
+
+    bool IsIncremental() const { return m_incremental; }
+
     bool ItemExists( const BOARD_CONNECTED_ITEM* aItem )
     {
         return m_itemMap.find( aItem ) != m_itemMap.end();
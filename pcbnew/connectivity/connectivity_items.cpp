@@ -352,3 +352,20 @@ void CN_CLUSTER::Add( CN_ITEM* item )
         }
     }
 }
+
+
+void CN_CLUSTER::RemoveIf( const std::function<bool( CN_ITEM* )>& aFunc )
+{
+    std::vector<CN_ITEM*> items;
+    items.swap( m_items );
+
+    m_originPad = nullptr;
+    m_originNet = -1;
+    m_conflicting = false;
+
+    for( auto item : items )
+    {
+        if( !aFunc( item ) )
+            Add( item );
+    }
+}
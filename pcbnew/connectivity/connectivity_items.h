@@ -211,6 +211,17 @@ public:
         return m_anchors;
     }
 
+    /**
+     * Function AnchorPos()
+     *
+     * Returns the position of the n-th anchor, as it was when the item was added, without
+     * asking the parent board item like GetAnchor() does.
+     */
+    const VECTOR2I& AnchorPos( int n ) const
+    {
+        return m_anchors[n]->Pos();
+    }
+
     void SetValid( bool aValid )
     {
         m_valid = aValid;
@@ -347,7 +358,7 @@ public:
         return m_subpolyIndex;
     }
 
-    bool ContainsAnchor( const CN_ANCHOR_PTR anchor ) const
+    bool ContainsAnchor( const CN_ANCHOR_PTR& anchor ) const
     {
         return ContainsPoint( anchor->Pos() );
     }
@@ -518,6 +529,14 @@ public:
 
     void Add( CN_ITEM* item );
 
+    /**
+     * Function RemoveIf()
+     * Removes the items for which aFunc returns true, and recomputes the origin pad and net
+     * of the cluster from the remaining ones.  aFunc is called before any other access to
+     * an item, so it can filter out items whose parent is already deleted.
+     */
+    void RemoveIf( const std::function<bool( CN_ITEM* )>& aFunc );
+
     using ITER = decltype(m_items)::iterator;
 
     ITER begin() { return m_items.begin(); };
@@ -27,6 +27,8 @@
  * @file drc.cpp
  */
 
+#include <atomic>
+
 #include <fctsys.h>
 #include <pcb_edit_frame.h>
 #include <trigo.h>
@@ -53,6 +55,7 @@
 #include <pcbnew.h>
 #include <drc.h>
 #include <pcb_netlist.h>
+#include <thread_pool.h>
 
 #include <dialog_drc.h>
 #include <wx/progdlg.h>
@@ -111,15 +114,112 @@ void DRC::addMarkerToPcb( MARKER_PCB* aMarker )
         delete aMarker;
         m_currentMarker = nullptr;
     }
+    else if( m_markerSink )
+    {
+        m_markerSink->push_back( aMarker );
+    }
     else
     {
-        BOARD_COMMIT commit( m_pcbEditorFrame );
-        commit.Add( aMarker );
-        commit.Push( wxEmptyString, false, false );
+        commitMarkerChanges( { aMarker } );
     }
 }
 
 
+void DRC::commitMarkerChanges( const std::vector<MARKER_PCB*>& aAddedMarkers,
+                               const std::vector<MARKER_PCB*>& aRemovedMarkers )
+{
+    if( !m_pcbEditorFrame )
+    {
+        for( MARKER_PCB* marker : aRemovedMarkers )
+            m_pcb->Remove( marker );
+
+        for( MARKER_PCB* marker : aAddedMarkers )
+            m_pcb->Add( marker );
+
+        return;
+    }
+
+    BOARD_COMMIT commit( m_pcbEditorFrame );
+
+    for( MARKER_PCB* marker : aRemovedMarkers )
+        commit.Remove( marker );
+
+    for( MARKER_PCB* marker : aAddedMarkers )
+        commit.Add( marker );
+
+    if( !commit.Empty() )
+        commit.Push( wxEmptyString, false, false );
+}
+
+
+EDA_UNITS_T DRC::getUserUnits() const
+{
+    return m_pcbEditorFrame ? m_pcbEditorFrame->GetUserUnits() : MILLIMETRES;
+}
+
+
+void DRC::runParallel( size_t aCount, const std::function<void( DRC&, size_t )>& aTest,
+                       const std::function<bool( size_t )>& aProgress )
+{
+    if( aCount == 0 )
+        return;
+
+    // D_PAD::GetBoundingRadius() is const but computes the radius on first use: the workers
+    // would write it concurrently.
+    for( D_PAD* pad : m_pcb->GetPads() )
+        pad->GetBoundingRadius();
+
+    // One list of markers per tested item, to add them to the board in item order
+    std::vector<std::vector<MARKER_PCB*>> markers( aCount );
+    std::atomic<size_t> nextItem( 0 );
+    std::atomic<size_t> testedCount( 0 );
+    std::atomic<bool>   aborted( false );
+
+    TASK_GROUP group( *m_threadPool );
+    size_t     parallelThreadCount = std::min( group.GetPool().GetThreadCount(), aCount );
+
+    auto test_lambda = [&]()
+    {
+        std::vector<MARKER_PCB*> sink;
+        DRC                      worker( *this, &sink );
+
+        for( size_t i = nextItem.fetch_add( 1 ); i < aCount; i = nextItem.fetch_add( 1 ) )
+        {
+            if( aborted )
+                break;
+
+            aTest( worker, i );
+
+            markers[i].swap( sink );
+            sink.clear();
+            testedCount++;
+        }
+    };
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        group.Run( test_lambda );
+
+    // The progress dialog can only be updated from the main thread
+    do
+    {
+        if( aProgress && !aborted && !aProgress( testedCount ) )
+            aborted = true;
+    } while( !group.WaitFor( std::chrono::milliseconds( 100 ) ) );
+
+    group.Wait();
+
+    std::vector<MARKER_PCB*> allMarkers;
+
+    for( const std::vector<MARKER_PCB*>& itemMarkers : markers )
+        allMarkers.insert( allMarkers.end(), itemMarkers.begin(), itemMarkers.end() );
+
+    if( m_markerSink )
+        m_markerSink->insert( m_markerSink->end(), allMarkers.begin(), allMarkers.end() );
+    else
+        commitMarkerChanges( allMarkers );
+}
+
+
 void DRC::DestroyDRCDialog( int aReason )
 {
     if( m_drcDialog )
@@ -132,10 +232,18 @@ void DRC::DestroyDRCDialog( int aReason )
 }
 
 
-DRC::DRC( PCB_EDIT_FRAME* aPcbWindow )
+DRC::DRC( PCB_EDIT_FRAME* aPcbWindow ) :
+        DRC( aPcbWindow->GetBoard() )
 {
     m_pcbEditorFrame = aPcbWindow;
-    m_pcb = aPcbWindow->GetBoard();
+    m_markerFactory.SetUnitsProvider( [=]() { return aPcbWindow->GetUserUnits(); } );
+}
+
+
+DRC::DRC( BOARD* aBoard )
+{
+    m_pcbEditorFrame = NULL;
+    m_pcb = aBoard;
     m_drcDialog  = NULL;
 
     // establish initial values for everything:
@@ -155,6 +263,11 @@ DRC::DRC( PCB_EDIT_FRAME* aPcbWindow )
     // m_rptFilename set to empty by its constructor
 
     m_currentMarker = NULL;
+    m_markerSink = nullptr;
+    m_threadPool = &THREAD_POOL::GetInstance();
+    m_incrementalMode = false;
+    m_incrementalItems = nullptr;
+    m_indexChangeCount = 0;
 
     m_segmAngle  = 0;
     m_segmLength = 0;
@@ -163,8 +276,46 @@ DRC::DRC( PCB_EDIT_FRAME* aPcbWindow )
     m_ycliplo = 0;
     m_xcliphi = 0;
     m_ycliphi = 0;
+}
 
-    m_markerFactory.SetUnitsProvider( [=]() { return aPcbWindow->GetUserUnits(); } );
+
+DRC::DRC( const DRC& aParent, std::vector<MARKER_PCB*>* aMarkerSink ) :
+        m_board_outlines( aParent.m_board_outlines ),
+        m_markerFactory( aParent.m_markerFactory ),
+        m_trackIndex( aParent.m_trackIndex ),
+        m_padIndex( aParent.m_padIndex )
+{
+    m_pcbEditorFrame = aParent.m_pcbEditorFrame;
+    m_pcb = aParent.m_pcb;
+    m_drcDialog = NULL;         // workers never touch the UI
+
+    m_drcInLegacyRoutingMode = false;
+    m_doPad2PadTest     = aParent.m_doPad2PadTest;
+    m_doUnconnectedTest = aParent.m_doUnconnectedTest;
+    m_doZonesTest = aParent.m_doZonesTest;
+    m_doKeepoutTest = aParent.m_doKeepoutTest;
+    m_refillZones = aParent.m_refillZones;
+    m_reportAllTrackErrors = aParent.m_reportAllTrackErrors;
+    m_testFootprints = aParent.m_testFootprints;
+
+    m_drcRun = false;
+    m_footprintsTested = false;
+    m_doCreateRptFile = false;
+
+    m_currentMarker = NULL;
+    m_markerSink = aMarkerSink;
+    m_threadPool = aParent.m_threadPool;
+    m_incrementalMode = false;
+    m_incrementalItems = aParent.m_incrementalItems;
+    m_indexChangeCount = aParent.m_indexChangeCount;
+
+    m_segmAngle  = 0;
+    m_segmLength = 0;
+
+    m_xcliplo = 0;
+    m_ycliplo = 0;
+    m_xcliphi = 0;
+    m_ycliphi = 0;
 }
 
 
@@ -182,6 +333,9 @@ int DRC::DrcOnCreatingTrack( TRACK* aRefSegm, TRACK* aList )
 {
     updatePointers();
 
+    // The indexes kept by the incremental DRC are not updated by the legacy router
+    dropStaleIndexes();
+
     // Set right options for this on line drc
     int drc_state = m_drcInLegacyRoutingMode;
     m_drcInLegacyRoutingMode = true;
@@ -288,7 +442,7 @@ int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
                 zone2zoneClearance = 1;
 
             // test for some corners of zoneRef inside zoneToTest
-            for( auto iterator = smoothed_polys[ia].IterateWithHoles(); iterator; iterator++ )
+            for( auto iterator = smoothed_polys[ia].CIterateWithHoles(); iterator; iterator++ )
             {
                 VECTOR2I currentVertex = *iterator;
                 wxPoint pt( currentVertex.x, currentVertex.y );
@@ -304,7 +458,7 @@ int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
             }
 
             // test for some corners of zoneToTest inside zoneRef
-            for( auto iterator = smoothed_polys[ia2].IterateWithHoles(); iterator; iterator++ )
+            for( auto iterator = smoothed_polys[ia2].CIterateWithHoles(); iterator; iterator++ )
             {
                 VECTOR2I currentVertex = *iterator;
                 wxPoint pt( currentVertex.x, currentVertex.y );
@@ -433,6 +587,9 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         return;
     }
 
+    // Build the broad phase used by the pad and track clearance tests
+    buildIndexes();
+
     // test pad to pad clearances, nothing to do with tracks, vias or zones.
     if( m_doPad2PadTest )
     {
@@ -481,6 +638,13 @@ void DRC::RunTests( wxTextCtrl* aMessages )
 
     testTracks( aMessages ? aMessages->GetParent() : m_pcbEditorFrame, true );
 
+    // The incremental DRC keeps the indexes to re-test the items changed later
+    if( !m_incrementalMode )
+    {
+        m_trackIndex.reset();
+        m_padIndex.reset();
+    }
+
     // test zone clearances to other zones
     if( aMessages )
     {
@@ -583,10 +747,31 @@ void DRC::RunTests( wxTextCtrl* aMessages )
 }
 
 
+void DRC::RunClearanceTests()
+{
+    updatePointers();
+
+    testOutline();
+
+    buildIndexes();
+
+    if( m_doPad2PadTest )
+        testPad2Pad();
+
+    testDrilledHoles();
+    testTracks( nullptr, false );
+
+    // The incremental DRC keeps the indexes to re-test the items changed later
+    if( !m_incrementalMode )
+        InvalidateIndexes();
+}
+
+
 void DRC::updatePointers()
 {
     // update my pointers, m_pcbEditorFrame is the only unchangeable one
-    m_pcb = m_pcbEditorFrame->GetBoard();
+    if( m_pcbEditorFrame )
+        m_pcb = m_pcbEditorFrame->GetBoard();
 
     if( m_drcDialog )  // Use diag list boxes only in DRC dialog
     {
@@ -712,45 +897,37 @@ bool DRC::testNetClasses()
 
 void DRC::testPad2Pad()
 {
-    std::vector<D_PAD*> sortedPads;
-
-    m_pcb->GetSortedPadListByXthenYCoord( sortedPads );
-
-    if( sortedPads.size() == 0 )
-        return;
-
-    // find the max size of the pads (used to stop the test)
-    int max_size = 0;
-
-    for( unsigned i = 0; i < sortedPads.size(); ++i )
-    {
-        D_PAD* pad = sortedPads[i];
+    // The pad index stores each pad with its own clearance-inflated box, so only the pads
+    // actually close to a given pad are candidates, whatever the size of the other pads
+    // on the board.
+    const std::vector<D_PAD*> pads = m_pcb->GetPads();
 
-        // GetBoundingRadius() is the radius of the minimum sized circle fully containing the pad
-        int radius = pad->GetBoundingRadius();
+    // Test the pads
+    runParallel( pads.size(),
+            [&]( DRC& aWorker, size_t i )
+            {
+                D_PAD*                             pad = pads[i];
+                std::vector<BOARD_CONNECTED_ITEM*> neighbours;
+                std::vector<D_PAD*>                candidates;
 
-        if( radius > max_size )
-            max_size = radius;
-    }
+                // Each pair is tested once, from the pad inserted first in the index
+                m_padIndex->QueryColliding( pad, neighbours, m_padIndex->Order( pad ) );
 
-    // Upper limit of pad list (limit not included)
-    D_PAD** listEnd = &sortedPads[0] + sortedPads.size();
+                if( neighbours.empty() )
+                    return;
 
-    // Test the pads
-    for( unsigned i = 0; i< sortedPads.size(); ++i )
-    {
-        D_PAD* pad = sortedPads[i];
+                for( BOARD_CONNECTED_ITEM* neighbour : neighbours )
+                    candidates.push_back( static_cast<D_PAD*>( neighbour ) );
 
-        int    x_limit = max_size + pad->GetClearance() +
-                         pad->GetBoundingRadius() + pad->GetPosition().x;
+                D_PAD** listStart = &candidates[0];
 
-        if( !doPadToPadsDrc( pad, &sortedPads[i], listEnd, x_limit ) )
-        {
-            wxASSERT( m_currentMarker );
-            addMarkerToPcb ( m_currentMarker );
-            m_currentMarker = nullptr;
-        }
-    }
+                if( !aWorker.doPadToPadsDrc( pad, listStart, listStart + candidates.size() ) )
+                {
+                    wxASSERT( aWorker.m_currentMarker );
+                    aWorker.addMarkerToPcb( aWorker.m_currentMarker );
+                    aWorker.m_currentMarker = nullptr;
+                }
+            } );
 }
 
 
@@ -802,28 +979,31 @@ void DRC::testDrilledHoles()
         }
     }
 
-    for( size_t ii = 0; ii < holes.size(); ++ii )
-    {
-        const DRILLED_HOLE& refHole = holes[ ii ];
-
-        for( size_t jj = ii + 1; jj < holes.size(); ++jj )
-        {
-            const DRILLED_HOLE& checkHole = holes[ jj ];
-
-            // Holes with identical locations are allowable
-            if( checkHole.m_location == refHole.m_location )
-                continue;
+    EDA_UNITS_T units = getUserUnits();
 
-            if( KiROUND( GetLineLength( checkHole.m_location, refHole.m_location ) )
-                    <  checkHole.m_drillRadius + refHole.m_drillRadius + holeToHoleMin )
+    runParallel( holes.size(),
+            [&]( DRC& aWorker, size_t ii )
             {
-                addMarkerToPcb( new MARKER_PCB( m_pcbEditorFrame->GetUserUnits(),
-                                                DRCE_DRILLED_HOLES_TOO_CLOSE, refHole.m_location,
-                                                refHole.m_owner, refHole.m_location,
-                                                checkHole.m_owner, checkHole.m_location ) );
-            }
-        }
-    }
+                const DRILLED_HOLE& refHole = holes[ ii ];
+
+                for( size_t jj = ii + 1; jj < holes.size(); ++jj )
+                {
+                    const DRILLED_HOLE& checkHole = holes[ jj ];
+
+                    // Holes with identical locations are allowable
+                    if( checkHole.m_location == refHole.m_location )
+                        continue;
+
+                    if( KiROUND( GetLineLength( checkHole.m_location, refHole.m_location ) )
+                            <  checkHole.m_drillRadius + refHole.m_drillRadius + holeToHoleMin )
+                    {
+                        aWorker.addMarkerToPcb( new MARKER_PCB( units,
+                                DRCE_DRILLED_HOLES_TOO_CLOSE, refHole.m_location,
+                                refHole.m_owner, refHole.m_location,
+                                checkHole.m_owner, checkHole.m_location ) );
+                    }
+                }
+            } );
 }
 
 
@@ -849,41 +1029,333 @@ void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
         progressDialog->Update( 0, wxEmptyString );
     }
 
-    int ii = 0;
-    count = 0;
+    std::vector<TRACK*> tracks;
 
     for( TRACK* segm = m_pcb->m_Track; segm; segm = segm->Next() )
+        tracks.push_back( segm );
+
+    auto track_test = [&]( DRC& aWorker, size_t ii )
     {
-        if( ii++ > delta )
-        {
-            ii = 0;
-            count++;
+        TRACK* segm = tracks[ii];
 
-            if( progressDialog )
+        // Test new segment against tracks and pads, optionally against copper zones
+        if( !aWorker.doTrackDrc( segm, segm->Next(), true, m_doZonesTest ) )
+        {
+            if( aWorker.m_currentMarker )
             {
-                if( !progressDialog->Update( count, wxEmptyString ) )
-                    break;  // Aborted by user
+                aWorker.addMarkerToPcb( aWorker.m_currentMarker );
+                aWorker.m_currentMarker = nullptr;
+            }
+        }
+    };
+
+    auto track_progress = [&]( size_t aDone ) -> bool
+    {
+        if( !progressDialog )
+            return true;
+
+        count = aDone / delta;
+
+        if( !progressDialog->Update( std::min( count, deltamax ), wxEmptyString ) )
+            return false;   // Aborted by user
+
 #ifdef __WXMAC__
-                // Work around a dialog z-order issue on OS X
-                if( count == deltamax )
-                    aActiveWindow->Raise();
+        // Work around a dialog z-order issue on OS X
+        if( count == deltamax )
+            aActiveWindow->Raise();
 #endif
+        return true;
+    };
+
+    runParallel( tracks.size(), track_test, track_progress );
+
+    if( progressDialog )
+        progressDialog->Destroy();
+}
+
+
+void DRC::buildIndexes()
+{
+    m_trackIndex = std::make_shared<DRC_RTREE>();
+    m_padIndex = std::make_shared<DRC_RTREE>();
+
+    for( TRACK* segm = m_pcb->m_Track; segm; segm = segm->Next() )
+        m_trackIndex->Insert( segm );
+
+    for( D_PAD* pad : m_pcb->GetPads() )
+        m_padIndex->Insert( pad );
+
+    m_indexChangeCount = m_pcb->GetItemListsChangeCount();
+}
+
+
+void DRC::dropStaleIndexes()
+{
+    if( m_indexChangeCount != m_pcb->GetItemListsChangeCount() )
+        InvalidateIndexes();
+}
+
+
+void DRC::InvalidateIndexes()
+{
+    m_trackIndex.reset();
+    m_padIndex.reset();
+}
+
+
+void DRC::SetIncrementalMode( bool aEnable )
+{
+    m_incrementalMode = aEnable;
+
+    // The indexes are rebuilt from the current board by the next full or incremental run
+    InvalidateIndexes();
+}
+
+
+/**
+ * @return true if markers with the error code aCode are created by the tests
+ * UpdateIncremental() runs, and can therefore be replaced by it.
+ */
+static bool isIncrementalErrorCode( int aCode )
+{
+    switch( aCode )
+    {
+    // doTrackDrc()
+    case DRCE_TRACK_NEAR_THROUGH_HOLE:
+    case DRCE_TRACK_NEAR_PAD:
+    case DRCE_TRACK_NEAR_VIA:
+    case DRCE_VIA_NEAR_VIA:
+    case DRCE_VIA_NEAR_TRACK:
+    case DRCE_TRACK_ENDS1:
+    case DRCE_TRACK_ENDS2:
+    case DRCE_TRACK_ENDS3:
+    case DRCE_TRACK_ENDS4:
+    case DRCE_TRACK_SEGMENTS_TOO_CLOSE:
+    case DRCE_TRACKS_CROSSING:
+    case DRCE_ENDS_PROBLEM1:
+    case DRCE_ENDS_PROBLEM2:
+    case DRCE_ENDS_PROBLEM3:
+    case DRCE_ENDS_PROBLEM4:
+    case DRCE_ENDS_PROBLEM5:
+    case DRCE_VIA_HOLE_BIGGER:
+    case DRCE_MICRO_VIA_INCORRECT_LAYER_PAIR:
+    case DRCE_TOO_SMALL_TRACK_WIDTH:
+    case DRCE_TOO_SMALL_VIA:
+    case DRCE_TOO_SMALL_MICROVIA:
+    case DRCE_TOO_SMALL_VIA_DRILL:
+    case DRCE_TOO_SMALL_MICROVIA_DRILL:
+    case DRCE_TRACK_NEAR_ZONE:
+    case DRCE_MICRO_VIA_NOT_ALLOWED:
+    case DRCE_BURIED_VIA_NOT_ALLOWED:
+    case DRCE_TRACK_NEAR_EDGE:
+    // doTrackKeepoutDrc()
+    case DRCE_VIA_INSIDE_KEEPOUT:
+    case DRCE_TRACK_INSIDE_KEEPOUT:
+    // doPadToPadsDrc()
+    case DRCE_PAD_NEAR_PAD1:
+    case DRCE_HOLE_NEAR_PAD:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+
+void DRC::UpdateIncremental( const std::vector<BOARD_ITEM*>& aChangedItems,
+                             const std::vector<BOARD_ITEM*>& aRemovedItems,
+                             unsigned aChangeCount )
+{
+    if( !m_incrementalMode || m_drcInLegacyRoutingMode )
+        return;
+
+    if( m_pcbEditorFrame )
+        m_pcb = m_pcbEditorFrame->GetBoard();
+
+    // Items added or removed outside of a commit are unknown to the indexes, which may
+    // even refer to deleted items: they are rebuilt from the board below.
+    if( m_indexChangeCount != aChangeCount )
+        InvalidateIndexes();
+
+    std::vector<TRACK*>                       tracks;
+    std::vector<D_PAD*>                       pads;
+    std::unordered_set<const BOARD_ITEM*>     staleItems;   // items whose markers are replaced
+    std::vector<const BOARD_CONNECTED_ITEM*>  formerPads;
+
+    std::function<void( BOARD_ITEM*, bool )> collect = [&]( BOARD_ITEM* aItem, bool aRemoved )
+    {
+        switch( aItem->Type() )
+        {
+        case PCB_TRACE_T:
+        case PCB_VIA_T:
+            staleItems.insert( aItem );
+
+            if( !aRemoved )
+                tracks.push_back( static_cast<TRACK*>( aItem ) );
+
+            break;
+
+        case PCB_PAD_T:
+            staleItems.insert( aItem );
+
+            if( !aRemoved )
+                pads.push_back( static_cast<D_PAD*>( aItem ) );
+
+            break;
+
+        case PCB_MODULE_T:
+            // The indexed pads of the footprint, including the ones it does not have anymore
+            if( m_padIndex )
+            {
+                formerPads.clear();
+                m_padIndex->RemoveChildren( aItem, formerPads );
+                staleItems.insert( formerPads.begin(), formerPads.end() );
             }
+
+            for( D_PAD* pad : static_cast<MODULE*>( aItem )->Pads() )
+                collect( pad, aRemoved );
+
+            break;
+
+        default:
+            break;
         }
+    };
 
-        // Test new segment against tracks and pads, optionally against copper zones
-        if( !doTrackDrc( segm, segm->Next(), true, m_doZonesTest ) )
+    for( BOARD_ITEM* item : aRemovedItems )
+        collect( item, true );
+
+    for( BOARD_ITEM* item : aChangedItems )
+        collect( item, false );
+
+    if( staleItems.empty() )
+    {
+        // Nothing indexed was changed by the commit
+        if( m_trackIndex && m_padIndex )
+            m_indexChangeCount = m_pcb->GetItemListsChangeCount();
+
+        return;
+    }
+
+    if( !m_trackIndex || !m_padIndex )
+    {
+        buildIndexes();
+    }
+    else
+    {
+        // Update the indexes.  Removal only uses the box and layers the items were inserted
+        // with, as the items may have been moved since.
+        for( const BOARD_ITEM* item : staleItems )
         {
-            if( m_currentMarker )
+            auto connectedItem = static_cast<const BOARD_CONNECTED_ITEM*>( item );
+
+            m_padIndex->Remove( connectedItem );
+            m_trackIndex->Remove( connectedItem );
+        }
+
+        for( TRACK* track : tracks )
+            m_trackIndex->Insert( track );
+
+        for( D_PAD* pad : pads )
+            m_padIndex->Insert( pad );
+
+        m_indexChangeCount = m_pcb->GetItemListsChangeCount();
+    }
+
+    // Tracks close to a changed pad must be re-tested against it
+    std::vector<BOARD_CONNECTED_ITEM*> neighbours;
+
+    for( D_PAD* pad : pads )
+    {
+        m_trackIndex->Query( DRC_RTREE::ItemBox( pad ), DRC_RTREE::ItemLayers( pad ), neighbours );
+
+        for( BOARD_CONNECTED_ITEM* neighbour : neighbours )
+        {
+            if( staleItems.insert( neighbour ).second )
+                tracks.push_back( static_cast<TRACK*>( neighbour ) );
+        }
+    }
+
+    std::vector<MARKER_PCB*> staleMarkers;
+
+    for( MARKER_PCB* marker : m_pcb->m_markers )
+    {
+        const DRC_ITEM& drcItem = marker->GetReporter();
+
+        if( !isIncrementalErrorCode( drcItem.GetErrorCode() ) )
+            continue;
+
+        if( staleItems.count( static_cast<const BOARD_ITEM*>( drcItem.GetMainItemWeakRef() ) )
+                || staleItems.count(
+                        static_cast<const BOARD_ITEM*>( drcItem.GetAuxItemWeakRef() ) ) )
+        {
+            staleMarkers.push_back( marker );
+        }
+    }
+
+    // Re-test the items.  The markers are collected, then committed with the removals.
+    std::vector<MARKER_PCB*> newMarkers;
+
+    m_markerSink = &newMarkers;
+    m_incrementalItems = &staleItems;
+
+    for( TRACK* track : tracks )
+    {
+        if( !doTrackDrc( track, track->Next(), true, m_doZonesTest ) && m_currentMarker )
+        {
+            addMarkerToPcb( m_currentMarker );
+            m_currentMarker = nullptr;
+        }
+
+        if( m_doKeepoutTest && !doTrackKeepoutDrc( track ) )
+        {
+            addMarkerToPcb( m_currentMarker );
+            m_currentMarker = nullptr;
+        }
+    }
+
+    if( m_doPad2PadTest )
+    {
+        std::vector<D_PAD*> padNeighbours;
+
+        for( D_PAD* pad : pads )
+        {
+            int padOrder = m_padIndex->Order( pad );
+
+            m_padIndex->QueryColliding( pad, neighbours );
+            padNeighbours.clear();
+
+            // Pairs of re-tested pads are tested from the lower order one only
+            for( BOARD_CONNECTED_ITEM* neighbour : neighbours )
+            {
+                if( !staleItems.count( neighbour ) || m_padIndex->Order( neighbour ) > padOrder )
+                    padNeighbours.push_back( static_cast<D_PAD*>( neighbour ) );
+            }
+
+            if( padNeighbours.empty() )
+                continue;
+
+            D_PAD** listStart = &padNeighbours[0];
+
+            if( !doPadToPadsDrc( pad, listStart, listStart + padNeighbours.size() ) )
             {
-                addMarkerToPcb ( m_currentMarker );
+                wxASSERT( m_currentMarker );
+                addMarkerToPcb( m_currentMarker );
                 m_currentMarker = nullptr;
             }
         }
     }
 
-    if( progressDialog )
-        progressDialog->Destroy();
+    m_markerSink = nullptr;
+    m_incrementalItems = nullptr;
+
+    commitMarkerChanges( newMarkers, staleMarkers );
+
+    // Markers removed without undo entry are not owned by anyone anymore
+    for( MARKER_PCB* marker : staleMarkers )
+        delete marker;
+
+    updatePointers();
 }
 
 
@@ -1333,7 +1805,7 @@ bool DRC::doTrackKeepoutDrc( TRACK* aRefSeg )
 }
 
 
-bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_limit )
+bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd )
 {
     const static LSET all_cu = LSET::AllCuMask();
 
@@ -1363,11 +1835,6 @@ bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_li
         if( pad == aRefPad )
             continue;
 
-        // We can stop the test when pad->GetPosition().x > x_limit
-        // because the list is sorted by X values
-        if( pad->GetPosition().x > x_limit )
-            break;
-
         // No problem if pads which are on copper layers are on different copper layers,
         // (pads can be only on a technical layer, to build complex pads)
         // but their hole (if any ) can create DRC error because they are on all
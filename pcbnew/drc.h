@@ -31,10 +31,13 @@
 
 #include <vector>
 #include <memory>
+#include <functional>
+#include <unordered_set>
 #include <geometry/seg.h>
 #include <geometry/shape_poly_set.h>
 
 #include <drc/drc_marker_factory.h>
+#include <drc/drc_rtree.h>
 
 #define OK_DRC  0
 #define BAD_DRC 1
@@ -114,6 +117,7 @@
 
 class EDA_DRAW_PANEL;
 class PCB_EDIT_FRAME;
+class THREAD_POOL;
 class DIALOG_DRC_CONTROL;
 class BOARD_ITEM;
 class BOARD;
@@ -236,12 +240,36 @@ private:
     int                 m_xcliphi;
     int                 m_ycliphi;
 
-    PCB_EDIT_FRAME*     m_pcbEditorFrame;   ///< The pcb frame editor which owns the board
+    PCB_EDIT_FRAME*     m_pcbEditorFrame;   ///< The pcb frame editor which owns the board, or NULL
     BOARD*              m_pcb;
     SHAPE_POLY_SET      m_board_outlines;   ///< The board outline including cutouts
     DIALOG_DRC_CONTROL* m_drcDialog;
     DRC_MARKER_FACTORY  m_markerFactory; ///< Class that generates markers
 
+    ///< Tracks and vias, in m_Track order (built by RunTests, shared with the workers)
+    std::shared_ptr<DRC_RTREE> m_trackIndex;
+    ///< Pads, in GetPads() order (built by RunTests, shared with the workers)
+    std::shared_ptr<DRC_RTREE> m_padIndex;
+    ///< BOARD::GetItemListsChangeCount() when the indexes were last in sync with the board
+    unsigned                   m_indexChangeCount;
+
+    /**
+     * When not NULL, new markers are stored here instead of being added to the board.
+     * This is the case of the worker copies used by runParallel().
+     */
+    std::vector<MARKER_PCB*>* m_markerSink;
+
+    THREAD_POOL*        m_threadPool;       ///< the pool running the tests of runParallel()
+
+    bool                m_incrementalMode;  ///< keep the indexes and re-test committed items
+
+    /**
+     * The items re-tested by UpdateIncremental(), NULL otherwise.  In incremental mode,
+     * items are tested against all their neighbours, except the re-tested items with a
+     * lower order, so each pair is only tested once.
+     */
+    const std::unordered_set<const BOARD_ITEM*>* m_incrementalItems;
+
     DRC_LIST            m_unconnected;      ///< list of unconnected pads, as DRC_ITEMs
     DRC_LIST            m_footprints;       ///< list of footprint warnings, as DRC_ITEMs
     bool                m_drcRun;
@@ -255,9 +283,46 @@ private:
 
     /**
      * Adds a DRC marker to the PCB through the COMMIT mechanism.
+     * (or to m_markerSink in a worker copy)
      */
     void addMarkerToPcb( MARKER_PCB* aMarker );
 
+    /**
+     * Add aAddedMarkers to the board and remove aRemovedMarkers from it, through a commit
+     * without undo entry, or directly when there is no editor frame.
+     * The removed markers are not deleted.
+     */
+    void commitMarkerChanges( const std::vector<MARKER_PCB*>& aAddedMarkers,
+                              const std::vector<MARKER_PCB*>& aRemovedMarkers = {} );
+
+    /**
+     * @return the units of the editor frame, or millimetres without editor frame.
+     */
+    EDA_UNITS_T getUserUnits() const;
+
+    /**
+     * Creates a worker copy of aParent: same settings, board and indexes, but its own
+     * scratch data, so it can run the single item tests in a sub-thread.
+     * Markers are collected in aMarkerSink instead of being added to the board.
+     */
+    DRC( const DRC& aParent, std::vector<MARKER_PCB*>* aMarkerSink );
+
+    /**
+     * Run aTest( worker, index ) for each index in [0, aCount) on m_threadPool.
+     *
+     * Each thread uses its own worker copy of this DRC.  Once all items are tested,
+     * the markers are added to the board in index order, so the result does not depend
+     * on the thread scheduling.
+     * The caches the board items fill on first use are filled before the workers start.
+     *
+     * @param aCount is the number of items to test.
+     * @param aTest is the single item test.  It must only use the worker it is given.
+     * @param aProgress if not empty, is called periodically from the calling thread with
+     *                  the count of tested items.  Returning false aborts the test.
+     */
+    void runParallel( size_t aCount, const std::function<void( DRC&, size_t )>& aTest,
+                      const std::function<bool( size_t )>& aProgress = nullptr );
+
     //-----<categorical group tests>-----------------------------------------
 
     /**
@@ -271,9 +336,22 @@ private:
      */
     bool testNetClasses();
 
+    /**
+     * (Re)build m_trackIndex and m_padIndex from the current board.
+     */
+    void buildIndexes();
+
+    /**
+     * Drop m_trackIndex and m_padIndex if tracks, vias or footprints were added to or
+     * removed from the board since they were last updated.
+     */
+    void dropStaleIndexes();
+
     /**
      * Perform the DRC on all tracks.
      *
+     * Uses m_trackIndex and m_padIndex (built by RunTests()), so each segment is only
+     * compared to the items close to it.
      * This test can take a while, a progress bar can be displayed
      * @param aActiveWindow = the active window ued as parent for the progress bar
      * @param aShowProgressBar = true to show a progress bar
@@ -281,6 +359,12 @@ private:
      */
     void testTracks( wxWindow * aActiveWindow, bool aShowProgressBar );
 
+    /**
+     * Test the clearance between all pads.
+     *
+     * Each pad is only compared to the pads whose clearance area overlaps its own in
+     * m_padIndex, and the pads are tested in parallel.
+     */
     void testPad2Pad();
 
     void testDrilledHoles();
@@ -313,22 +397,23 @@ private:
     /**
      * Test the clearance between aRefPad and other pads.
      *
-     * The pad list must be sorted by x coordinate.
+     * The pad list is usually the candidates found in m_padIndex for aRefPad.
      *
      * @param aRefPad is the pad to test
      * @param aStart is the first pad of the list to test against aRefPad
      * @param aEnd is the end of the list and is not included
-     * @param x_limit is used to stop the test
-     * (i.e. when the current pad pos X in list exceeds this limit, because the list
-     * is sorted by X coordinate)
      */
-    bool doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_limit );
+    bool doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd );
 
     /**
      * Test the current segment.
      *
      * @param aRefSeg The segment to test
-     * @param aStart the first item of track list to test against (usually BOARD::m_Track)
+     * @param aStart the first item of track list to test against (usually BOARD::m_Track).
+     * If aStart is aRefSeg->Next() and the track index is built, only the following
+     * segments found by the index are tested.  In incremental mode, all the neighbours
+     * found by the index are tested.  Pads are looked up in the pad index
+     * when it is built.
      * @param aTestPads true if should do pads test
      * @param aTestZones true if should do copper zones test. This can be very time consumming
      * @return bool - true if no problems, else false and m_currentMarker is
@@ -420,6 +505,13 @@ private:
 public:
     DRC( PCB_EDIT_FRAME* aPcbWindow );
 
+    /**
+     * Creates a DRC without editor frame (used by the unit tests).  The markers are added
+     * to aBoard directly, without undo, and only the tests which do not need the editor
+     * can be run: see RunClearanceTests() and UpdateIncremental().
+     */
+    DRC( BOARD* aBoard );
+
     ~DRC();
 
     /**
@@ -498,6 +590,58 @@ public:
      */
     void RunTests( wxTextCtrl* aMessages = NULL );
 
+    /**
+     * Run the clearance tests of RunTests() which do not need the editor: pad to pad
+     * (if enabled), drilled holes and track clearances.  The zone fills are not checked.
+     */
+    void RunClearanceTests();
+
+    /**
+     * Set the thread pool running the parallel tests (THREAD_POOL::GetInstance() by
+     * default).  A pool with a single thread runs the tests one item after the other.
+     */
+    void SetThreadPool( THREAD_POOL& aPool ) { m_threadPool = &aPool; }
+
+    /**
+     * Enable or disable the incremental DRC.  When enabled, the track and pad indexes
+     * built by RunTests() are kept and updated by UpdateIncremental().
+     * The current indexes are dropped in both cases.
+     */
+    void SetIncrementalMode( bool aEnable );
+
+    bool IsIncrementalMode() const { return m_incrementalMode; }
+
+    /**
+     * Drop the track and pad indexes kept by the incremental DRC.  They are rebuilt from
+     * the board by the next full or incremental run.
+     *
+     * Items added or removed outside of a BOARD_COMMIT are detected by UpdateIncremental(),
+     * but this must be called when the board is replaced, and when items are changed in
+     * place without a commit (undo/redo, legacy tools).
+     */
+    void InvalidateIndexes();
+
+    /**
+     * Re-test only the items changed by a commit (usually called by BOARD_COMMIT::Push).
+     *
+     * The changed tracks, vias and pads (including the pads of changed footprints) and
+     * the tracks near changed pads are re-tested against their neighbours found in the
+     * persistent indexes, for the track clearance, keepout and pad to pad tests.  The
+     * markers of these tests referring to the re-tested or removed items are replaced.
+     * Other tests (zones, courtyards, holes...) still require a full RunTests().
+     *
+     * Does nothing if the incremental mode is disabled.  The indexes are rebuilt instead
+     * of updated if the board tracks or footprints were changed outside of the commit.
+     *
+     * @param aChangedItems are the items added or modified by the commit.
+     * @param aRemovedItems are the items removed by the commit.  They must still be alive:
+     *                      their type is read, and so are the pads of removed footprints.
+     * @param aChangeCount is BOARD::GetItemListsChangeCount() before the commit.
+     */
+    void UpdateIncremental( const std::vector<BOARD_ITEM*>& aChangedItems,
+                            const std::vector<BOARD_ITEM*>& aRemovedItems,
+                            unsigned aChangeCount );
+
     /**
      * @return a pointer to the current marker (last created marker
      */
@@ -0,0 +1,208 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+
+#include <class_pad.h>
+#include <class_track.h>
+
+#include <drc/drc_rtree.h>
+
+
+DRC_RTREE::DRC_RTREE()
+{
+    for( auto& tree : m_trees )
+        tree.reset( new TREE() );
+}
+
+
+DRC_RTREE::~DRC_RTREE()
+{
+}
+
+
+EDA_RECT DRC_RTREE::ItemBox( const BOARD_CONNECTED_ITEM* aItem )
+{
+    EDA_RECT box = aItem->GetBoundingBox();
+
+    if( aItem->Type() == PCB_PAD_T )
+    {
+        const D_PAD* pad = static_cast<const D_PAD*>( aItem );
+
+        if( pad->GetDrillSize().x > 0 )
+        {
+            // The drill hole is centered on the pad position, not on its shape position,
+            // and a pad can have a hole on layers it has no copper on.
+            EDA_RECT hole( pad->GetPosition(), wxSize( 0, 0 ) );
+            int      radius = std::max( pad->GetDrillSize().x, pad->GetDrillSize().y ) / 2 + 1;
+
+            hole.Inflate( radius );
+            box.Merge( hole );
+        }
+    }
+
+    box.Normalize();
+    box.Inflate( aItem->GetClearance() );
+
+    return box;
+}
+
+
+LSET DRC_RTREE::ItemLayers( const BOARD_CONNECTED_ITEM* aItem )
+{
+    if( aItem->Type() == PCB_PAD_T
+            && static_cast<const D_PAD*>( aItem )->GetDrillSize().x > 0 )
+        return LSET::AllCuMask();
+
+    return aItem->GetLayerSet() & LSET::AllCuMask();
+}
+
+
+void DRC_RTREE::Insert( BOARD_CONNECTED_ITEM* aItem )
+{
+    if( m_order.count( aItem ) )
+        return;
+
+    const int      order = (int) m_items.size();
+    const EDA_RECT box = ItemBox( aItem );
+    const LSET     layers = ItemLayers( aItem );
+    const int      mmin[2] = { box.GetX(), box.GetY() };
+    const int      mmax[2] = { box.GetRight(), box.GetBottom() };
+
+    m_items.push_back( { aItem, box, layers } );
+    m_order[ aItem ] = order;
+
+    if( aItem->Type() == PCB_PAD_T && aItem->GetParent() )
+        m_children[ aItem->GetParent() ].push_back( order );
+
+    for( PCB_LAYER_ID layer : layers.Seq() )
+        m_trees[ layer ]->Insert( mmin, mmax, order );
+}
+
+
+void DRC_RTREE::Remove( const BOARD_CONNECTED_ITEM* aItem )
+{
+    auto it = m_order.find( aItem );
+
+    if( it == m_order.end() )
+        return;
+
+    ENTRY&    entry = m_items[ it->second ];
+    const int mmin[2] = { entry.m_box.GetX(), entry.m_box.GetY() };
+    const int mmax[2] = { entry.m_box.GetRight(), entry.m_box.GetBottom() };
+
+    for( PCB_LAYER_ID layer : entry.m_layers.Seq() )
+        m_trees[ layer ]->Remove( mmin, mmax, it->second );
+
+    entry.m_item = nullptr;
+    m_order.erase( it );
+}
+
+
+void DRC_RTREE::RemoveChildren( const BOARD_ITEM* aParent,
+                                std::vector<const BOARD_CONNECTED_ITEM*>& aRemoved )
+{
+    auto it = m_children.find( aParent );
+
+    if( it == m_children.end() )
+        return;
+
+    for( int order : it->second )
+    {
+        // Children removed on their own since have no item anymore
+        if( const BOARD_CONNECTED_ITEM* item = m_items[ order ].m_item )
+        {
+            aRemoved.push_back( item );
+            Remove( item );
+        }
+    }
+
+    m_children.erase( it );
+}
+
+
+void DRC_RTREE::Clear()
+{
+    for( auto& tree : m_trees )
+        tree->RemoveAll();
+
+    m_items.clear();
+    m_order.clear();
+    m_children.clear();
+}
+
+
+int DRC_RTREE::Order( const BOARD_CONNECTED_ITEM* aItem ) const
+{
+    auto it = m_order.find( aItem );
+
+    return it == m_order.end() ? -1 : it->second;
+}
+
+
+void DRC_RTREE::Query( const EDA_RECT& aBox, LSET aLayers,
+                       std::vector<BOARD_CONNECTED_ITEM*>& aResult, int aMinOrder ) const
+{
+    const int mmin[2] = { aBox.GetX(), aBox.GetY() };
+    const int mmax[2] = { aBox.GetRight(), aBox.GetBottom() };
+
+    std::vector<int> found;
+
+    auto visitor = [&]( const int& aOrder ) -> bool
+    {
+        if( aOrder > aMinOrder )
+            found.push_back( aOrder );
+
+        return true;
+    };
+
+    LSEQ layers = ( aLayers & LSET::AllCuMask() ).Seq();
+
+    for( PCB_LAYER_ID layer : layers )
+        m_trees[ layer ]->Search( mmin, mmax, visitor );
+
+    std::sort( found.begin(), found.end() );
+
+    // Items spanning several layers (vias, through hole pads) are found once per layer
+    if( layers.size() > 1 )
+        found.erase( std::unique( found.begin(), found.end() ), found.end() );
+
+    aResult.clear();
+    aResult.reserve( found.size() );
+
+    for( int order : found )
+    {
+        if( m_items[ order ].m_item )
+            aResult.push_back( m_items[ order ].m_item );
+    }
+}
+
+
+void DRC_RTREE::QueryColliding( const BOARD_CONNECTED_ITEM* aRefItem,
+                                std::vector<BOARD_CONNECTED_ITEM*>& aResult,
+                                int aMinOrder ) const
+{
+    Query( ItemBox( aRefItem ), ItemLayers( aRefItem ), aResult, aMinOrder );
+
+    aResult.erase( std::remove( aResult.begin(), aResult.end(), aRefItem ), aResult.end() );
+}
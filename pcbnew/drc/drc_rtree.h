@@ -0,0 +1,155 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DRC_RTREE__H
+#define DRC_RTREE__H
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <eda_rect.h>
+#include <layers_id_colors_and_visibility.h>
+#include <geometry/rtree.h>
+
+class BOARD_CONNECTED_ITEM;
+class BOARD_ITEM;
+
+
+/**
+ * Class DRC_RTREE
+ * Implements a per-copper-layer R-tree of board connected items (tracks, vias, pads)
+ * used as a broad phase for the clearance tests.
+ *
+ * Each item is stored with its bounding box inflated by its own clearance (and, for
+ * pads, merged with the drill hole), so two items can only violate clearance if their
+ * stored boxes overlap.  Items also remember their insertion order, so callers can
+ * restrict a query to the items following a given one and get candidates in a
+ * deterministic order.
+ * Non-owning.
+ */
+class DRC_RTREE
+{
+public:
+    DRC_RTREE();
+    ~DRC_RTREE();
+
+    /**
+     * Function Insert()
+     * Adds an item to the index.  Its order is the number of items inserted before it
+     * (removed items included).
+     */
+    void Insert( BOARD_CONNECTED_ITEM* aItem );
+
+    /**
+     * Function Remove()
+     * Removes an item from the index, using the box and layers it was inserted with, so
+     * the item may have been moved or even deleted since.  Does nothing if aItem is not
+     * indexed.  The order of the other items is not changed.
+     */
+    void Remove( const BOARD_CONNECTED_ITEM* aItem );
+
+    /**
+     * Function RemoveChildren()
+     * Removes the items inserted as children of aParent (the pads of a footprint), without
+     * dereferencing them, so the pads deleted from a footprint since are removed too.
+     * @param aRemoved receives the removed items.
+     */
+    void RemoveChildren( const BOARD_ITEM* aParent,
+                         std::vector<const BOARD_CONNECTED_ITEM*>& aRemoved );
+
+    /**
+     * Function Clear()
+     * Removes all items from the index.
+     */
+    void Clear();
+
+    /**
+     * Function Order()
+     * @return the insertion order of aItem, or -1 if aItem is not indexed.
+     */
+    int Order( const BOARD_CONNECTED_ITEM* aItem ) const;
+
+    /**
+     * Function GetCount()
+     * @return the number of items in the index.
+     */
+    int GetCount() const { return (int) m_order.size(); }
+
+    /**
+     * Function QueryColliding()
+     * Collects the items whose stored box overlaps the clearance-inflated box of aRefItem
+     * on at least one of the copper layers of aRefItem.
+     *
+     * @param aRefItem is the item to find neighbours for.  It is never returned.
+     * @param aResult receives the candidates, sorted by insertion order.
+     * @param aMinOrder if >= 0, only items whose insertion order is greater than aMinOrder
+     *                  are returned.
+     */
+    void QueryColliding( const BOARD_CONNECTED_ITEM* aRefItem,
+                         std::vector<BOARD_CONNECTED_ITEM*>& aResult,
+                         int aMinOrder = -1 ) const;
+
+    /**
+     * Function Query()
+     * Collects the items whose stored box overlaps aBox on at least one layer of aLayers.
+     * @param aResult receives the items, sorted by insertion order.
+     */
+    void Query( const EDA_RECT& aBox, LSET aLayers,
+                std::vector<BOARD_CONNECTED_ITEM*>& aResult, int aMinOrder = -1 ) const;
+
+    /**
+     * Function ItemBox()
+     * @return the box used to index aItem: its bounding box inflated by its clearance
+     * (merged with its drill hole for pads).
+     */
+    static EDA_RECT ItemBox( const BOARD_CONNECTED_ITEM* aItem );
+
+    /**
+     * Function ItemLayers()
+     * @return the copper layers on which aItem can collide.  Drilled pads collide on
+     * all copper layers because of their hole.  Pads with neither copper layers nor a hole
+     * have none: they are indexed (so Order() and Remove() work) but never returned by the
+     * queries, as the DRC never reports them.
+     */
+    static LSET ItemLayers( const BOARD_CONNECTED_ITEM* aItem );
+
+private:
+    typedef RTree<int, int, 2, double> TREE;
+
+    struct ENTRY
+    {
+        BOARD_CONNECTED_ITEM* m_item;       ///< NULL once removed
+        EDA_RECT              m_box;        ///< box the item was inserted with
+        LSET                  m_layers;     ///< layers the item was inserted on
+    };
+
+    std::array<std::unique_ptr<TREE>, MAX_CU_LAYERS>        m_trees;
+    std::vector<ENTRY>                                      m_items;
+    std::unordered_map<const BOARD_CONNECTED_ITEM*, int>    m_order;
+    std::unordered_map<const BOARD_ITEM*, std::vector<int>> m_children;  ///< pad orders by footprint
+};
+
+
+#endif // DRC_RTREE__H
@@ -46,7 +46,6 @@
 #include <math_for_graphics.h>
 #include <polygon_test_point_inside.h>
 #include <convert_basic_shapes_to_polygon.h>
-#include <board_commit.h>
 
 
 /* compare 2 convex polygons and return true if distance > aDist
@@ -137,7 +136,6 @@ bool convex2pointDRC( wxPoint* aTref, int aTrefCount, wxPoint aPcompare, int aDi
 
 bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool aTestPads, bool aTestZones )
 {
-    TRACK*    track;
     wxPoint   delta;           // length on X and Y axis of segments
     LSET layerMask;
     int       net_code_ref;
@@ -158,14 +156,15 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool aTestPads, bool aTestZ
                 markers.pop_back();
             }
         }
+        else if( m_markerSink )
+        {
+            m_markerSink->insert( m_markerSink->end(), markers.begin(), markers.end() );
+            markers.clear();
+        }
         else
         {
-            BOARD_COMMIT commit( m_pcbEditorFrame );
-
-            for( auto marker : markers )
-                commit.Add( marker );
-
-            commit.Push( wxEmptyString, false, false );
+            commitMarkerChanges( markers );
+            markers.clear();
         }
     };
 
@@ -356,13 +355,25 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool aTestPads, bool aTestZ
     // Compute the min distance to pads
     if( aTestPads )
     {
-        unsigned pad_count = m_pcb->GetPadCount();
+        std::vector<D_PAD*> pads;
 
-        auto pads = m_pcb->GetPads();
+        // When the DRC run has built the spatial index, only test the pads which
+        // can be close enough to the reference segment
+        if( m_padIndex )
+        {
+            std::vector<BOARD_CONNECTED_ITEM*> candidates;
+            m_padIndex->QueryColliding( aRefSeg, candidates );
 
-        for( unsigned ii = 0; ii < pad_count; ++ii )
+            for( BOARD_CONNECTED_ITEM* candidate : candidates )
+                pads.push_back( static_cast<D_PAD*>( candidate ) );
+        }
+        else
+        {
+            pads = m_pcb->GetPads();
+        }
+
+        for( D_PAD* pad : pads )
         {
-            D_PAD* pad = pads[ii];
             SEG padSeg( pad->GetPosition(), pad->GetPosition() );
 
 
@@ -431,7 +442,34 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool aTestPads, bool aTestZ
     wxPoint segStartPoint;
     wxPoint segEndPoint;
 
-    for( track = aStart; track; track = track->Next() )
+    std::vector<TRACK*> tracks;
+    int refOrder = m_trackIndex ? m_trackIndex->Order( aRefSeg ) : -1;
+
+    if( refOrder >= 0 && ( m_incrementalItems || aStart == aRefSeg->Next() ) )
+    {
+        // Broad phase: only the segments following aRefSeg in the track list (like the
+        // plain list walk below) and whose clearance area overlaps aRefSeg's one.
+        // The incremental DRC tests all the neighbours, but each pair of re-tested
+        // segments only once.
+        std::vector<BOARD_CONNECTED_ITEM*> candidates;
+        m_trackIndex->QueryColliding( aRefSeg, candidates, m_incrementalItems ? -1 : refOrder );
+
+        for( BOARD_CONNECTED_ITEM* candidate : candidates )
+        {
+            if( m_incrementalItems && m_incrementalItems->count( candidate )
+                    && m_trackIndex->Order( candidate ) < refOrder )
+                continue;
+
+            tracks.push_back( static_cast<TRACK*>( candidate ) );
+        }
+    }
+    else
+    {
+        for( TRACK* track = aStart; track; track = track->Next() )
+            tracks.push_back( track );
+    }
+
+    for( TRACK* track : tracks )
     {
         // No problem if segments have the same net code:
         if( net_code_ref == track->GetNetCode() )
@@ -797,7 +835,7 @@ bool DRC::doEdgeZoneDrc( ZONE_CONTAINER* aArea, int aCornerIndex )
 
     // Retrieve the selected contour
     SHAPE_LINE_CHAIN contour;
-    contour = aArea->Outline()->Polygon( index.m_polygon )[index.m_contour];
+    contour = aArea->Outline()->CPolygon( index.m_polygon )[index.m_contour];
 
     // Retrieve the segment that starts at aCornerIndex-th corner.
     SEG selectedSegment = contour.Segment( index.m_vertex );
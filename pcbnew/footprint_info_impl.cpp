@@ -34,13 +34,17 @@
 #include <lib_id.h>
 #include <macros.h>
 #include <make_unique.h>
+#include <md5_hash.h>
 #include <pgm_base.h>
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
 
-#include <thread>
+#include <algorithm>
 #include <mutex>
 
+#include <wx/filename.h>
+#include <wx/textfile.h>
+
 
 void FOOTPRINT_INFO_IMPL::load()
 {
@@ -104,6 +108,10 @@ void FOOTPRINT_LIST_IMPL::loader_job()
     while( m_queue_in.pop( nickname ) && !m_cancelled )
     {
         CatchErrors( [this, &nickname]() {
+            // Only the libraries which changed since their index was written are parsed
+            if( readLibraryIndex( nickname ) )
+                return;
+
             m_lib_table->PrefetchLib( nickname );
             m_queue_out.push( nickname );
         } );
@@ -184,9 +192,18 @@ void FOOTPRINT_LIST_IMPL::StartWorkers( FP_LIB_TABLE* aTable, wxString const* aN
     m_count_finished.store( 0 );
     m_errors.clear();
     m_list.clear();
-    m_threads.clear();
     m_queue_in.clear();
     m_queue_out.clear();
+    m_queue_indexed.clear();
+
+    if( m_index_dir.IsEmpty() )
+    {
+        wxFileName indexDir( GetKicadConfigPath(), wxEmptyString );
+        indexDir.AppendDir( wxT( "fp-info-index" ) );
+
+        if( indexDir.DirExists() || indexDir.Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL ) )
+            m_index_dir = indexDir.GetPath();
+    }
 
     if( aNickname )
         m_queue_in.push( *aNickname );
@@ -199,9 +216,7 @@ void FOOTPRINT_LIST_IMPL::StartWorkers( FP_LIB_TABLE* aTable, wxString const* aN
     m_loader->m_total_libs = m_queue_in.size();
 
     for( unsigned i = 0; i < aNThreads; ++i )
-    {
-        m_threads.push_back( std::thread( &FOOTPRINT_LIST_IMPL::loader_job, this ) );
-    }
+        m_loaders.Run( std::bind( &FOOTPRINT_LIST_IMPL::loader_job, this ) );
 }
 
 void FOOTPRINT_LIST_IMPL::StopWorkers()
@@ -210,12 +225,10 @@ void FOOTPRINT_LIST_IMPL::StopWorkers()
 
     // To safely stop our workers, we set the cancellation flag (they will each
     // exit on their next safe loop location when this is set).  Then we need to wait
-    // for all threads to finish as closing the implementation will free the queues
-    // that the threads write to.
-    for( auto& i : m_threads )
-        i.join();
+    // for all tasks to finish as closing the implementation will free the queues
+    // that the tasks write to.
+    m_loaders.Wait();
 
-    m_threads.clear();
     m_queue_in.clear();
     m_count_finished.store( 0 );
 
@@ -229,90 +242,90 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
     {
         std::lock_guard<std::mutex> lock1( m_join );
 
-        for( auto& i : m_threads )
-            i.join();
+        m_loaders.Wait();
 
-        m_threads.clear();
         m_queue_in.clear();
         m_count_finished.store( 0 );
     }
 
-    size_t total_count = m_queue_out.size();
-
     LOCALE_IO toggle_locale;
 
     // Parse the footprints in parallel. WARNING! This requires changing the locale, which is
-    // GLOBAL. It is only threadsafe to construct the LOCALE_IO before the threads are created,
+    // GLOBAL. It is only threadsafe to construct the LOCALE_IO before the tasks are started,
     // destroy it after they finish, and block the main (GUI) thread while they work. Any deviation
     // from this will cause nasal demons.
     //
     // TODO: blast LOCALE_IO into the sun
 
     SYNC_QUEUE<std::unique_ptr<FOOTPRINT_INFO>> queue_parsed;
-    std::vector<std::thread>                    threads;
+    TASK_GROUP                                  parsers;
 
-    for( size_t ii = 0; ii < std::thread::hardware_concurrency() + 1; ++ii )
+    for( size_t ii = 0; ii < parsers.GetPool().GetThreadCount(); ++ii )
     {
-        threads.push_back( std::thread( [this, &queue_parsed]() {
+        parsers.Run( [this, &queue_parsed]() {
             wxString nickname;
 
             while( this->m_queue_out.pop( nickname ) && !m_cancelled )
             {
                 wxArrayString fpnames;
+                long long     timestamp = 0;
 
-                try
-                {
+                // The timestamp is taken before parsing, so an index written for a library
+                // modified meanwhile is out of date
+                bool complete = CatchErrors( [this, &nickname, &fpnames, &timestamp]() {
+                    timestamp = libraryTimestamp( nickname );
                     m_lib_table->FootprintEnumerate( fpnames, nickname );
-                }
-                catch( const IO_ERROR& ioe )
-                {
-                    m_errors.move_push( std::make_unique<IO_ERROR>( ioe ) );
-                }
-                catch( const std::exception& se )
+                } );
+
+                std::vector<std::unique_ptr<FOOTPRINT_INFO>> footprints;
+
+                for( unsigned jj = 0; jj < fpnames.size() && !m_cancelled; ++jj )
                 {
-                    // This is a round about way to do this, but who knows what THROW_IO_ERROR()
-                    // may be tricked out to do someday, keep it in the game.
-                    try
+                    wxString                        fpname = fpnames[jj];
+                    std::unique_ptr<FOOTPRINT_INFO> fpinfo;
+
+                    // A footprint which cannot be parsed is reported, and neither listed
+                    // nor indexed (the index would hide its error next time)
+                    if( CatchErrors( [this, &nickname, &fpname, &fpinfo]() {
+                            fpinfo.reset( new FOOTPRINT_INFO_IMPL( this, nickname, fpname ) );
+                        } ) )
                     {
-                        THROW_IO_ERROR( se.what() );
+                        footprints.push_back( std::move( fpinfo ) );
                     }
-                    catch( const IO_ERROR& ioe )
+                    else
                     {
-                        m_errors.move_push( std::make_unique<IO_ERROR>( ioe ) );
+                        complete = false;
                     }
                 }
 
-                for( unsigned jj = 0; jj < fpnames.size() && !m_cancelled; ++jj )
-                {
-                    wxString fpname = fpnames[jj];
-                    FOOTPRINT_INFO* fpinfo = new FOOTPRINT_INFO_IMPL( this, nickname, fpname );
-                    queue_parsed.move_push( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
-                }
+                if( complete && !m_cancelled )
+                    writeLibraryIndex( nickname, timestamp, footprints );
+
+                for( std::unique_ptr<FOOTPRINT_INFO>& fpinfo : footprints )
+                    queue_parsed.move_push( std::move( fpinfo ) );
 
                 if( m_progress_reporter )
                     m_progress_reporter->AdvanceProgress();
-
-                m_count_finished.fetch_add( 1 );
             }
-        } ) );
+        } );
     }
 
-    while( !m_cancelled && (size_t)m_count_finished.load() < total_count )
+    while( !parsers.WaitFor( std::chrono::milliseconds( 30 ) ) )
     {
         if( m_progress_reporter && !m_progress_reporter->KeepRefreshing() )
             m_cancelled = true;
-
-        wxMilliSleep( 30 );
     }
 
-    for( auto& thr : threads )
-        thr.join();
+    parsers.Wait();
 
     std::unique_ptr<FOOTPRINT_INFO> fpi;
 
     while( queue_parsed.pop( fpi ) )
         m_list.push_back( std::move( fpi ) );
 
+    while( m_queue_indexed.pop( fpi ) )
+        m_list.push_back( std::move( fpi ) );
+
     std::sort( m_list.begin(), m_list.end(), []( std::unique_ptr<FOOTPRINT_INFO> const& lhs,
                                                  std::unique_ptr<FOOTPRINT_INFO> const& rhs ) -> bool
                                              {
@@ -323,6 +336,134 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
 }
 
 
+long long FOOTPRINT_LIST_IMPL::libraryTimestamp( const wxString& aNickname )
+{
+    return m_lib_table->GenerateTimestamp( &aNickname );
+}
+
+
+bool FOOTPRINT_LIST_IMPL::isIndexed( const wxString& aNickname )
+{
+    if( m_index_dir.IsEmpty() )
+        return false;
+
+    // The GitHub plugin has no timestamp of its own (it returns the current time), so its
+    // index would never be up to date
+    return m_lib_table->FindRow( aNickname )->GetType() != IO_MGR::ShowType( IO_MGR::GITHUB );
+}
+
+
+wxString FOOTPRINT_LIST_IMPL::indexFileName( const wxString& aNickname )
+{
+    // Named after the library path and nickname, which the library timestamp depends on.
+    // The nickname is kept, made file name safe, so the indices can be told apart.
+    const FP_LIB_TABLE_ROW* row = m_lib_table->FindRow( aNickname );
+    std::string             key = TO_UTF8( row->GetFullURI( true ) + '\n' + aNickname );
+    MD5_HASH                hash;
+
+    hash.Hash( (uint8_t*) key.data(), (uint32_t) key.size() );
+    hash.Finalize();
+
+    std::string digest = hash.Format();
+    digest.erase( std::remove( digest.begin(), digest.end(), ' ' ), digest.end() );
+
+    wxString name;
+
+    for( wxUniChar c : aNickname )
+        name += ( wxIsalnum( c ) || c == '-' || c == '_' ) ? c : wxUniChar( '_' );
+
+    return wxFileName( m_index_dir, name + '-' + digest + ".fp-index" ).GetFullPath();
+}
+
+
+bool FOOTPRINT_LIST_IMPL::readLibraryIndex( const wxString& aNickname )
+{
+    if( !isIndexed( aNickname ) )
+        return false;
+
+    wxTextFile indexFile( indexFileName( aNickname ) );
+
+    if( !indexFile.Exists() || !indexFile.Open() )
+        return false;
+
+    // The header holds the library path, its timestamp and the number of footprints.  A
+    // truncated file is out of date too.
+    const FP_LIB_TABLE_ROW* row = m_lib_table->FindRow( aNickname );
+    long long               timestamp = 0;
+    unsigned long           count = 0;
+
+    bool upToDate = indexFile.GetLineCount() >= 3
+                    && indexFile.GetFirstLine() == row->GetFullURI( true )
+                    && indexFile.GetNextLine().ToLongLong( &timestamp )
+                    && timestamp == libraryTimestamp( aNickname )
+                    && indexFile.GetNextLine().ToULong( &count )
+                    && indexFile.GetLineCount() == 3 + 5 * count;
+
+    if( upToDate )
+    {
+        for( unsigned long ii = 0; ii < count; ++ii )
+        {
+            wxString     name = indexFile.GetNextLine();
+            wxString     description = UnescapeString( indexFile.GetNextLine() );
+            wxString     keywords = UnescapeString( indexFile.GetNextLine() );
+            unsigned int padCount = (unsigned) wxAtoi( indexFile.GetNextLine() );
+            unsigned int uniquePadCount = (unsigned) wxAtoi( indexFile.GetNextLine() );
+
+            auto* fpinfo = new FOOTPRINT_INFO_IMPL( aNickname, name, description, keywords, 0,
+                                                    padCount, uniquePadCount );
+            m_queue_indexed.move_push( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
+        }
+    }
+
+    indexFile.Close();
+
+    return upToDate;
+}
+
+
+void FOOTPRINT_LIST_IMPL::writeLibraryIndex( const wxString& aNickname, long long aTimestamp,
+        const std::vector<std::unique_ptr<FOOTPRINT_INFO>>& aFootprints )
+{
+    if( !isIndexed( aNickname ) )
+        return;
+
+    // Written to a temporary file first, so another KiCad instance never reads a partial
+    // index.  The index is only a cache: it is simply not written if anything goes wrong.
+    wxString fileName = indexFileName( aNickname );
+    wxString tempName = wxFileName::CreateTempFileName( fileName );
+
+    if( tempName.IsEmpty() )
+        return;
+
+    wxTextFile indexFile( tempName );
+
+    if( !indexFile.Open() )
+    {
+        wxRemoveFile( tempName );
+        return;
+    }
+
+    indexFile.AddLine( m_lib_table->FindRow( aNickname )->GetFullURI( true ) );
+    indexFile.AddLine( wxString::Format( "%lld", aTimestamp ) );
+    indexFile.AddLine( wxString::Format( "%u", (unsigned) aFootprints.size() ) );
+
+    for( const std::unique_ptr<FOOTPRINT_INFO>& fpinfo : aFootprints )
+    {
+        indexFile.AddLine( fpinfo->GetName() );
+        indexFile.AddLine( EscapeString( fpinfo->GetDescription(), CTX_DELIMITED_STR ) );
+        indexFile.AddLine( EscapeString( fpinfo->GetKeywords(), CTX_DELIMITED_STR ) );
+        indexFile.AddLine( wxString::Format( "%u", fpinfo->GetPadCount() ) );
+        indexFile.AddLine( wxString::Format( "%u", fpinfo->GetUniquePadCount() ) );
+    }
+
+    bool written = indexFile.Write();
+    indexFile.Close();
+
+    if( !written || !wxRenameFile( tempName, fileName, true ) )
+        wxRemoveFile( tempName );
+}
+
+
 FOOTPRINT_LIST_IMPL::FOOTPRINT_LIST_IMPL() :
     m_loader( nullptr ),
     m_count_finished( 0 ),
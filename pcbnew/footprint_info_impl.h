@@ -23,11 +23,11 @@
 #include <atomic>
 #include <functional>
 #include <memory>
-#include <thread>
 #include <vector>
 
 #include <footprint_info.h>
 #include <sync_queue.h>
+#include <thread_pool.h>
 
 class LOCALE_IO;
 
@@ -84,7 +84,7 @@ protected:
 class FOOTPRINT_LIST_IMPL : public FOOTPRINT_LIST
 {
     FOOTPRINT_ASYNC_LOADER*  m_loader;
-    std::vector<std::thread> m_threads;
+    TASK_GROUP               m_loaders;     ///< loader_job() tasks run by the thread pool
     SYNC_QUEUE<wxString>     m_queue_in;
     SYNC_QUEUE<wxString>     m_queue_out;
     std::atomic_size_t       m_count_finished;
@@ -93,6 +93,12 @@ class FOOTPRINT_LIST_IMPL : public FOOTPRINT_LIST
     std::atomic_bool         m_cancelled;
     std::mutex               m_join;
 
+    /// Footprints read from the library indices by loader_job()
+    SYNC_QUEUE<std::unique_ptr<FOOTPRINT_INFO>> m_queue_indexed;
+
+    /// Directory of the library indices, empty when they are not used
+    wxString                 m_index_dir;
+
     /**
      * Call aFunc, pushing any IO_ERRORs and std::exceptions it throws onto m_errors.
      *
@@ -113,10 +119,54 @@ protected:
      */
     void loader_job();
 
+    /**
+     * Return the timestamp of a library, as given by FP_LIB_TABLE::GenerateTimestamp().
+     */
+    long long libraryTimestamp( const wxString& aNickname );
+
+    /**
+     * Return true if the library has an index: m_index_dir is set, and the plugin of the
+     * library gives a timestamp which only changes with the library.
+     */
+    bool isIndexed( const wxString& aNickname );
+
+    /**
+     * Return the file name of the index of a library in m_index_dir, made of its nickname
+     * and of the MD5 hash of its path and nickname.
+     */
+    wxString indexFileName( const wxString& aNickname );
+
+    /**
+     * Read the footprints of a library from its index onto m_queue_indexed, if the index is
+     * up to date.
+     *
+     * Library indices are kept in the user configuration directory, one file per library,
+     * so the footprints of the libraries which did not change since they were last parsed
+     * are listed without parsing them again, in any project using them with the same
+     * nickname.  An index is up to date when it was written for the same library path and
+     * library timestamp.
+     *
+     * @return true if the footprints were read.
+     */
+    bool readLibraryIndex( const wxString& aNickname );
+
+    /**
+     * Write the index of a library, listing aFootprints, for the library timestamp
+     * aTimestamp taken before the footprints were parsed.
+     */
+    void writeLibraryIndex( const wxString& aNickname, long long aTimestamp,
+                            const std::vector<std::unique_ptr<FOOTPRINT_INFO>>& aFootprints );
+
 public:
     FOOTPRINT_LIST_IMPL();
     virtual ~FOOTPRINT_LIST_IMPL();
 
+    /**
+     * Set the directory of the library indices, used instead of the "fp-info-index"
+     * directory of the user configuration.
+     */
+    void SetIndexDir( const wxString& aDir ) { m_index_dir = aDir; }
+
     void WriteCacheToFile( wxTextFile* aFile ) override;
     void ReadCacheFromFile( wxTextFile* aFile ) override;
 
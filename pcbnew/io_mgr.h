@@ -415,6 +415,9 @@ public:
      * Function GetEnumeratedFootprint
      * a version of FootprintLoad() for use after FootprintEnumerate() for more efficient
      * cache management.
+     *
+     * @throw IO_ERROR if the footprint cannot be read, which for plugins loading their
+     *  footprints on demand includes a footprint file which cannot be parsed.
      */
     virtual const MODULE* GetEnumeratedFootprint( const wxString& aLibraryPath,
                                                   const wxString& aFootprintName,
@@ -43,6 +43,7 @@
 #include <pcb_plot_params.h>
 #include <zones.h>
 #include <kicad_plugin.h>
+#include <advanced_config.h>
 #include <pcb_parser.h>
 
 #include <wx/dir.h>
@@ -84,13 +85,15 @@ void filterNetClass( const BOARD& aBoard, NETCLASS& aNetClass )
 class FP_CACHE_ITEM
 {
     WX_FILENAME             m_filename;
-    std::unique_ptr<MODULE> m_module;
+    std::unique_ptr<MODULE> m_module;       // NULL until the file is parsed by FP_CACHE.
 
 public:
     FP_CACHE_ITEM( MODULE* aModule, const WX_FILENAME& aFileName );
 
     const WX_FILENAME& GetFileName() const { return m_filename; }
     const MODULE*      GetModule()   const { return m_module.get(); }
+
+    void SetModule( MODULE* aModule ) { m_module.reset( aModule ); }
 };
 
 
@@ -110,7 +113,8 @@ class FP_CACHE
     PCB_IO*         m_owner;            // Plugin object that owns the cache.
     wxFileName      m_lib_path;         // The path of the library.
     wxString        m_lib_raw_path;     // For quick comparisons.
-    MODULE_MAP      m_modules;          // Map of footprint file name per MODULE*.
+    MODULE_MAP      m_modules;          // Map of footprint file name per MODULE*.  The
+                                        // MODULEs are parsed on demand by GetModule().
 
     bool            m_cache_dirty;      // Stored separately because it's expensive to check
                                         // m_cache_timestamp against all the files.
@@ -137,8 +141,23 @@ public:
      */
     void Save( MODULE* aModule = NULL );
 
+    /**
+     * Function Load
+     * enumerates the footprint files of the library.  The footprints themselves are only
+     * parsed by GetModule(), so loading a library is not proportional to its contents.
+     */
     void Load();
 
+    /**
+     * Function GetModule
+     * returns the footprint \a aFootprintName, parsing its file the first time it is
+     * requested.
+     *
+     * @return the footprint, or NULL if the library has no footprint \a aFootprintName.
+     * @throw IO_ERROR if the footprint file cannot be read or parsed.
+     */
+    const MODULE* GetModule( const wxString& aFootprintName );
+
     void Remove( const wxString& aFootprintName );
 
     /**
@@ -204,6 +223,13 @@ void FP_CACHE::Save( MODULE* aModule )
 
         WX_FILENAME fn = it->second->GetFileName();
 
+        // A footprint which was never parsed is unchanged from its file.
+        if( !it->second->GetModule() )
+        {
+            m_cache_timestamp += fn.GetTimestamp();
+            continue;
+        }
+
         wxString tempFileName =
 #ifdef USE_TMP_FILE
         wxFileName::CreateTempFileName( fn.GetPath() );
@@ -273,39 +299,39 @@ void FP_CACHE::Load()
 
     if( dir.GetFirst( &fullName, fileSpec ) )
     {
-        wxString cacheError;
-
         do
         {
             fn.SetFullName( fullName );
 
-            // Queue I/O errors so only files that fail to parse don't get loaded.
-            try
-            {
-                FILE_LINE_READER    reader( fn.GetFullPath() );
+            m_modules.insert( fn.GetName(), new FP_CACHE_ITEM( NULL, fn ) );
+            m_cache_timestamp += fn.GetTimestamp();
+        } while( dir.GetNext( &fullName ) );
+    }
+}
 
-                m_owner->m_parser->SetLineReader( &reader );
 
-                MODULE*     footprint = (MODULE*) m_owner->m_parser->Parse();
-                wxString    fpName = fn.GetName();
+const MODULE* FP_CACHE::GetModule( const wxString& aFootprintName )
+{
+    MODULE_ITER it = m_modules.find( aFootprintName );
 
-                footprint->SetFPID( LIB_ID( wxEmptyString, fpName ) );
-                m_modules.insert( fpName, new FP_CACHE_ITEM( footprint, fn ) );
+    if( it == m_modules.end() )
+        return NULL;
 
-                m_cache_timestamp += fn.GetTimestamp();
-            }
-            catch( const IO_ERROR& ioe )
-            {
-                if( !cacheError.IsEmpty() )
-                    cacheError += "\n\n";
+    FP_CACHE_ITEM* item = it->second;
 
-                cacheError += ioe.What();
-            }
-        } while( dir.GetNext( &fullName ) );
+    if( !item->GetModule() )
+    {
+        MAPPED_FILE_LINE_READER reader( item->GetFileName().GetFullPath() );
+
+        m_owner->m_parser->SetLineReader( &reader );
 
-        if( !cacheError.IsEmpty() )
-            THROW_IO_ERROR( cacheError );
+        MODULE* footprint = (MODULE*) m_owner->m_parser->Parse();
+
+        footprint->SetFPID( LIB_ID( wxEmptyString, aFootprintName ) );
+        item->SetModule( footprint );
     }
+
+    return item->GetModule();
 }
 
 
@@ -1785,7 +1811,7 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
         bool new_polygon = true;
         bool is_closed = false;
 
-        for( auto iterator = aZone->IterateWithHoles(); iterator; iterator++ )
+        for( auto iterator = aZone->CIterateWithHoles(); iterator; iterator++ )
         {
             if( new_polygon )
             {
@@ -1927,12 +1953,13 @@ PCB_IO::~PCB_IO()
 
 BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPERTIES* aProperties )
 {
-    FILE_LINE_READER    reader( aFileName );
+    MAPPED_FILE_LINE_READER reader( aFileName );
 
     init( aProperties );
 
     m_parser->SetLineReader( &reader );
     m_parser->SetBoard( aAppendToMe );
+    m_parser->SetParallelLoad( ADVANCED_CFG::GetCfg().m_parallelBoardLoad );
 
     BOARD* board;
 
@@ -2010,9 +2037,6 @@ void PCB_IO::FootprintEnumerate( wxArrayString&    aFootprintNames,
         errorMsg = ioe.What();
     }
 
-    // Some of the files may have been parsed correctly so we want to add the valid files to
-    // the library.
-
     const MODULE_MAP& mods = m_cache->GetModules();
 
     for( MODULE_CITER it = mods.begin();  it != mods.end();  ++it )
@@ -2043,16 +2067,7 @@ const MODULE* PCB_IO::getFootprint( const wxString& aLibraryPath,
         // do nothing with the error
     }
 
-    const MODULE_MAP& mods = m_cache->GetModules();
-
-    MODULE_CITER it = mods.find( aFootprintName );
-
-    if( it == mods.end() )
-    {
-        return NULL;
-    }
-
-    return it->second->GetModule();
+    return m_cache->GetModule( aFootprintName );
 }
 
 
@@ -2060,6 +2075,8 @@ const MODULE* PCB_IO::GetEnumeratedFootprint( const wxString& aLibraryPath,
                                               const wxString& aFootprintName,
                                               const PROPERTIES* aProperties )
 {
+    // The footprint files are parsed on demand, so the error of a malformed one is only
+    // thrown from here, rather than by FootprintEnumerate().
     return getFootprint( aLibraryPath, aFootprintName, aProperties, false );
 }
 
@@ -86,6 +86,7 @@
 #include <autorouter/autoplacer_tool.h>
 #include <gestfich.h>
 #include <executable_names.h>
+#include <advanced_config.h>
 #include <eda_dockart.h>
 #include <board_netlist_updater.h>
 #include <netlist_reader.h>
@@ -273,6 +274,7 @@ PCB_EDIT_FRAME::PCB_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
     m_hasAutoSave = true;
     m_microWaveToolBar = NULL;
     m_Layers = nullptr;
+    m_drc = nullptr;
     m_FrameSize = ConvertDialogToPixels( wxSize( 500, 350 ) );    // default in case of no prefs
 
     // We don't know what state board was in when it was lasat saved, so we have to
@@ -295,6 +297,7 @@ PCB_EDIT_FRAME::PCB_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
     m_Layers = new PCB_LAYER_WIDGET( this, GetCanvas() );
 
     m_drc = new DRC( this );        // these 2 objects point to each other
+    m_drc->SetIncrementalMode( ADVANCED_CFG::GetCfg().m_realTimeDrc );
 
     wxIcon  icon;
     icon.CopyFromBitmap( KiBitmap( icon_pcbnew_xpm ) );
@@ -442,6 +445,10 @@ void PCB_EDIT_FRAME::SetBoard( BOARD* aBoard )
 
     aBoard->GetConnectivity()->Build( aBoard );
 
+    // The incremental DRC indexes refer to the items of the previous board
+    if( m_drc )
+        m_drc->InvalidateIndexes();
+
     // reload the worksheet
     SetPageSettings( aBoard->GetPageSettings() );
 }
@@ -634,6 +641,10 @@ void PCB_EDIT_FRAME::UseGalCanvas()
 
     // Re-create the layer manager to allow arbitrary colors when GAL is enabled
     UpdateUserInterface();
+
+    // The legacy tools change the items in place, without commit
+    if( m_drc )
+        m_drc->InvalidateIndexes();
 }
 
 
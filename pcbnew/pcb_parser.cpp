@@ -28,6 +28,7 @@
  */
 
 #include <errno.h>
+#include <cstring>
 #include <common.h>
 #include <confirm.h>
 #include <macros.h>
@@ -50,10 +51,124 @@
 #include <zones.h>
 #include <pcb_parser.h>
 #include <convert_basic_shapes_to_polygon.h>    // for RECT_CHAMFER_POSITIONS definition
+#include <thread_pool.h>
 
 using namespace PCB_KEYS_T;
 
 
+/**
+ * Class BOARD_RECORDS_READER
+ * is a LINE_READER over a part of the text of the board item records gathered by
+ * PCB_PARSER::parseBoardItems().  ReadLineView() returns the lines in place in the text.
+ */
+class BOARD_RECORDS_READER : public LINE_READER
+{
+    const char* m_next;     ///< the next line to read
+    const char* m_end;      ///< the end of the text to read
+
+    const char* nextLine()
+    {
+        const char* line = m_next;
+        const char* nl = (const char*) memchr( line, '\n', m_end - line );
+
+        m_length = ( nl ? nl + 1 : m_end ) - line;
+
+        if( m_length >= m_maxLineLength )
+            THROW_IO_ERROR( _( "Maximum line length exceeded" ) );
+
+        m_next = line + m_length;
+        ++m_lineNum;
+
+        return m_length ? line : NULL;
+    }
+
+public:
+    /**
+     * @param aText is the text of the records.
+     * @param aBegin and aEnd are the offsets of the part of aText to read.
+     * @param aSource is the name of the board file, for the error reports.
+     * @param aLineNumber is the line number of aBegin in the board file.
+     */
+    BOARD_RECORDS_READER( const std::string& aText, size_t aBegin, size_t aEnd,
+                          const wxString& aSource, int aLineNumber ) :
+        LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
+        m_next( aText.data() + aBegin ),
+        m_end( aText.data() + aEnd )
+    {
+        m_source = aSource;
+        m_lineNum = aLineNumber - 1;    // incremented by the first read
+    }
+
+    char* ReadLine() override
+    {
+        const char* line = nextLine();
+
+        if( m_length + 1 > m_capacity )
+            expandCapacity( m_length + 1 );
+
+        if( line )
+            memcpy( m_line, line, m_length );
+
+        m_line[m_length] = 0;
+
+        return line ? m_line : NULL;
+    }
+
+    const char* ReadLineView() override
+    {
+        m_line[0] = 0;
+
+        return nextLine();
+    }
+};
+
+
+/**
+ * Returns true if aToken is the keyword of a record parsed by PCB_PARSER::parseBoardItem()
+ */
+static bool isBoardItem( T aToken )
+{
+    switch( aToken )
+    {
+    case T_gr_arc:
+    case T_gr_circle:
+    case T_gr_curve:
+    case T_gr_line:
+    case T_gr_poly:
+    case T_gr_text:
+    case T_dimension:
+    case T_module:
+    case T_segment:
+    case T_via:
+    case T_zone:
+    case T_target:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+
+/**
+ * Returns the mode used to add the items of the records with keyword aToken to the board
+ */
+static ADD_MODE boardItemAddMode( T aToken )
+{
+    return ( aToken == T_segment || aToken == T_via ) ? ADD_INSERT : ADD_APPEND;
+}
+
+
+/**
+ * Function isBlank
+ * tests for the whitespace skipped by the lexer, see isSpace() in dsnlexer.cpp.
+ */
+static inline bool isBlank( char cc )
+{
+    return cc == ' ' || cc == '\n' || cc == '\r' || cc == '\t' || cc == '\0';
+}
+
+
 void PCB_PARSER::init()
 {
     m_showLegacyZoneWarning = true;
@@ -544,35 +659,18 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
         case T_gr_curve:
         case T_gr_line:
         case T_gr_poly:
-            m_board->Add( parseDRAWSEGMENT(), ADD_APPEND );
-            break;
-
         case T_gr_text:
-            m_board->Add( parseTEXTE_PCB(), ADD_APPEND );
-            break;
-
         case T_dimension:
-            m_board->Add( parseDIMENSION(), ADD_APPEND );
-            break;
-
         case T_module:
-            m_board->Add( parseMODULE(), ADD_APPEND );
-            break;
-
         case T_segment:
-            m_board->Add( parseTRACK(), ADD_INSERT );
-            break;
-
         case T_via:
-            m_board->Add( parseVIA(), ADD_INSERT );
-            break;
-
         case T_zone:
-            m_board->Add( parseZONE_CONTAINER(), ADD_APPEND );
-            break;
-
         case T_target:
-            m_board->Add( parsePCB_TARGET(), ADD_APPEND );
+            if( m_parallelLoad )
+                parseBoardItems( token );
+            else
+                m_board->Add( parseBoardItem( token ), boardItemAddMode( token ) );
+
             break;
 
         default:
@@ -665,6 +763,281 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
 }
 
 
+BOARD_ITEM* PCB_PARSER::parseBoardItem( T aToken )
+{
+    switch( aToken )
+    {
+    case T_gr_arc:
+    case T_gr_circle:
+    case T_gr_curve:
+    case T_gr_line:
+    case T_gr_poly:
+        return parseDRAWSEGMENT();
+
+    case T_gr_text:
+        return parseTEXTE_PCB();
+
+    case T_dimension:
+        return parseDIMENSION();
+
+    case T_module:
+        return parseMODULE();
+
+    case T_segment:
+        return parseTRACK();
+
+    case T_via:
+        return parseVIA();
+
+    case T_zone:
+        return parseZONE_CONTAINER();
+
+    case T_target:
+        return parsePCB_TARGET();
+
+    default:
+        wxFAIL_MSG( wxT( "Not a board item: " ) + GetTokenString( aToken ) );
+        return NULL;
+    }
+}
+
+
+void PCB_PARSER::parseBoardItems( T aToken )
+{
+    struct RECORD
+    {
+        T      token;       ///< the keyword of the record
+        size_t offset;      ///< the offset of the record in text
+        int    line;        ///< the line number of the record in the board file
+    };
+
+    // Gather the text of the records.  The parentheses inside the quoted strings do not
+    // count, and the lines starting with '#' are comments, as for NextTok().  The '(' and
+    // the keyword of the first record have already been read.
+    std::vector<RECORD> records = { { aToken, 0, CurLineNumber() } };
+    std::string         text;
+    const char*         cur = next;
+    const char*         copied = next;    // the end of the text of the line copied so far
+    int                 depth = 1;
+    bool                inString = false;
+
+    // A record starting its line is read from the beginning of the line, so the errors
+    // report the same line and offset as when parsing the whole file.
+    auto recordBegin = [&]( const char* aOpen ) -> const char*
+    {
+        const char* begin = aOpen;
+
+        while( begin > start && isBlank( begin[-1] ) )
+            --begin;
+
+        return begin == start ? start : aOpen;
+    };
+
+    const char* open = start + curOffset;
+
+    while( open > start && isBlank( open[-1] ) )
+        --open;
+
+    if( open > start && open[-1] == '(' )
+        text.assign( recordBegin( open - 1 ), next );
+    else
+        text = "(" + curText;    // the '(' is on a previous line
+
+    // Copies the rest of the current line and reads the next one, returns false at EOF
+    auto nextLine = [&]() -> bool
+    {
+        text.append( copied, limit );
+
+        bool eof = readLine() == 0;
+
+        cur = copied = start;
+        inString = false;       // quoted strings end with their line
+
+        const char* first = start;
+
+        while( first < limit && isBlank( *first ) )
+            ++first;
+
+        if( first < limit && *first == '#' )
+            cur = limit;        // copied along, the parsers skip it too
+
+        return !eof;
+    };
+
+    // Reads the next lines until there is a char to scan, returns false at EOF
+    auto more = [&]() -> bool
+    {
+        while( cur >= limit )
+        {
+            if( !nextLine() )
+                return false;
+        }
+
+        return true;
+    };
+
+    for( ;; )
+    {
+        // Find the end of the current record.  As for NextTok(), a string only starts at
+        // the beginning of a token.
+        while( depth > 0 && more() )
+        {
+            char cc = *cur++;
+
+            if( inString )
+            {
+                if( cc == '\\' && cur < limit )
+                    ++cur;
+                else if( cc == '"' )
+                    inString = false;
+            }
+            else if( cc == '(' )
+                ++depth;
+            else if( cc == ')' )
+                --depth;
+            else if( cc == '"' )
+                inString = cur - 1 == start || isBlank( cur[-2] ) || cur[-2] == '('
+                           || cur[-2] == ')';
+        }
+
+        // At EOF the parser of the last record reports the error
+        if( depth > 0 )
+            break;
+
+        // Find the next record, only a board item record continues the run
+        while( more() && isBlank( *cur ) )
+            ++cur;
+
+        if( cur >= limit || *cur != '(' )
+            break;
+
+        const char* keyword = cur + 1;
+        const char* keywordEnd = keyword;
+
+        while( keywordEnd < limit && !isBlank( *keywordEnd ) && *keywordEnd != '('
+                && *keywordEnd != ')' )
+            ++keywordEnd;
+
+        T token = (T) findToken( std::string( keyword, keywordEnd ) );
+
+        if( !isBoardItem( token ) )
+            break;
+
+        const char* begin = std::max( recordBegin( cur ), copied );
+
+        records.push_back( { token, text.size() + ( begin - copied ), CurLineNumber() } );
+
+        cur = keywordEnd;
+        depth = 1;
+    }
+
+    text.append( copied, cur );
+
+    // The lexer resumes after the run
+    next = cur;
+
+    // Parse the records in chunks, each one with a parser of its own, so the parsers (and
+    // their keyword and layer tables) are not built for every record.
+    THREAD_POOL&    pool = THREAD_POOL::GetInstance();
+    const wxString& source = CurSource();
+    size_t          count = records.size();
+    size_t          chunkCount = std::min( count, 4 * ( pool.GetThreadCount() + 1 ) );
+
+    std::vector<std::unique_ptr<BOARD_ITEM>> items( count );
+    std::vector<std::set<wxString>>          undefinedLayers( chunkCount );
+
+    ParallelFor( chunkCount,
+            [&]( size_t aChunk )
+            {
+                size_t last = ( aChunk + 1 ) * count / chunkCount;
+                size_t end = last < count ? records[last].offset : text.size();
+
+                PCB_PARSER parser;
+
+                parser.m_board = m_board;
+                parser.m_layerIndices = m_layerIndices;
+                parser.m_layerMasks = m_layerMasks;
+                parser.m_netCodes = m_netCodes;
+                parser.m_tooRecent = m_tooRecent;
+                parser.m_requiredVersion = m_requiredVersion;
+                parser.m_workerParser = true;
+
+                for( size_t i = aChunk * count / chunkCount; i < last; )
+                {
+                    BOARD_RECORDS_READER reader( text, records[i].offset, end, source,
+                                                 records[i].line );
+
+                    parser.SetLineReader( &reader );
+
+                    try
+                    {
+                        for( ; i < last; ++i )
+                        {
+                            parser.NeedLEFT();
+                            parser.NextTok();
+                            items[i].reset( parser.parseBoardItem( records[i].token ) );
+                        }
+                    }
+                    catch( ... )
+                    {
+                        // Left to the main thread, which reports the errors.  Go on with a
+                        // new reader at the next record.
+                        ++i;
+                    }
+                }
+
+                undefinedLayers[aChunk] = std::move( parser.m_undefinedLayers );
+            } );
+
+    for( std::set<wxString>& layers : undefinedLayers )
+        m_undefinedLayers.insert( layers.begin(), layers.end() );
+
+    // Add the items in file order.  The records which failed are parsed again here, and
+    // if that adds nets, the records after them are parsed again too, since the workers
+    // did not know the new nets.
+    bool sequential = false;
+
+    for( size_t i = 0; i < count; ++i )
+    {
+        if( !items[i] || sequential )
+        {
+            BOARD_RECORDS_READER reader( text, records[i].offset, text.size(), source,
+                                         records[i].line );
+            const char*          savedStart = start;
+            const char*          savedNext = next;
+            const char*          savedLimit = limit;
+            unsigned             netCount = m_board->GetNetCount();
+
+            PushReader( &reader );
+
+            try
+            {
+                NeedLEFT();
+                NextTok();
+                items[i].reset( parseBoardItem( records[i].token ) );
+            }
+            catch( ... )
+            {
+                PopReader();
+                throw;
+            }
+
+            PopReader();
+
+            // PopReader() forces a new line to be read, the rest of the current one has to
+            // be parsed instead.
+            start = savedStart;
+            next = savedNext;
+            limit = savedLimit;
+
+            sequential = sequential || m_board->GetNetCount() != netCount;
+        }
+
+        m_board->Add( items[i].release(), boardItemAddMode( records[i].token ) );
+    }
+}
+
+
 void PCB_PARSER::parseHeader()
 {
     wxCHECK_RET( CurTok() == T_kicad_pcb,
@@ -3195,6 +3568,10 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER()
                     if( token == T_segment )    // deprecated
                     {
                         // SEGMENT fill mode no longer supported.  Make sure user is OK with converting them.
+                        // The user is asked on the main thread
+                        if( m_workerParser )
+                            THROW_IO_ERROR( wxT( "Legacy zone fill mode" ) );
+
                         if( m_showLegacyZoneWarning )
                         {
                             KIDIALOG dlg( nullptr,
@@ -3449,6 +3826,10 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER()
             zone->SetNetCode( net->GetNet() );
         else    // Not existing net: add a new net to keep trace of the zone netname
         {
+            // The net is added on the main thread
+            if( m_workerParser )
+                THROW_IO_ERROR( wxT( "Zone of a missing net" ) );
+
             int newnetcode = m_board->GetNetCount();
             net = new NETINFO_ITEM( m_board, netnameFromfile, newnetcode );
             m_board->Add( net );
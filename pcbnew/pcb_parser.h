@@ -77,6 +77,11 @@ class PCB_PARSER : public PCB_LEXER
 
     bool                m_showLegacyZoneWarning;
 
+    bool                m_parallelLoad;     ///< parse the board items on worker threads
+    bool                m_workerParser;     ///< true for the parsers of the worker threads,
+                                            ///< which leave to the main thread the items
+                                            ///< needing to ask the user or to add nets
+
     ///> Converts net code using the mapping table if available,
     ///> otherwise returns unchanged net code if < 0 or if is is out of range
     inline int getNetCode( int aNetCode )
@@ -148,6 +153,24 @@ class PCB_PARSER : public PCB_LEXER
     PCB_TARGET*     parsePCB_TARGET();
     BOARD*          parseBOARD();
 
+    /**
+     * Function parseBoardItem
+     * parses the board item record whose keyword \a aToken was just read.
+     */
+    BOARD_ITEM*     parseBoardItem( PCB_KEYS_T::T aToken );
+
+    /**
+     * Function parseBoardItems
+     * parses the run of consecutive board item records starting with the one whose keyword
+     * \a aToken was just read, and adds the items to the board in file order.
+     *
+     * The boundaries of the records are found by a scan of their text matching the
+     * parentheses, and the records are parsed on worker threads.  The run ends at the
+     * first record which is not a board item (a net, a net class...), since the records
+     * after it may depend on it.
+     */
+    void            parseBoardItems( PCB_KEYS_T::T aToken );
+
     /**
      * Function parseBOARD_unchecked
      * Parse a module, but do not replace PARSE_ERROR with FUTURE_FORMAT_ERROR automatically.
@@ -302,7 +325,9 @@ public:
 
     PCB_PARSER( LINE_READER* aReader = NULL ) :
         PCB_LEXER( aReader ),
-        m_board( 0 )
+        m_board( 0 ),
+        m_parallelLoad( false ),
+        m_workerParser( false )
     {
         init();
     }
@@ -328,6 +353,16 @@ public:
         m_board = aBoard;
     }
 
+    /**
+     * Function SetParallelLoad
+     * enables the parsing of the board items on the worker threads of the thread pool.
+     * The result is the same as the one of the sequential parsing.
+     */
+    void SetParallelLoad( bool aParallel )
+    {
+        m_parallelLoad = aParallel;
+    }
+
     BOARD_ITEM* Parse();
     /**
      * Function parseMODULE
@@ -33,6 +33,7 @@
 #endif
 
 #include <ratsnest_data.h>
+#include <ttl/ttl.h>
 #include <functional>
 using namespace std::placeholders;
 
@@ -153,17 +154,32 @@ static const std::vector<CN_EDGE> kruskalMST( std::list<CN_EDGE>& aEdges,
 class RN_NET::TRIANGULATOR_STATE
 {
 private:
-    std::vector<CN_ANCHOR_PTR>  m_allNodes;
+    ///> A distinct position of the net, shared by one or more anchors
+    struct SITE
+    {
+        hed::NODE_PTR               m_node;
+        std::vector<CN_ANCHOR_PTR>  m_anchors;
+    };
 
-    std::list<hed::EDGE_PTR> hedTriangulation( std::vector<hed::NODE_PTR>& aNodes )
+    struct POSITION_HASH
     {
-        hed::TRIANGULATION triangulator;
-        triangulator.CreateDelaunay( aNodes.begin(), aNodes.end() );
-        std::list<hed::EDGE_PTR> edges;
-        triangulator.GetEdges( edges );
+        size_t operator()( const VECTOR2I& aPos ) const
+        {
+            return std::hash<int64_t>()( ( (int64_t) aPos.x << 32 ) ^ (uint32_t) aPos.y );
+        }
+    };
 
-        return edges;
-    }
+    ///> Sites, indexed by the id of their node.  Free slots have no anchors.
+    std::vector<SITE>                                   m_sites;
+    std::vector<int>                                    m_freeSites;
+    std::unordered_map<VECTOR2I, int, POSITION_HASH>    m_siteIndex;
+
+    ///> Anchors of the last triangulation
+    std::unordered_set<CN_ANCHOR_PTR>                   m_anchors;
+
+    ///> Delaunay triangulation of the sites, if there are at least 3 of them and they
+    ///> are not colinear
+    std::unique_ptr<hed::TRIANGULATION>                 m_triangulation;
 
 
     // Checks if all nodes in aNodes lie on a single line. Requires the nodes to
@@ -189,117 +205,293 @@ private:
         return true;
     }
 
-public:
+    ///> Same as areNodesColinear(), for the sites which have anchors.
+    bool areSitesColinear() const
+    {
+        std::vector<hed::NODE_PTR> nodes;
 
-    void Clear()
+        for( const auto& site : m_sites )
+        {
+            if( site.m_anchors.empty() )
+                continue;
+
+            nodes.push_back( site.m_node );
+
+            // Most of the time, the first nodes are enough to tell
+            if( nodes.size() >= 3 && !areNodesColinear( nodes ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    int addSite( const VECTOR2I& aPos )
     {
-        m_allNodes.clear();
+        int id;
+
+        if( m_freeSites.empty() )
+        {
+            id = m_sites.size();
+            m_sites.emplace_back();
+        }
+        else
+        {
+            id = m_freeSites.back();
+            m_freeSites.pop_back();
+        }
+
+        m_sites[id].m_node = std::make_shared<hed::NODE>( aPos.x, aPos.y );
+        m_sites[id].m_node->SetId( id );
+        m_siteIndex[ aPos ] = id;
+
+        return id;
     }
 
-    void AddNode( CN_ANCHOR_PTR aNode )
+    void removeSite( int aId )
     {
-        m_allNodes.push_back( aNode );
+        m_siteIndex.erase( m_sites[aId].m_node->GetPos() );
+        m_sites[aId] = SITE();
+        m_freeSites.push_back( aId );
     }
 
-    const std::list<CN_EDGE> Triangulate()
+    void addAnchor( const CN_ANCHOR_PTR& aAnchor )
     {
-        std::list<CN_EDGE> mstEdges;
-        std::list<hed::EDGE_PTR> triangEdges;
-        std::vector<hed::NODE_PTR> triNodes;
+        auto it = m_siteIndex.find( aAnchor->Pos() );
+        int  id = it != m_siteIndex.end() ? it->second : addSite( aAnchor->Pos() );
+
+        m_sites[id].m_anchors.push_back( aAnchor );
+        m_anchors.insert( aAnchor );
+    }
+
+    ///> Finds a counterclockwise dart of the triangulation starting from aNode.
+    bool findDart( const hed::NODE_PTR& aNode, hed::DART& aDart ) const
+    {
+        aDart = m_triangulation->CreateDart();
+
+        if( !ttl::TRIANGULATION_HELPER::LocateTriangle<hed::TTLtraits>( aNode, aDart ) )
+            return false;
+
+        for( int i = 0; i < 3; i++ )
+        {
+            if( aDart.GetNode() == aNode )
+                return true;
+
+            aDart.Alpha0().Alpha1();
+        }
+
+        return false;
+    }
+
+public:
+
+    void Clear()
+    {
+        m_sites.clear();
+        m_freeSites.clear();
+        m_siteIndex.clear();
+        m_anchors.clear();
+        m_triangulation.reset();
+    }
+
+    /**
+     * Triangulates aNodes from scratch.
+     */
+    void Rebuild( const std::vector<CN_ANCHOR_PTR>& aNodes )
+    {
+        Clear();
+
+        for( const auto& n : aNodes )
+            addAnchor( n );
 
-        using ANCHOR_LIST = std::vector<CN_ANCHOR_PTR>;
-        std::vector<ANCHOR_LIST> anchorChains;
+        std::vector<hed::NODE_PTR> triNodes;
+        triNodes.reserve( m_sites.size() );
 
-        triNodes.reserve( m_allNodes.size() );
-        anchorChains.reserve( m_allNodes.size() );
+        for( const auto& site : m_sites )
+            triNodes.push_back( site.m_node );
 
-        std::sort( m_allNodes.begin(), m_allNodes.end(),
-                [] ( const CN_ANCHOR_PTR& aNode1, const CN_ANCHOR_PTR& aNode2 )
+        std::sort( triNodes.begin(), triNodes.end(),
+                [] ( const hed::NODE_PTR& aNode1, const hed::NODE_PTR& aNode2 )
         {
-            if( aNode1->Pos().y < aNode2->Pos().y )
+            if( aNode1->GetY() < aNode2->GetY() )
                 return true;
-            else if( aNode1->Pos().y == aNode2->Pos().y )
+            else if( aNode1->GetY() == aNode2->GetY() )
             {
-                return aNode1->Pos().x < aNode2->Pos().x;
+                return aNode1->GetX() < aNode2->GetX();
             }
 
             return false;
         }
                 );
 
-        CN_ANCHOR_PTR prev, last;
-        int id = 0;
+        if( triNodes.size() >= 3 && !areNodesColinear( triNodes ) )
+        {
+            m_triangulation.reset( new hed::TRIANGULATION );
+            m_triangulation->CreateDelaunay( triNodes.begin(), triNodes.end() );
+        }
+    }
 
-        for( auto n : m_allNodes )
+    /**
+     * Updates the triangulation for the anchors added to or removed from aNodes since the
+     * previous triangulation, by inserting and removing the changed sites only.
+     * @return false if the triangulation must be rebuilt instead: too many changes, sites
+     * added outside of or removed from the hull, or sites becoming colinear.  The state
+     * must not be used before the rebuild in this case.
+     */
+    bool Update( const std::vector<CN_ANCHOR_PTR>& aNodes )
+    {
+        if( !m_triangulation )
+            return false;
+
+        std::unordered_set<CN_ANCHOR_PTR> current( aNodes.begin(), aNodes.end() );
+        std::vector<CN_ANCHOR_PTR> removed, added;
+
+        for( const auto& anchor : m_anchors )
         {
-            anchorChains.push_back( ANCHOR_LIST() );
+            if( !current.count( anchor ) )
+                removed.push_back( anchor );
         }
 
-        for( auto n : m_allNodes )
+        for( const auto& anchor : aNodes )
         {
-            if( !prev || prev->Pos() != n->Pos() )
-            {
-                auto tn = std::make_shared<hed::NODE> ( n->Pos().x, n->Pos().y );
+            if( !m_anchors.count( anchor ) )
+                added.push_back( anchor );
+        }
 
-                tn->SetId( id );
-                triNodes.push_back( tn );
-            }
+        if( removed.empty() && added.empty() )
+            return true;
+
+        // Inserting many nodes one by one is slower than triangulating them all at once
+        if( ( removed.size() + added.size() ) * 4 > m_siteIndex.size() )
+            return false;
+
+        std::vector<int> changedSites;
+
+        for( const auto& anchor : removed )
+        {
+            int   id = m_siteIndex.at( anchor->Pos() );
+            auto& anchors = m_sites[id].m_anchors;
 
-            id++;
-            prev = n;
+            anchors.erase( std::find( anchors.begin(), anchors.end(), anchor ) );
+            m_anchors.erase( anchor );
+
+            changedSites.push_back( id );
         }
 
-        int prevId = 0;
+        std::vector<int> newSites;
 
-        for( auto n : triNodes )
+        for( const auto& anchor : added )
         {
-            for( int i = prevId; i < n->Id(); i++ )
-                anchorChains[prevId].push_back( m_allNodes[ i ] );
+            if( !m_siteIndex.count( anchor->Pos() ) )
+                newSites.push_back( addSite( anchor->Pos() ) );
 
-            prevId = n->Id();
+            addAnchor( anchor );
         }
 
-        for( int i = prevId; i < id; i++ )
-            anchorChains[prevId].push_back( m_allNodes[ i ] );
+        std::sort( changedSites.begin(), changedSites.end() );
+        changedSites.erase( std::unique( changedSites.begin(), changedSites.end() ),
+                            changedSites.end() );
+
+        std::vector<int> emptySites;
 
-        if( triNodes.size() == 1 )
+        for( int id : changedSites )
         {
-            return mstEdges;
+            if( m_sites[id].m_anchors.empty() )
+                emptySites.push_back( id );
         }
-        else if( areNodesColinear( triNodes ) )
+
+        if( m_siteIndex.size() - emptySites.size() < 3 || areSitesColinear() )
+            return false;
+
+        ttl::TRIANGULATION_HELPER helper( *m_triangulation );
+
+        // New sites first, so there is no need to check the removals leave colinear sites
+        // only (this is checked above for the final set of sites)
+        for( int id : newSites )
         {
-            // special case: all nodes are on the same line - there's no
-            // triangulation for such set. In this case, we sort along any coordinate
-            // and chain the nodes together.
-            for(int i = 0; i < (int)triNodes.size() - 1; i++ )
+            hed::DART dart = m_triangulation->CreateDart();
+
+            if( !helper.InsertNode<hed::TTLtraits>( dart, m_sites[id].m_node ) )
+                return false;
+        }
+
+        for( int id : emptySites )
+        {
+            hed::DART dart;
+
+            if( !findDart( m_sites[id].m_node, dart ) )
+                return false;
+
+            // Removing a node of the hull may leave a concave boundary, which the
+            // triangulation does not support
+            if( ttl::TRIANGULATION_HELPER::IsBoundaryNode( dart ) )
+                return false;
+
+            helper.RemoveInteriorNode<hed::TTLtraits>( dart );
+            removeSite( id );
+        }
+
+        return true;
+    }
+
+    /**
+     * @return the edges of the triangulation, and the edges between the anchors sharing
+     * a position.
+     */
+    const std::list<CN_EDGE> GetEdges() const
+    {
+        std::list<CN_EDGE> mstEdges;
+
+        if( m_triangulation )
+        {
+            std::list<hed::EDGE_PTR> triangEdges;
+            m_triangulation->GetEdges( triangEdges );
+
+            for( auto e : triangEdges )
             {
-                auto src = m_allNodes[ triNodes[i]->Id() ];
-                auto dst = m_allNodes[ triNodes[i + 1]->Id() ];
+                auto    src = m_sites[ e->GetSourceNode()->Id() ].m_anchors.front();
+                auto    dst = m_sites[ e->GetTargetNode()->Id() ].m_anchors.front();
+
                 mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
             }
         }
-        else
+        else if( m_siteIndex.size() > 1 )
         {
-            hed::TRIANGULATION triangulator;
-            triangulator.CreateDelaunay( triNodes.begin(), triNodes.end() );
-            triangulator.GetEdges( triangEdges );
+            // special case: all nodes are on the same line - there's no
+            // triangulation for such set. In this case, we sort along any coordinate
+            // and chain the nodes together.
+            std::vector<CN_ANCHOR_PTR> line;
 
-            for( auto e : triangEdges )
+            for( const auto& site : m_sites )
+            {
+                if( !site.m_anchors.empty() )
+                    line.push_back( site.m_anchors.front() );
+            }
+
+            std::sort( line.begin(), line.end(),
+                    [] ( const CN_ANCHOR_PTR& aNode1, const CN_ANCHOR_PTR& aNode2 )
             {
-                auto    src = m_allNodes[ e->GetSourceNode()->Id() ];
-                auto    dst = m_allNodes[ e->GetTargetNode()->Id() ];
+                if( aNode1->Pos().y < aNode2->Pos().y )
+                    return true;
+                else if( aNode1->Pos().y == aNode2->Pos().y )
+                {
+                    return aNode1->Pos().x < aNode2->Pos().x;
+                }
 
-                mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
+                return false;
             }
+                    );
+
+            for( int i = 0; i < (int) line.size() - 1; i++ )
+                mstEdges.emplace_back( line[i], line[i + 1], getDistance( line[i], line[i + 1] ) );
         }
 
-        for( unsigned int i = 0; i < anchorChains.size(); i++ )
+        for( const auto& site : m_sites )
         {
-            auto& chain = anchorChains[i];
-
-            if( chain.size() < 2 )
+            if( site.m_anchors.size() < 2 )
                 continue;
 
+            auto chain = site.m_anchors;
+
             std::sort( chain.begin(), chain.end(),
                     [] ( const CN_ANCHOR_PTR& a, const CN_ANCHOR_PTR& b ) {
                 return a->GetCluster().get() < b->GetCluster().get();
@@ -352,21 +544,21 @@ void RN_NET::compute()
                 node->SetTag( 0 );
         }
 
+        m_triangulator->Clear();
         return;
     }
 
 
-    m_triangulator->Clear();
-
-    for( auto n : m_nodes )
-    {
-        m_triangulator->AddNode( n );
-    }
-
     #ifdef PROFILE
     PROF_COUNTER cnt("triangulate");
     #endif
-    auto triangEdges = m_triangulator->Triangulate();
+
+    // Only the positions added or removed since the previous computation are
+    // triangulated again, if possible
+    if( !m_triangulator->Update( m_nodes ) )
+        m_triangulator->Rebuild( m_nodes );
+
+    auto triangEdges = m_triangulator->GetEdges();
     #ifdef PROFILE
     cnt.Show();
     #endif
@@ -145,7 +145,8 @@ public:
     bool NearestBicoloredPair( const RN_NET& aOtherNet, CN_ANCHOR_PTR& aNode1, CN_ANCHOR_PTR& aNode2 ) const;
 
 protected:
-    ///> Recomputes ratsnest from scratch.
+    ///> Recomputes ratsnest.  The triangulation of the previous computation is updated
+    ///> for the added and removed nodes when possible, instead of being rebuilt.
     void compute();
 
     ///> Vector of nodes
@@ -162,6 +163,7 @@ protected:
 
     class TRIANGULATOR_STATE;
 
+    ///> Triangulation of the nodes, kept between the computations
     std::shared_ptr<TRIANGULATOR_STATE> m_triangulator;
 };
 
@@ -0,0 +1,620 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+
+#include <board_commit.h>
+#include <class_board.h>
+#include <convert_to_biu.h>
+#include <connectivity/connectivity_data.h>
+#include <connectivity/connectivity_algo.h>
+#include <geometry/shape_line_chain.h>
+#include <thread_pool.h>
+
+#include "pns_batch_router.h"
+#include "pns_kicad_iface.h"
+#include "pns_line.h"
+#include "pns_node.h"
+#include "pns_placement_algo.h"
+#include "pns_router.h"
+#include "pns_routing_settings.h"
+#include "pns_sizes_settings.h"
+
+// Number of routes ripped up at most to make room for a connection
+static const int maxRipupsPerConnection = 3;
+
+
+/**
+ * Records the changes committed by the router of a worker instead of applying them
+ * to the board, which is only modified by the main thread.
+ */
+class PNS_BATCH_ROUTER::CAPTURE_IFACE : public PNS_KICAD_IFACE
+{
+public:
+    void AddItem( PNS::ITEM* aItem ) override
+    {
+        m_added.push_back( aItem );
+    }
+
+    void RemoveItem( PNS::ITEM* aItem ) override
+    {
+        m_removed.emplace_back( aItem->Clone() );
+    }
+
+    void Commit() override
+    {
+    }
+
+    void Clear()
+    {
+        m_added.clear();
+        m_removed.clear();
+    }
+
+    ///> Items added to the world of the worker
+    std::vector<PNS::ITEM*> m_added;
+
+    ///> Copies of the items removed from the world of the worker
+    std::vector<std::unique_ptr<PNS::ITEM>> m_removed;
+};
+
+
+/**
+ * A router with its own copy of the world.
+ */
+class PNS_BATCH_ROUTER::WORKER
+{
+public:
+    WORKER( BOARD* aBoard )
+    {
+        m_iface.SetBoard( aBoard );
+
+        m_router.SetInterface( &m_iface );
+        m_router.ClearWorld();
+        m_router.SyncWorld();
+
+        PNS::ROUTING_SETTINGS settings;
+        settings.SetMode( PNS::RM_Walkaround );
+        settings.SetRemoveLoops( false );
+        m_router.LoadSettings( settings );
+    }
+
+    ~WORKER()
+    {
+        m_router.StopRouting();
+        m_router.ClearWorld();
+    }
+
+    PNS::NODE* World() const
+    {
+        return m_router.GetWorld();
+    }
+
+    /**
+     * Returns the item of aNet the connection can start or end at aP.
+     */
+    PNS::ITEM* PickAnchor( const VECTOR2I& aP, int aNet )
+    {
+        PNS::ITEM* found = nullptr;
+
+        for( PNS::ITEM* item : m_router.QueryHoverItems( aP ).Items() )
+        {
+            if( item->Net() != aNet )
+                continue;
+
+            // Prefer pads and vias to the tracks ending there
+            if( item->OfKind( PNS::ITEM::SOLID_T | PNS::ITEM::VIA_T ) )
+                return item;
+
+            if( !found && item->OfKind( PNS::ITEM::SEGMENT_T ) )
+                found = item;
+        }
+
+        return found;
+    }
+
+    CAPTURE_IFACE             m_iface;
+    PNS::ROUTER               m_router;
+    CONNECTION*               m_conn = nullptr;
+    bool                      m_routed = false;
+    std::chrono::microseconds m_duration;
+};
+
+
+PNS_BATCH_ROUTER::PNS_BATCH_ROUTER( BOARD* aBoard, BOARD_COMMIT* aCommit ) :
+    m_board( aBoard ),
+    m_commit( aCommit ),
+    m_netTimeBudget( 2000 ),
+    m_ripupPasses( 2 ),
+    m_threadCount( 0 )
+{
+}
+
+
+PNS_BATCH_ROUTER::~PNS_BATCH_ROUTER()
+{
+}
+
+
+int PNS_BATCH_ROUTER::Route()
+{
+    m_stats = STATS();
+    m_connections.clear();
+    m_pending.clear();
+    m_failed.clear();
+    m_owners.clear();
+    m_created.clear();
+    m_netTime.clear();
+
+    m_board->BuildConnectivity();
+    collectConnections();
+
+    if( m_pending.empty() )
+        return 0;
+
+    // Outer layers first, as most of the pads are there
+    LSET copper = LSET::AllCuMask( m_board->GetCopperLayerCount() );
+
+    m_layers.clear();
+
+    for( PCB_LAYER_ID layer : { F_Cu, B_Cu } )
+    {
+        if( copper[layer] )
+            m_layers.push_back( layer );
+    }
+
+    for( PCB_LAYER_ID layer : copper.CuStack() )
+    {
+        if( layer != F_Cu && layer != B_Cu )
+            m_layers.push_back( layer );
+    }
+
+    m_boardIface.reset( new PNS_KICAD_IFACE );
+    m_boardIface->SetBoard( m_board );
+
+    int threads = m_threadCount;
+
+    if( threads <= 0 )
+        threads = (int) THREAD_POOL::GetInstance().GetThreadCount();
+
+    // The worlds are synchronized on this thread, as reading the board items can update
+    // their cached values
+    for( int ii = 0; ii < std::max( threads, 1 ); ++ii )
+        m_workers.emplace_back( new WORKER( m_board ) );
+
+    routePending();
+
+    for( int pass = 0; pass < m_ripupPasses && !m_failed.empty(); ++pass )
+    {
+        std::vector<CONNECTION*> failed;
+        std::swap( failed, m_failed );
+
+        for( CONNECTION* conn : failed )
+        {
+            if( budgetExceeded( conn->m_net ) || !ripUpAround( *conn ) )
+                m_failed.push_back( conn );
+        }
+
+        if( m_pending.empty() )
+            break;
+
+        routePending();
+    }
+
+    m_workers.clear();
+    m_boardIface.reset();
+
+    if( m_commit )
+    {
+        for( BOARD_CONNECTED_ITEM* item : m_created )
+            m_commit->Added( item );
+    }
+
+    for( const auto& conn : m_connections )
+    {
+        if( conn->m_done )
+            m_stats.m_routed++;
+        else
+            m_stats.m_failed++;
+    }
+
+    m_board->GetConnectivity()->RecalculateRatsnest();
+
+    return m_stats.m_routed;
+}
+
+
+void PNS_BATCH_ROUTER::collectConnections()
+{
+    std::vector<CN_EDGE> edges;
+    std::map<int, double> netLength;
+
+    m_board->GetConnectivity()->GetUnconnectedEdges( edges );
+
+    for( const CN_EDGE& edge : edges )
+    {
+        BOARD_CONNECTED_ITEM* source = edge.GetSourceNode()->Parent();
+        BOARD_CONNECTED_ITEM* target = edge.GetTargetNode()->Parent();
+
+        // Connections to zones are made by the zone fill
+        if( !source || !target || source->Type() == PCB_ZONE_AREA_T
+                || target->Type() == PCB_ZONE_AREA_T )
+            continue;
+
+        int net = source->GetNetCode();
+
+        if( net <= 0 || ( !m_nets.empty() && !m_nets.count( net ) ) )
+            continue;
+
+        if( edge.GetSourcePos() == edge.GetTargetPos() )
+            continue;
+
+        auto conn = new CONNECTION;
+        conn->m_net = net;
+        conn->m_start = edge.GetSourcePos();
+        conn->m_end = edge.GetTargetPos();
+
+        // The route usually stays close to the straight line between the anchors
+        VECTOR2I size = conn->m_end - conn->m_start;
+        int margin = std::max( std::abs( size.x ), std::abs( size.y ) ) / 4 + Millimeter2iu( 1 );
+
+        conn->m_bbox = BOX2I( conn->m_start, size );
+        conn->m_bbox.Normalize();
+        conn->m_bbox.Inflate( margin );
+
+        netLength[net] += size.EuclideanNorm();
+        m_connections.emplace_back( conn );
+    }
+
+    // Shortest nets first, and the shortest connections of a net first
+    std::sort( m_connections.begin(), m_connections.end(),
+            [&netLength]( const std::unique_ptr<CONNECTION>& a,
+                          const std::unique_ptr<CONNECTION>& b )
+            {
+                if( a->m_net != b->m_net )
+                {
+                    if( netLength[a->m_net] != netLength[b->m_net] )
+                        return netLength[a->m_net] < netLength[b->m_net];
+
+                    return a->m_net < b->m_net;
+                }
+
+                return ( a->m_end - a->m_start ).SquaredEuclideanNorm()
+                        < ( b->m_end - b->m_start ).SquaredEuclideanNorm();
+            } );
+
+    for( const auto& conn : m_connections )
+        m_pending.push_back( conn.get() );
+}
+
+
+bool PNS_BATCH_ROUTER::budgetExceeded( int aNet ) const
+{
+    auto it = m_netTime.find( aNet );
+
+    return it != m_netTime.end() && it->second >= m_netTimeBudget;
+}
+
+
+std::vector<PNS_BATCH_ROUTER::CONNECTION*> PNS_BATCH_ROUTER::nextBatch()
+{
+    std::vector<CONNECTION*> batch;
+    std::vector<CONNECTION*> rest;
+
+    for( CONNECTION* conn : m_pending )
+    {
+        if( batch.size() == m_workers.size() )
+        {
+            rest.push_back( conn );
+            continue;
+        }
+
+        if( budgetExceeded( conn->m_net ) )
+        {
+            m_failed.push_back( conn );
+            continue;
+        }
+
+        bool overlaps = std::any_of( batch.begin(), batch.end(),
+                [conn]( CONNECTION* aOther )
+                {
+                    return aOther->m_net == conn->m_net || aOther->m_bbox.Intersects( conn->m_bbox );
+                } );
+
+        if( overlaps )
+            rest.push_back( conn );
+        else
+            batch.push_back( conn );
+    }
+
+    m_pending = std::move( rest );
+    return batch;
+}
+
+
+void PNS_BATCH_ROUTER::routePending()
+{
+    while( !m_pending.empty() )
+    {
+        std::vector<CONNECTION*> batch = nextBatch();
+
+        if( batch.empty() )
+            continue;
+
+        TASK_GROUP group( THREAD_POOL::GetInstance() );
+
+        for( size_t ii = 0; ii < batch.size(); ++ii )
+        {
+            WORKER& worker = *m_workers[ii];
+
+            worker.m_conn = batch[ii];
+            worker.m_iface.Clear();
+
+            group.Run( [this, &worker]()
+                    {
+                        auto start = std::chrono::steady_clock::now();
+
+                        worker.m_routed = routeConnection( worker, *worker.m_conn );
+                        worker.m_duration = std::chrono::duration_cast<std::chrono::microseconds>(
+                                std::chrono::steady_clock::now() - start );
+                    } );
+        }
+
+        group.Wait();
+
+        // The routes are applied in the order of the connections, a route colliding with
+        // the ones applied before it is routed again in the next batch
+        std::vector<WORKER*> applied;
+
+        for( size_t ii = 0; ii < batch.size(); ++ii )
+        {
+            WORKER&     worker = *m_workers[ii];
+            CONNECTION& conn = *worker.m_conn;
+
+            m_netTime[conn.m_net] += worker.m_duration;
+
+            if( !worker.m_routed )
+            {
+                m_failed.push_back( &conn );
+            }
+            else if( checkConflicts( worker, applied ) )
+            {
+                dropRoutes( worker );
+                m_pending.insert( m_pending.begin(), &conn );
+                m_stats.m_conflicts++;
+            }
+            else
+            {
+                applyRoutes( worker, conn );
+                applied.push_back( &worker );
+            }
+        }
+    }
+}
+
+
+bool PNS_BATCH_ROUTER::routeConnection( WORKER& aWorker, CONNECTION& aConn )
+{
+    PNS::ROUTER& router = aWorker.m_router;
+    PNS::ITEM*   startItem = aWorker.PickAnchor( aConn.m_start, aConn.m_net );
+    PNS::ITEM*   endItem = aWorker.PickAnchor( aConn.m_end, aConn.m_net );
+
+    if( !startItem || !endItem )
+        return false;
+
+    aConn.m_blockedLayer = -1;
+
+    for( int layer : m_layers )
+    {
+        if( !startItem->Layers().Overlaps( layer ) || !endItem->Layers().Overlaps( layer ) )
+            continue;
+
+        PNS::SIZES_SETTINGS sizes( router.Sizes() );
+        sizes.Init( m_board, startItem, aConn.m_net );
+        router.UpdateSizes( sizes );
+
+        if( !router.StartRouting( aConn.m_start, startItem, layer ) )
+            continue;
+
+        router.Move( aConn.m_end, endItem );
+
+        // The walkaround stops at the obstacles it cannot get around
+        VECTOR2I end = router.Placer()->CurrentEnd();
+
+        if( end == aConn.m_end && router.FixRoute( aConn.m_end, endItem, true ) )
+            return true;
+
+        if( aConn.m_blockedLayer < 0 || ( aConn.m_end - end ).SquaredEuclideanNorm()
+                                        < ( aConn.m_end - aConn.m_blockedAt ).SquaredEuclideanNorm() )
+        {
+            aConn.m_blockedAt = end;
+            aConn.m_blockedLayer = layer;
+            aConn.m_blockedWidth = sizes.TrackWidth();
+        }
+
+        router.StopRouting();
+    }
+
+    return false;
+}
+
+
+bool PNS_BATCH_ROUTER::checkConflicts( WORKER& aWorker,
+                                       const std::vector<WORKER*>& aApplied ) const
+{
+    for( PNS::ITEM* item : aWorker.m_iface.m_added )
+    {
+        for( WORKER* other : aApplied )
+        {
+            for( PNS::ITEM* otherItem : other->m_iface.m_added )
+            {
+                if( item->Collide( otherItem, aWorker.m_router.GetClearance( item, otherItem ) ) )
+                    return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+void PNS_BATCH_ROUTER::applyRoutes( WORKER& aWorker, CONNECTION& aConn )
+{
+    for( const std::unique_ptr<PNS::ITEM>& removed : aWorker.m_iface.m_removed )
+    {
+        BOARD_CONNECTED_ITEM* parent = removed->Parent();
+
+        if( !parent )
+            continue;
+
+        removeFromWorlds( parent );
+
+        auto owner = m_owners.find( parent );
+
+        if( owner != m_owners.end() )
+        {
+            std::vector<BOARD_CONNECTED_ITEM*>& routed = owner->second->m_routed;
+            routed.erase( std::remove( routed.begin(), routed.end(), parent ), routed.end() );
+            m_owners.erase( owner );
+        }
+
+        removeFromBoard( parent );
+    }
+
+    for( PNS::ITEM* item : aWorker.m_iface.m_added )
+    {
+        // Creates the board item, and makes it the parent of the item of the worker
+        m_boardIface->AddItem( item );
+
+        if( !item->Parent() )
+            continue;
+
+        aConn.m_routed.push_back( item->Parent() );
+        m_owners[item->Parent()] = &aConn;
+        m_created.insert( item->Parent() );
+
+        for( const auto& other : m_workers )
+        {
+            if( other.get() != &aWorker )
+                other->World()->Add( std::unique_ptr<PNS::ITEM>( item->Clone() ) );
+        }
+    }
+
+    aConn.m_done = true;
+    aWorker.m_iface.Clear();
+}
+
+
+void PNS_BATCH_ROUTER::dropRoutes( WORKER& aWorker )
+{
+    PNS::NODE* world = aWorker.World();
+
+    for( PNS::ITEM* item : aWorker.m_iface.m_added )
+        world->Remove( item );
+
+    for( std::unique_ptr<PNS::ITEM>& removed : aWorker.m_iface.m_removed )
+        world->Add( std::move( removed ) );
+
+    aWorker.m_iface.Clear();
+}
+
+
+bool PNS_BATCH_ROUTER::ripUpAround( CONNECTION& aConn )
+{
+    if( aConn.m_blockedLayer < 0 )
+        return false;
+
+    // The rest of the way, from where the walkaround stopped to the end of the connection
+    PNS::LINE rest;
+    rest.SetShape( SHAPE_LINE_CHAIN( aConn.m_blockedAt, aConn.m_end ) );
+    rest.SetLayer( aConn.m_blockedLayer );
+    rest.SetWidth( aConn.m_blockedWidth );
+    rest.SetNet( aConn.m_net );
+
+    // The worlds of the workers all hold the routes applied so far
+    PNS::NODE*               world = m_workers.front()->World();
+    std::vector<CONNECTION*> blockers;
+
+    while( (int) blockers.size() < maxRipupsPerConnection )
+    {
+        PNS::NODE::OPT_OBSTACLE obstacle = world->NearestObstacle( &rest );
+
+        if( !obstacle )
+            break;
+
+        auto owner = m_owners.find( obstacle->m_item->Parent() );
+
+        // Ripping up the routes behind an item not routed here would not clear the way
+        if( owner == m_owners.end() )
+            break;
+
+        blockers.push_back( owner->second );
+        ripUp( *owner->second );
+    }
+
+    if( blockers.empty() )
+        return false;
+
+    m_pending.push_back( &aConn );
+
+    for( CONNECTION* blocker : blockers )
+    {
+        m_pending.push_back( blocker );
+        m_stats.m_rippedUp++;
+    }
+
+    return true;
+}
+
+
+void PNS_BATCH_ROUTER::ripUp( CONNECTION& aConn )
+{
+    for( BOARD_CONNECTED_ITEM* item : aConn.m_routed )
+    {
+        removeFromWorlds( item );
+        m_owners.erase( item );
+        removeFromBoard( item );
+    }
+
+    aConn.m_routed.clear();
+    aConn.m_done = false;
+}
+
+
+void PNS_BATCH_ROUTER::removeFromWorlds( BOARD_CONNECTED_ITEM* aItem )
+{
+    for( const auto& worker : m_workers )
+    {
+        if( PNS::ITEM* item = worker->World()->FindItemByParent( aItem ) )
+            worker->World()->Remove( item );
+    }
+}
+
+
+void PNS_BATCH_ROUTER::removeFromBoard( BOARD_CONNECTED_ITEM* aItem )
+{
+    m_board->Remove( aItem );
+
+    // The items of the board before routing belong to the undo entry of the commit
+    if( m_created.erase( aItem ) || !m_commit )
+        delete aItem;
+    else
+        m_commit->Removed( aItem );
+}
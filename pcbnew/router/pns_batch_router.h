@@ -0,0 +1,177 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_BATCH_ROUTER_H
+#define __PNS_BATCH_ROUTER_H
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include <math/box2.h>
+#include <math/vector2d.h>
+
+class BOARD;
+class BOARD_COMMIT;
+class BOARD_CONNECTED_ITEM;
+class PNS_KICAD_IFACE;
+
+/**
+ * Class PNS_BATCH_ROUTER
+ *
+ * Routes the unconnected ratsnest edges of a board without any user interaction, through
+ * the same walkaround placer as the interactive router.
+ *
+ * The connections are routed net by net, the nets with the shortest ratsnest first. Each
+ * worker thread of the shared thread pool has its own router and copy of the world, so
+ * connections far enough from each other are routed concurrently; the routed tracks are
+ * then added to the board and to the worlds of the other workers. Connections that cannot
+ * be routed get another chance after the routes of other nets in their way are ripped up.
+ *
+ * Only connections between items sharing a copper layer are routed (no vias are added).
+ *
+ * The board is modified while routing. When a commit is given, the tracks left on the board
+ * and the items removed from it are staged in the commit as already done changes, so pushing
+ * it creates a single undo entry and updates the view, the connectivity and the DRC.
+ */
+class PNS_BATCH_ROUTER
+{
+public:
+    struct STATS
+    {
+        int m_routed = 0;       ///< connections routed
+        int m_failed = 0;       ///< connections left unrouted
+        int m_rippedUp = 0;     ///< routes ripped up to make room for other connections
+        int m_conflicts = 0;    ///< concurrent routes dropped because they collided
+    };
+
+    /**
+     * @param aBoard is the board to route
+     * @param aCommit receives the changes of the board, it is pushed by the caller
+     *                (may be NULL)
+     */
+    PNS_BATCH_ROUTER( BOARD* aBoard, BOARD_COMMIT* aCommit = nullptr );
+    ~PNS_BATCH_ROUTER();
+
+    /**
+     * Sets the time after which the remaining connections of a net are given up.
+     */
+    void SetNetTimeBudget( std::chrono::milliseconds aBudget ) { m_netTimeBudget = aBudget; }
+
+    /**
+     * Sets the number of rip-up and retry passes run after the first routing pass.
+     */
+    void SetRipupPasses( int aPasses ) { m_ripupPasses = aPasses; }
+
+    /**
+     * Sets the number of connections routed concurrently (the thread pool size if 0).
+     */
+    void SetThreadCount( int aCount ) { m_threadCount = aCount; }
+
+    /**
+     * Restricts the routing to the given nets (all the nets if empty).
+     */
+    void SetNets( const std::set<int>& aNets ) { m_nets = aNets; }
+
+    /**
+     * Function Route()
+     *
+     * Routes the unconnected edges of the board.
+     * @return the number of routed connections
+     */
+    int Route();
+
+    const STATS& GetStats() const { return m_stats; }
+
+private:
+    struct CONNECTION
+    {
+        int      m_net;
+        VECTOR2I m_start;
+        VECTOR2I m_end;
+        BOX2I    m_bbox;
+        bool     m_done = false;
+
+        ///> Where the failed walkaround got the closest to the end, and on which layer
+        VECTOR2I m_blockedAt;
+        int      m_blockedLayer = -1;
+        int      m_blockedWidth = 0;
+
+        ///> Board items created for this connection
+        std::vector<BOARD_CONNECTED_ITEM*> m_routed;
+    };
+
+    class WORKER;
+    class CAPTURE_IFACE;
+
+    void collectConnections();
+
+    ///> Routes the pending connections, several at a time
+    void routePending();
+
+    ///> Picks connections that can be routed at once, with no overlapping bounding boxes
+    std::vector<CONNECTION*> nextBatch();
+
+    bool routeConnection( WORKER& aWorker, CONNECTION& aConn );
+
+    ///> Returns true if the routes of aWorker collide with the routes applied before them
+    bool checkConflicts( WORKER& aWorker, const std::vector<WORKER*>& aApplied ) const;
+
+    ///> Adds the routes of aWorker to the board and to the worlds of the other workers
+    void applyRoutes( WORKER& aWorker, CONNECTION& aConn );
+
+    ///> Removes the routes of aWorker from its world
+    void dropRoutes( WORKER& aWorker );
+
+    ///> Removes the routes blocking the rest of the way of aConn, nearest first, and queues
+    ///> them again after it. Returns false if no route of this router is in the way.
+    bool ripUpAround( CONNECTION& aConn );
+
+    void ripUp( CONNECTION& aConn );
+    void removeFromWorlds( BOARD_CONNECTED_ITEM* aItem );
+
+    ///> Removes an item from the board, and stages its removal if it existed before routing
+    void removeFromBoard( BOARD_CONNECTED_ITEM* aItem );
+
+    bool budgetExceeded( int aNet ) const;
+
+    BOARD*        m_board;
+    BOARD_COMMIT* m_commit;
+    STATS         m_stats;
+
+    std::chrono::milliseconds m_netTimeBudget;
+    int                       m_ripupPasses;
+    int                       m_threadCount;
+    std::set<int>             m_nets;
+
+    std::vector<int>                      m_layers;
+    std::vector<std::unique_ptr<WORKER>>  m_workers;
+    std::unique_ptr<PNS_KICAD_IFACE>      m_boardIface;
+
+    std::vector<std::unique_ptr<CONNECTION>>      m_connections;
+    std::vector<CONNECTION*>                      m_pending;
+    std::vector<CONNECTION*>                      m_failed;
+    std::map<BOARD_CONNECTED_ITEM*, CONNECTION*>  m_owners;
+    std::set<BOARD_CONNECTED_ITEM*>               m_created;
+    std::map<int, std::chrono::microseconds>      m_netTime;
+};
+
+#endif    // __PNS_BATCH_ROUTER_H
@@ -25,7 +25,6 @@ namespace PNS {
 
 INDEX::INDEX()
 {
-    memset( m_subIndices, 0, sizeof( m_subIndices ) );
 }
 
 
@@ -76,10 +75,23 @@ INDEX::ITEM_SHAPE_INDEX* INDEX::getSubindex( const ITEM* aItem )
         return nullptr;
     }
 
-    if( !m_subIndices[idx_n] )
-        m_subIndices[idx_n] = new ITEM_SHAPE_INDEX;
+    std::shared_ptr<ITEM_SHAPE_INDEX>& idx = m_subIndices[idx_n];
 
-    return m_subIndices[idx_n];
+    if( !idx )
+    {
+        idx = std::make_shared<ITEM_SHAPE_INDEX>();
+    }
+    else if( idx.use_count() > 1 )
+    {
+        // The sub-index is shared with another copy of the index: copy it before
+        // it gets modified
+        auto copy = std::make_shared<ITEM_SHAPE_INDEX>();
+
+        idx->Accept( [&copy]( ITEM* aSharedItem ) { copy->Add( aSharedItem ); } );
+        idx = copy;
+    }
+
+    return idx.get();
 }
 
 void INDEX::Add( ITEM* aItem )
@@ -124,14 +136,7 @@ void INDEX::Replace( ITEM* aOldItem, ITEM* aNewItem )
 void INDEX::Clear()
 {
     for( int i = 0; i < MaxSubIndices; ++i )
-    {
-        ITEM_SHAPE_INDEX* idx = m_subIndices[i];
-
-        if( idx )
-            delete idx;
-
-        m_subIndices[i] = NULL;
-    }
+        m_subIndices[i].reset();
 }
 
 
@@ -24,6 +24,7 @@
 
 #include <layers_id_colors_and_visibility.h>
 #include <map>
+#include <memory>
 #include <unordered_set>
 
 #include <boost/range/adaptor/map.hpp>
@@ -42,6 +43,11 @@ namespace PNS {
  * Custom spatial index, holding our board items and allowing for very fast searches. Items
  * are assigned to separate R-Tree subindices depending on their type and spanned layers, reducing
  * overlap and improving search time.
+ *
+ * Copies of an index share their sub-indices until one of them is modified: the first
+ * Add() or Remove() on a shared sub-index gives the modified index its own copy of that
+ * sub-index only. Branching a node therefore only re-inserts the items of the layers the
+ * branch touches. The net map and the item set are still copied in full.
  **/
 class INDEX
 {
@@ -53,6 +59,9 @@ public:
     INDEX();
     ~INDEX();
 
+    INDEX( const INDEX& aOther ) = default;
+    INDEX& operator=( const INDEX& aOther ) = default;
+
     /**
      * Function Add()
      *
@@ -152,9 +161,10 @@ private:
     template <class Visitor>
     int querySingle( int index, const SHAPE* aShape, int aMinDistance, Visitor& aVisitor );
 
+    ///> Returns the sub-index for aItem, created or copied if needed so it can be modified
     ITEM_SHAPE_INDEX* getSubindex( const ITEM* aItem );
 
-    ITEM_SHAPE_INDEX* m_subIndices[MaxSubIndices];
+    std::shared_ptr<ITEM_SHAPE_INDEX> m_subIndices[MaxSubIndices];
     std::map<int, NET_ITEMS_LIST> m_netMap;
     ITEM_SET m_allItems;
 };
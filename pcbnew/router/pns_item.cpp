@@ -21,6 +21,7 @@
 
 #include "pns_item.h"
 #include "pns_line.h"
+#include "pns_item_pool.h"
 
 namespace PNS {
 
@@ -89,4 +90,16 @@ ITEM::~ITEM()
 {
 }
 
+
+void* ITEM::operator new( size_t aSize )
+{
+    return ITEM_POOLS::Allocate( aSize );
+}
+
+
+void ITEM::operator delete( void* aPtr )
+{
+    ITEM_POOLS::Free( aPtr );
+}
+
 }
@@ -94,6 +94,14 @@ public:
 
     virtual ~ITEM();
 
+    /**
+     * Items are allocated from the ITEM_POOLS of the routing session, as the router
+     * creates and deletes lots of them during each iteration. Each item remembers its
+     * pool, so it can be deleted from any thread, after the session ended.
+     */
+    static void* operator new( size_t aSize );
+    static void operator delete( void* aPtr );
+
     /**
      * Function Clone()
      *
@@ -0,0 +1,253 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cassert>
+
+#include "pns_item_pool.h"
+
+namespace PNS {
+
+// Blocks are aligned like the memory returned by new
+static const size_t blockAlignment = alignof( std::max_align_t );
+
+// The pools of a session have one size class every blockAlignment bytes, up to maxPooledSize
+static const size_t maxPooledSize = 512;
+static const size_t sizeClassCount = maxPooledSize / blockAlignment;
+
+// ITEM_POOLS::Allocate() stores the pool of the block (or nullptr for the heap) in front
+// of the memory it returns, padded to keep the memory aligned
+static const size_t headerSize = blockAlignment;
+
+// The pools installed on the thread by the innermost ITEM_POOLS::SCOPE
+static thread_local ITEM_POOLS* currentPools = nullptr;
+
+
+static size_t alignedSize( size_t aSize )
+{
+    return ( aSize + blockAlignment - 1 ) / blockAlignment * blockAlignment;
+}
+
+
+ITEM_POOL::ITEM_POOL( size_t aBlockSize, size_t aBlocksPerChunk ) :
+    m_blockSize( alignedSize( std::max( aBlockSize, sizeof( FREE_BLOCK ) ) ) ),
+    m_blocksPerChunk( std::max<size_t>( aBlocksPerChunk, 1 ) ),
+    m_used( 0 ),
+    m_owner( std::this_thread::get_id() ),
+    m_freeList( nullptr ),
+    m_remoteFrees( nullptr )
+{
+}
+
+
+ITEM_POOL::~ITEM_POOL()
+{
+    assert( GetUsedCount() == 0 );
+}
+
+
+void* ITEM_POOL::Allocate()
+{
+    assert( IsOwnerThread() );
+
+    if( !m_freeList )
+        collectRemoteFrees();
+
+    if( !m_freeList )
+    {
+        // new[] of char returns memory suitably aligned for any object of the chunk size
+        char* chunk = new char[ m_blockSize * m_blocksPerChunk ];
+        m_chunks.emplace_back( chunk );
+
+        // Thread the free list so the blocks are handed out in address order
+        for( size_t ii = m_blocksPerChunk; ii > 0; --ii )
+        {
+            auto block = reinterpret_cast<FREE_BLOCK*>( chunk + ( ii - 1 ) * m_blockSize );
+            block->m_next = m_freeList;
+            m_freeList = block;
+        }
+    }
+
+    FREE_BLOCK* block = m_freeList;
+    m_freeList = block->m_next;
+    m_used++;
+
+    return block;
+}
+
+
+void ITEM_POOL::Free( void* aBlock )
+{
+    if( !aBlock )
+        return;
+
+    auto block = static_cast<FREE_BLOCK*>( aBlock );
+
+    if( !IsOwnerThread() )
+    {
+        // Only pushed here, and only emptied at once by the owner, so there is no ABA issue
+        block->m_next = m_remoteFrees.load( std::memory_order_relaxed );
+
+        while( !m_remoteFrees.compare_exchange_weak( block->m_next, block,
+                                                     std::memory_order_release,
+                                                     std::memory_order_relaxed ) )
+        {
+        }
+
+        return;
+    }
+
+    assert( m_used > 0 );
+
+    block->m_next = m_freeList;
+    m_freeList = block;
+    m_used--;
+}
+
+
+void ITEM_POOL::collectRemoteFrees()
+{
+    FREE_BLOCK* block = m_remoteFrees.exchange( nullptr, std::memory_order_acquire );
+
+    while( block )
+    {
+        FREE_BLOCK* next = block->m_next;
+
+        assert( m_used > 0 );
+
+        block->m_next = m_freeList;
+        m_freeList = block;
+        m_used--;
+
+        block = next;
+    }
+}
+
+
+bool ITEM_POOL::Trim()
+{
+    assert( IsOwnerThread() );
+
+    if( GetUsedCount() > 0 )
+        return false;
+
+    m_freeList = nullptr;
+    m_chunks.clear();
+    return true;
+}
+
+
+size_t ITEM_POOL::GetUsedCount()
+{
+    collectRemoteFrees();
+    return m_used;
+}
+
+
+ITEM_POOLS::ITEM_POOLS()
+{
+    for( size_t ii = 0; ii < sizeClassCount; ++ii )
+        m_pools.push_back( new ITEM_POOL( ( ii + 1 ) * blockAlignment ) );
+}
+
+
+ITEM_POOLS::~ITEM_POOLS()
+{
+    for( ITEM_POOL* pool : m_pools )
+    {
+        // A pool whose blocks are still used by items outliving the session is left
+        // alive, so that they can be freed
+        if( pool->GetUsedCount() == 0 )
+            delete pool;
+    }
+}
+
+
+ITEM_POOL* ITEM_POOLS::ForSize( size_t aSize )
+{
+    if( aSize == 0 || aSize > maxPooledSize )
+        return nullptr;
+
+    return m_pools[ alignedSize( aSize ) / blockAlignment - 1 ];
+}
+
+
+void ITEM_POOLS::Trim()
+{
+    for( ITEM_POOL* pool : m_pools )
+        pool->Trim();
+}
+
+
+size_t ITEM_POOLS::GetUsedCount()
+{
+    size_t used = 0;
+
+    for( ITEM_POOL* pool : m_pools )
+        used += pool->GetUsedCount();
+
+    return used;
+}
+
+
+ITEM_POOLS::SCOPE::SCOPE( ITEM_POOLS& aPools ) :
+    m_previous( currentPools )
+{
+    // The pools of a session share their owner
+    if( !aPools.m_pools.front()->IsOwnerThread() )
+    {
+        for( ITEM_POOL* pool : aPools.m_pools )
+            pool->Adopt();
+    }
+
+    currentPools = &aPools;
+}
+
+
+ITEM_POOLS::SCOPE::~SCOPE()
+{
+    currentPools = m_previous;
+}
+
+
+void* ITEM_POOLS::Allocate( size_t aSize )
+{
+    ITEM_POOL* pool = currentPools ? currentPools->ForSize( aSize + headerSize ) : nullptr;
+    void*      block = pool ? pool->Allocate() : ::operator new( aSize + headerSize );
+
+    *static_cast<ITEM_POOL**>( block ) = pool;
+
+    return static_cast<char*>( block ) + headerSize;
+}
+
+
+void ITEM_POOLS::Free( void* aPtr )
+{
+    if( !aPtr )
+        return;
+
+    void* block = static_cast<char*>( aPtr ) - headerSize;
+
+    if( ITEM_POOL* pool = *static_cast<ITEM_POOL**>( block ) )
+        pool->Free( block );
+    else
+        ::operator delete( block );
+}
+
+}
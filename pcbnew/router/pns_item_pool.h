@@ -0,0 +1,194 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_ITEM_POOL_H
+#define __PNS_ITEM_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace PNS {
+
+/**
+ * Class ITEM_POOL
+ *
+ * Allocates fixed size blocks out of large chunks. The shove and walkaround iterations
+ * create and kill thousands of short-lived segments and vias in the branches of the world
+ * node: taking them from a pool keeps the items of a branch close in memory and makes
+ * their allocation and release a few pointer operations, with the freed blocks reused by
+ * the next branch. The chunks are returned to the system in bulk once all the blocks
+ * are free (see Trim()).
+ *
+ * The pool has no lock: it belongs to one thread at a time (initially the one which
+ * created it), the only one allowed to allocate from it. Blocks freed by other threads are
+ * queued on a lock-free list, and taken back by the owner thread when it runs out of blocks.
+ */
+class ITEM_POOL
+{
+public:
+    /**
+     * @param aBlockSize size of the blocks, rounded up to keep them aligned
+     * @param aBlocksPerChunk number of blocks allocated at once when the pool is empty
+     */
+    ITEM_POOL( size_t aBlockSize, size_t aBlocksPerChunk = 1024 );
+    ~ITEM_POOL();
+
+    ITEM_POOL( const ITEM_POOL& ) = delete;
+    ITEM_POOL& operator=( const ITEM_POOL& ) = delete;
+
+    /**
+     * Function Allocate()
+     *
+     * Returns an uninitialized block. Must be called from the owner thread.
+     */
+    void* Allocate();
+
+    /**
+     * Function Free()
+     *
+     * Returns a block obtained by Allocate() to the pool, from any thread.
+     */
+    void Free( void* aBlock );
+
+    /**
+     * Function Trim()
+     *
+     * Releases all the chunks of the pool if none of its blocks is in use. Must be called
+     * from the owner thread.
+     * @return true if the chunks were released
+     */
+    bool Trim();
+
+    size_t GetBlockSize() const { return m_blockSize; }
+
+    ///> Number of allocated blocks not freed yet. Must be called from the owner thread.
+    size_t GetUsedCount();
+
+    ///> Number of blocks in the chunks of the pool, used or not
+    size_t GetCapacity() const { return m_chunks.size() * m_blocksPerChunk; }
+
+    bool IsOwnerThread() const { return std::this_thread::get_id() == m_owner.load(); }
+
+    /**
+     * Function Adopt()
+     *
+     * Makes the calling thread the owner of the pool. The previous owner must not be
+     * using the pool at the same time.
+     */
+    void Adopt() { m_owner.store( std::this_thread::get_id() ); }
+
+private:
+    struct FREE_BLOCK
+    {
+        FREE_BLOCK* m_next;
+    };
+
+    ///> Moves the blocks freed by other threads to the free list
+    void collectRemoteFrees();
+
+    size_t m_blockSize;
+    size_t m_blocksPerChunk;
+    size_t m_used;
+
+    std::atomic<std::thread::id> m_owner;
+
+    FREE_BLOCK* m_freeList;
+    std::atomic<FREE_BLOCK*> m_remoteFrees;
+    std::vector<std::unique_ptr<char[]>> m_chunks;
+};
+
+
+/**
+ * Class ITEM_POOLS
+ *
+ * The pools of a routing session, one per size class, used by ITEM::operator new() on
+ * the thread where a SCOPE installed them. A ROUTER owns the pools of its session, so the
+ * items of independent routers (such as the ones of the batch router threads) never share
+ * a pool and no pool needs a lock. Items created without pools installed come from the
+ * heap.
+ */
+class ITEM_POOLS
+{
+public:
+    ITEM_POOLS();
+    ~ITEM_POOLS();
+
+    ITEM_POOLS( const ITEM_POOLS& ) = delete;
+    ITEM_POOLS& operator=( const ITEM_POOLS& ) = delete;
+
+    /**
+     * Function ForSize()
+     *
+     * Returns the pool for blocks of aSize bytes (the size is rounded up to a size class),
+     * or nullptr if the blocks are too large to be pooled.
+     */
+    ITEM_POOL* ForSize( size_t aSize );
+
+    /**
+     * Function Trim()
+     *
+     * Calls Trim() on all the pools.
+     */
+    void Trim();
+
+    ///> Number of blocks in use in all the pools
+    size_t GetUsedCount();
+
+    /**
+     * Class SCOPE
+     *
+     * Installs pools on the calling thread for its lifetime, and makes it their owner.
+     * A session is used by one thread at a time, as the calls of a ROUTER are. Scopes
+     * can be nested.
+     */
+    class SCOPE
+    {
+    public:
+        SCOPE( ITEM_POOLS& aPools );
+        ~SCOPE();
+
+    private:
+        ITEM_POOLS* m_previous;
+    };
+
+    /**
+     * Function Allocate()
+     *
+     * Returns aSize bytes from the pools installed on the calling thread, or from the heap
+     * if there are none or the size is too large to be pooled.
+     */
+    static void* Allocate( size_t aSize );
+
+    /**
+     * Function Free()
+     *
+     * Releases memory returned by Allocate(), from any thread.
+     */
+    static void Free( void* aPtr );
+
+private:
+    std::vector<ITEM_POOL*> m_pools;
+};
+
+}
+
+#endif
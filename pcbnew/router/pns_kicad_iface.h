@@ -45,6 +45,11 @@ public:
     ~PNS_KICAD_IFACE();
 
     void SetRouter( PNS::ROUTER* aRouter ) override;
+
+    /**
+     * Sets the tool committing the routed items. Without a host tool (when the router runs
+     * without a GUI), the items are added to and removed from the board directly.
+     */
     void SetHostTool( PCB_TOOL_BASE* aTool );
     void SetDisplayOptions( PCB_DISPLAY_OPTIONS* aDispOptions );
 
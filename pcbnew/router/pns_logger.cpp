@@ -26,6 +26,8 @@
 #include "pns_segment.h"
 #include "pns_solid.h"
 
+#include <fstream>
+
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_rect.h>
@@ -139,6 +141,125 @@ void LOGGER::Log( const VECTOR2I& aStart, const VECTOR2I& aEnd,
 }
 
 
+void LOGGER::LogEvent( EVENT_TYPE aType, const VECTOR2I& aP, const ITEM* aItem,
+                       int aLayer, int aArg )
+{
+    m_theLog << "event " << aType << " " << aP.x << " " << aP.y << " " << aLayer << " " << aArg
+             << " " << ( aItem ? aItem->Kind() : 0 ) << " " << ( aItem ? aItem->Net() : 0 )
+             << std::endl;
+}
+
+
+void LOGGER::LogSettings( const ROUTING_SETTINGS& aSettings, const SIZES_SETTINGS& aSizes )
+{
+    m_theLog << "settings " << aSettings.Mode() << " " << aSettings.OptimizerEffort() << " "
+             << aSettings.ShoveVias() << " " << aSettings.RemoveLoops() << " "
+             << aSettings.SmartPads() << " " << aSettings.JumpOverObstacles() << " "
+             << aSettings.SmoothDraggedSegments() << " " << aSettings.CanViolateDRC() << " "
+             << aSettings.GetFreeAngleMode() << " " << aSettings.InlineDragEnabled() << " "
+             << aSettings.ParallelCandidates() << " " << aSizes.TrackWidth() << " "
+             << aSizes.ViaDiameter() << " " << aSizes.ViaDrill() << " " << aSizes.ViaType()
+             << " " << aSizes.DiffPairWidth() << " " << aSizes.DiffPairGap() << " "
+             << aSizes.DiffPairViaGap() << " " << aSizes.DiffPairViaGapSameAsTraceGap() << " "
+             << aSizes.GetLayerTop() << " " << aSizes.GetLayerBottom() << std::endl;
+}
+
+
+/**
+ * Reads the fields written by LOGGER::LogSettings().
+ */
+static bool parseSettings( std::istringstream& aStream, ROUTING_SETTINGS& aSettings,
+                           SIZES_SETTINGS& aSizes )
+{
+    int v[21];
+
+    for( int& value : v )
+    {
+        if( !( aStream >> value ) )
+            return false;
+    }
+
+    aSettings.SetMode( static_cast<PNS_MODE>( v[0] ) );
+    aSettings.SetOptimizerEffort( static_cast<PNS_OPTIMIZATION_EFFORT>( v[1] ) );
+    aSettings.SetShoveVias( v[2] );
+    aSettings.SetRemoveLoops( v[3] );
+    aSettings.SetSmartPads( v[4] );
+    aSettings.SetJumpOverObstacles( v[5] );
+    aSettings.SetSmoothDraggedSegments( v[6] );
+    aSettings.SetCanViolateDRC( v[7] );
+    aSettings.SetFreeAngleMode( v[8] );
+    aSettings.SetInlineDragEnabled( v[9] );
+    aSettings.SetParallelCandidates( v[10] );
+
+    aSizes.SetTrackWidth( v[11] );
+    aSizes.SetViaDiameter( v[12] );
+    aSizes.SetViaDrill( v[13] );
+    aSizes.SetViaType( static_cast<VIATYPE_T>( v[14] ) );
+    aSizes.SetDiffPairWidth( v[15] );
+    aSizes.SetDiffPairGap( v[16] );
+    aSizes.SetDiffPairViaGap( v[17] );
+    aSizes.SetDiffPairViaGapSameAsTraceGap( v[18] );
+    aSizes.ClearLayerPairs();
+    aSizes.AddLayerPair( v[19], v[20] );
+
+    return true;
+}
+
+
+bool LOGGER::LoadEvents( const std::string& aFilename, std::vector<EVENT_ENTRY>& aEvents )
+{
+    std::ifstream f( aFilename );
+
+    if( !f )
+        return false;
+
+    std::string line;
+
+    // The settings recorded before the next event
+    bool             hasSettings = false;
+    ROUTING_SETTINGS settings;
+    SIZES_SETTINGS   sizes;
+
+    while( std::getline( f, line ) )
+    {
+        std::istringstream ss( line );
+        std::string        tag;
+        int                type;
+        EVENT_ENTRY        evt;
+
+        if( !( ss >> tag ) )
+            continue;
+
+        if( tag == "settings" )
+        {
+            hasSettings = parseSettings( ss, settings, sizes );
+            continue;
+        }
+
+        if( tag != "event" )
+            continue;
+
+        if( ss >> type >> evt.m_p.x >> evt.m_p.y >> evt.m_layer >> evt.m_arg
+               >> evt.m_itemKind >> evt.m_itemNet )
+        {
+            evt.m_type = static_cast<EVENT_TYPE>( type );
+
+            if( hasSettings )
+            {
+                evt.m_hasSettings = true;
+                evt.m_settings = settings;
+                evt.m_sizes = sizes;
+                hasSettings = false;
+            }
+
+            aEvents.push_back( evt );
+        }
+    }
+
+    return true;
+}
+
+
 void LOGGER::dumpShape( const SHAPE* aSh )
 {
     switch( aSh->Type() )
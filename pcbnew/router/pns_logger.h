@@ -29,6 +29,9 @@
 
 #include <math/vector2d.h>
 
+#include "pns_routing_settings.h"
+#include "pns_sizes_settings.h"
+
 class SHAPE_LINE_CHAIN;
 class SHAPE;
 
@@ -39,6 +42,40 @@ class ITEM;
 class LOGGER
 {
 public:
+    ///> Router calls recorded by LogEvent()
+    enum EVENT_TYPE
+    {
+        EVT_START_ROUTE = 0,
+        EVT_START_DRAG,
+        EVT_MOVE,
+        EVT_FIX,
+        EVT_ABORT,
+        EVT_SWITCH_LAYER,
+        EVT_TOGGLE_VIA,
+        EVT_FLIP_POSTURE
+    };
+
+    /**
+     * Struct EVENT_ENTRY
+     *
+     * A recorded router call. The items passed to the router are identified by their kind
+     * and net, to be picked again under the event position when the session is replayed.
+     */
+    struct EVENT_ENTRY
+    {
+        EVENT_TYPE m_type;
+        VECTOR2I   m_p;
+        int        m_layer;     ///< routing layer of a start, new layer of a layer switch
+        int        m_arg;       ///< router/drag mode of a start, forced finish of a fix
+        int        m_itemKind;  ///< ITEM::PnsKind of the start or end item, 0 if none
+        int        m_itemNet;
+
+        ///> Whether the settings below were recorded (for the starts of routes and drags)
+        bool             m_hasSettings = false;
+        ROUTING_SETTINGS m_settings;
+        SIZES_SETTINGS   m_sizes;
+    };
+
     LOGGER();
     ~LOGGER();
 
@@ -53,6 +90,25 @@ public:
     void Log( const VECTOR2I& aStart, const VECTOR2I& aEnd, int aKind = 0,
               const std::string& aName = std::string() );
 
+    void LogEvent( EVENT_TYPE aType, const VECTOR2I& aP, const ITEM* aItem = nullptr,
+                   int aLayer = -1, int aArg = 0 );
+
+    /**
+     * Function LogSettings()
+     *
+     * Records the settings of the router, given to the next event by LoadEvents(). Only
+     * the settings changing the routing results are recorded.
+     */
+    void LogSettings( const ROUTING_SETTINGS& aSettings, const SIZES_SETTINGS& aSizes );
+
+    /**
+     * Function LoadEvents()
+     *
+     * Reads the events of a log written by Save(), skipping its other entries.
+     * @return false if the file cannot be opened
+     */
+    static bool LoadEvents( const std::string& aFilename, std::vector<EVENT_ENTRY>& aEvents );
+
 private:
     void dumpShape( const SHAPE* aSh );
 
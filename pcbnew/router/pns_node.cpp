@@ -104,10 +104,19 @@ int NODE::GetClearance( const ITEM* aA, const ITEM* aB ) const
 }
 
 
+NODE::STATS& NODE::Stats()
+{
+    static STATS stats;
+    return stats;
+}
+
+
 NODE* NODE::Branch()
 {
     NODE* child = new NODE;
 
+    Stats().m_branches++;
+
     wxLogTrace( "PNS", "NODE::branch %p (parent %p)", child, this );
 
     m_children.insert( child );
@@ -119,15 +128,11 @@ NODE* NODE::Branch()
     child->m_maxClearance = m_maxClearance;
 
     // immmediate offspring of the root branch needs not copy anything.
-    // For the rest, deep-copy joints, overridden item map and pointers
-    // to stored items.
+    // For the rest, deep-copy joints, overridden item map and the item and
+    // net lists of the index. Only its untouched layer sub-indices are shared.
     if( !isRoot() )
     {
-        JOINT_MAP::iterator j;
-
-        for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
-            child->m_index->Add( *i );
-
+        *child->m_index = *m_index;
         child->m_joints = m_joints;
         child->m_override = m_override;
     }
@@ -260,6 +265,8 @@ struct NODE::DEFAULT_OBSTACLE_VISITOR : public OBSTACLE_VISITOR
 
 int NODE::QueryColliding( const ITEM* aItem, OBSTACLE_VISITOR& aVisitor )
 {
+    Stats().m_collisionQueries++;
+
     aVisitor.SetWorld( this, NULL );
     m_index->Query( aItem, m_maxClearance, aVisitor );
 
@@ -279,6 +286,8 @@ int NODE::QueryColliding( const ITEM* aItem,
 {
     DEFAULT_OBSTACLE_VISITOR visitor( aObstacles, aItem, aKindMask, aDifferentNetsOnly );
 
+    Stats().m_collisionQueries++;
+
 #ifdef DEBUG
     assert( allocNodes.find( this ) != allocNodes.end() );
 #endif
@@ -1331,6 +1340,9 @@ ITEM *NODE::FindItemByParent( const BOARD_CONNECTED_ITEM* aParent )
 {
     INDEX::NET_ITEMS_LIST* l_cur = m_index->GetItemsForNet( aParent->GetNetCode() );
 
+    if( !l_cur )
+        return NULL;
+
     for( ITEM*item : *l_cur )
         if( item->Parent() == aParent )
             return item;
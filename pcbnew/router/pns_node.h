@@ -22,6 +22,8 @@
 #ifndef __PNS_NODE_H
 #define __PNS_NODE_H
 
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <list>
 #include <unordered_set>
@@ -140,9 +142,35 @@ public:
     typedef std::vector<ITEM*>          ITEM_VECTOR;
     typedef std::vector<OBSTACLE>       OBSTACLES;
 
+    /**
+     * Struct STATS
+     *
+     * Counts the branches made and the collision queries run by all the nodes, to
+     * profile the router (e.g. when replaying recorded sessions).
+     */
+    struct STATS
+    {
+        std::atomic<uint64_t> m_branches;
+        std::atomic<uint64_t> m_collisionQueries;
+
+        STATS() :
+            m_branches( 0 ),
+            m_collisionQueries( 0 )
+        {}
+
+        void Reset()
+        {
+            m_branches = 0;
+            m_collisionQueries = 0;
+        }
+    };
+
     NODE();
     ~NODE();
 
+    ///> Returns the counters shared by all the nodes
+    static STATS& Stats();
+
     ///> Returns the expected clearance between items a and b.
     int GetClearance( const ITEM* aA, const ITEM* aB ) const;
 
@@ -128,6 +128,7 @@ OPTIMIZER::OPTIMIZER( NODE* aWorld ) :
     m_collisionKindMask( ITEM::ANY_T ),
     m_effortLevel( MERGE_SEGMENTS ),
     m_keepPostures( false ),
+    m_useCache( false ),
     m_restrictAreaActive( false )
 {
 }
@@ -138,21 +139,35 @@ OPTIMIZER::~OPTIMIZER()
 }
 
 
+void OPTIMIZER::SetWorld( NODE* aNode )
+{
+    if( aNode != m_world )
+        ClearCache();
+
+    m_world = aNode;
+}
+
+
 struct OPTIMIZER::CACHE_VISITOR
 {
     CACHE_VISITOR( const ITEM* aOurItem, NODE* aNode, int aMask ) :
         m_ourItem( aOurItem ),
         m_collidingItem( NULL ),
         m_node( aNode ),
-        m_mask( aMask )
-    {}
+        m_mask( aMask ),
+        m_extraClearance( 0 )
+    {
+        // The shape of a line has no width (same as in NODE::CheckColliding())
+        if( aOurItem->Kind() == ITEM::LINE_T )
+            m_extraClearance = static_cast<const LINE*>( aOurItem )->Width() / 2;
+    }
 
     bool operator()( ITEM* aOtherItem )
     {
         if( !( m_mask & aOtherItem->Kind() ) )
             return true;
 
-        int clearance = m_node->GetClearance( aOtherItem, m_ourItem );
+        int clearance = m_extraClearance + m_node->GetClearance( aOtherItem, m_ourItem );
 
         if( !aOtherItem->Collide( m_ourItem, clearance ) )
             return true;
@@ -165,6 +180,7 @@ struct OPTIMIZER::CACHE_VISITOR
     ITEM* m_collidingItem;
     NODE* m_node;
     int m_mask;
+    int m_extraClearance;
 };
 
 
@@ -191,8 +207,9 @@ void OPTIMIZER::removeCachedSegments( LINE* aLine, int aStartVertex, int aEndVer
     for( int i = aStartVertex; i < aEndVertex - 1; i++ )
     {
         SEGMENT* s = segs[i];
-        m_cacheTags.erase( s );
-        m_cache.Remove( s );
+
+        if( m_cacheTags.erase( s ) )
+            m_cache.Remove( s );
     }
 }
 
@@ -201,6 +218,8 @@ void OPTIMIZER::CacheRemove( ITEM* aItem )
 {
     if( aItem->Kind() == ITEM::LINE_T )
         removeCachedSegments( static_cast<LINE*>( aItem ) );
+    else if( m_cacheTags.erase( aItem ) )
+        m_cache.Remove( aItem );
 }
 
 
@@ -215,17 +234,20 @@ void OPTIMIZER::ClearCache( bool aStaticOnly  )
     if( !aStaticOnly )
     {
         m_cacheTags.clear();
-        m_cache.Clear();
+        m_cache.RemoveAll();
         return;
     }
 
-    for( CachedItemTags::iterator i = m_cacheTags.begin(); i!= m_cacheTags.end(); ++i )
+    for( CachedItemTags::iterator i = m_cacheTags.begin(); i != m_cacheTags.end(); )
     {
-        if( i->second.m_isStatic )
+        if( !i->second.m_isStatic )
         {
-            m_cache.Remove( i->first );
-            m_cacheTags.erase( i->first );
+            ++i;
+            continue;
         }
+
+        m_cache.Remove( i->first );
+        i = m_cacheTags.erase( i );
     }
 }
 
@@ -386,11 +408,11 @@ bool OPTIMIZER::checkColliding( ITEM* aItem, bool aUpdateCache )
 {
     CACHE_VISITOR v( aItem, m_world, m_collisionKindMask );
 
-    return static_cast<bool>( m_world->CheckColliding( aItem ) );
-
-#if 0
-    // something is wrong with the cache, need to investigate.
-    m_cache.Query( aItem->Shape(), m_world->GetMaxClearance(), v, false );
+    // The obstacles found in the world are checked first, they are likely to be hit again
+    // by the next candidate paths.  The shape of a line has no width, the query area is
+    // inflated by its half width
+    if( m_useCache )
+        m_cache.Query( aItem->Shape(), m_world->GetMaxClearance() + v.m_extraClearance, v, false );
 
     if( !v.m_collidingItem )
     {
@@ -398,7 +420,7 @@ bool OPTIMIZER::checkColliding( ITEM* aItem, bool aUpdateCache )
 
         if( obs )
         {
-            if( aUpdateCache )
+            if( aUpdateCache && m_useCache )
                 cacheAdd( obs->m_item );
 
             return true;
@@ -411,7 +433,6 @@ bool OPTIMIZER::checkColliding( ITEM* aItem, bool aUpdateCache )
     }
 
     return false;
-#endif
 }
 
 
@@ -25,7 +25,7 @@
 #include <unordered_map>
 #include <memory>
 
-#include <geometry/shape_index_list.h>
+#include <geometry/shape_index.h>
 #include <geometry/shape_line_chain.h>
 
 #include "range.h"
@@ -108,11 +108,35 @@ public:
     bool Optimize( DIFF_PAIR* aPair );
 
 
-    void SetWorld( NODE* aNode ) { m_world = aNode; }
+    /**
+     * Sets the node the lines are optimized in. The cached obstacles are dropped, as they
+     * may not exist in the new node.
+     */
+    void SetWorld( NODE* aNode );
+
     void CacheStaticItem( ITEM* aItem );
+
+    /**
+     * Removes an item (or the segments of a line) from the obstacle cache. Must be called
+     * before the item is removed from the world.
+     */
     void CacheRemove( ITEM* aItem );
     void ClearCache( bool aStaticOnly = false );
 
+    /**
+     * Enables the obstacle cache. When disabled (the default), each candidate path is
+     * checked against the world only. The cache only saves world queries when the same
+     * optimizer is kept for many lines of the same node, while the optimizers of the
+     * router are created for each optimization.
+     */
+    void SetUseCache( bool aEnabled )
+    {
+        m_useCache = aEnabled;
+
+        if( !aEnabled )
+            ClearCache();
+    }
+
     void SetCollisionMask( int aMask )
     {
         m_collisionKindMask = aMask;
@@ -131,8 +155,6 @@ public:
     }
 
 private:
-    static const int MaxCachedItems = 256;
-
     typedef std::vector<SHAPE_LINE_CHAIN> BREAKOUT_LIST;
 
     struct CACHE_VISITOR;
@@ -168,7 +190,8 @@ private:
 
     ITEM* findPadOrVia( int aLayer, int aNet, const VECTOR2I& aP ) const;
 
-    SHAPE_INDEX_LIST<ITEM*> m_cache;
+    ///> Obstacles already found in the world, checked before querying the world again
+    SHAPE_INDEX<ITEM*> m_cache;
 
     typedef std::unordered_map<ITEM*, CACHED_ITEM> CachedItemTags;
     CachedItemTags m_cacheTags;
@@ -176,6 +199,7 @@ private:
     int m_collisionKindMask;
     int m_effortLevel;
     bool m_keepPostures;
+    bool m_useCache;
 
     BOX2I m_restrictArea;
     bool m_restrictAreaActive;
@@ -60,7 +60,9 @@ static ROUTER* theRouter;
 
 ROUTER::ROUTER()
 {
-    theRouter = this;
+    // The routers of the batch router must not replace the one of the routing tools
+    if( !theRouter )
+        theRouter = this;
 
     m_state = IDLE;
     m_mode = PNS_MODE_ROUTE_SINGLE;
@@ -84,12 +86,16 @@ ROUTER* ROUTER::GetInstance()
 ROUTER::~ROUTER()
 {
     ClearWorld();
-    theRouter = nullptr;
+
+    if( theRouter == this )
+        theRouter = nullptr;
 }
 
 
 void ROUTER::SyncWorld()
 {
+    ITEM_POOLS::SCOPE poolScope( m_itemPools );
+
     ClearWorld();
 
     m_world = std::unique_ptr<NODE>( new NODE );
@@ -99,6 +105,8 @@ void ROUTER::SyncWorld()
 
 void ROUTER::ClearWorld()
 {
+    ITEM_POOLS::SCOPE poolScope( m_itemPools );
+
     if( m_world )
     {
         m_world->KillChildren();
@@ -106,6 +114,9 @@ void ROUTER::ClearWorld()
     }
 
     m_placer.reset();
+
+    // The world was the last owner of router items, release their memory
+    m_itemPools.Trim();
 }
 
 
@@ -126,6 +137,9 @@ const ITEM_SET ROUTER::QueryHoverItems( const VECTOR2I& aP )
 
 bool ROUTER::StartDragging( const VECTOR2I& aP, ITEM* aStartItem, int aDragMode )
 {
+    ITEM_POOLS::SCOPE poolScope( m_itemPools );
+
+    logEvent( LOGGER::EVT_START_DRAG, aP, aStartItem, -1, aDragMode );
 
     if( aDragMode & DM_FREE_ANGLE )
         m_forceMarkObstaclesMode = true;
@@ -175,6 +189,9 @@ bool ROUTER::isStartingPointRoutable( const VECTOR2I& aWhere, int aLayer )
 
 bool ROUTER::StartRouting( const VECTOR2I& aP, ITEM* aStartItem, int aLayer )
 {
+    ITEM_POOLS::SCOPE poolScope( m_itemPools );
+
+    logEvent( LOGGER::EVT_START_ROUTE, aP, aStartItem, aLayer, m_mode );
 
     if( ! isStartingPointRoutable( aP, aLayer ) )
     {
@@ -230,6 +247,10 @@ void ROUTER::DisplayItems( const ITEM_SET& aItems )
 
 void ROUTER::Move( const VECTOR2I& aP, ITEM* endItem )
 {
+    ITEM_POOLS::SCOPE poolScope( m_itemPools );
+
+    logEvent( LOGGER::EVT_MOVE, aP, endItem );
+
     m_currentEnd = aP;
 
     switch( m_state )
@@ -317,6 +338,8 @@ void ROUTER::updateView( NODE* aNode, ITEM_SET& aCurrent, bool aDragging )
 
 void ROUTER::UpdateSizes( const SIZES_SETTINGS& aSizes )
 {
+    ITEM_POOLS::SCOPE poolScope( m_itemPools );
+
     m_sizes = aSizes;
 
     // Change track/via size settings
@@ -356,6 +379,8 @@ void ROUTER::movePlacing( const VECTOR2I& aP, ITEM* aEndItem )
 
 void ROUTER::CommitRouting( NODE* aNode )
 {
+    ITEM_POOLS::SCOPE poolScope( m_itemPools );
+
     NODE::ITEM_VECTOR removed, added;
 
     aNode->GetUpdatedItems( removed, added );
@@ -373,8 +398,12 @@ void ROUTER::CommitRouting( NODE* aNode )
 
 bool ROUTER::FixRoute( const VECTOR2I& aP, ITEM* aEndItem, bool aForceFinish )
 {
+    ITEM_POOLS::SCOPE poolScope( m_itemPools );
+
     bool rv = false;
 
+    logEvent( LOGGER::EVT_FIX, aP, aEndItem, -1, aForceFinish ? 1 : 0 );
+
     switch( m_state )
     {
     case ROUTE_TRACK:
@@ -398,6 +427,8 @@ bool ROUTER::FixRoute( const VECTOR2I& aP, ITEM* aEndItem, bool aForceFinish )
 
 void ROUTER::StopRouting()
 {
+    ITEM_POOLS::SCOPE poolScope( m_itemPools );
+
     // Update the ratsnest with new changes
 
     if( m_placer )
@@ -413,6 +444,8 @@ void ROUTER::StopRouting()
     if( !RoutingInProgress() )
         return;
 
+    logEvent( LOGGER::EVT_ABORT, m_currentEnd );
+
     m_placer.reset();
     m_dragger.reset();
 
@@ -426,6 +459,10 @@ void ROUTER::StopRouting()
 
 void ROUTER::FlipPosture()
 {
+    ITEM_POOLS::SCOPE poolScope( m_itemPools );
+
+    logEvent( LOGGER::EVT_FLIP_POSTURE, m_currentEnd );
+
     if( m_state == ROUTE_TRACK )
     {
         m_placer->FlipPosture();
@@ -435,6 +472,10 @@ void ROUTER::FlipPosture()
 
 void ROUTER::SwitchLayer( int aLayer )
 {
+    ITEM_POOLS::SCOPE poolScope( m_itemPools );
+
+    logEvent( LOGGER::EVT_SWITCH_LAYER, m_currentEnd, nullptr, aLayer );
+
     switch( m_state )
     {
     case ROUTE_TRACK:
@@ -448,6 +489,10 @@ void ROUTER::SwitchLayer( int aLayer )
 
 void ROUTER::ToggleViaPlacement()
 {
+    ITEM_POOLS::SCOPE poolScope( m_itemPools );
+
+    logEvent( LOGGER::EVT_TOGGLE_VIA, m_currentEnd );
+
     if( m_state == ROUTE_TRACK )
     {
         bool toggle = !m_placer->IsPlacingVia();
@@ -493,6 +538,23 @@ void ROUTER::DumpLog()
 
     if( logger )
         logger->Save( "/tmp/shove.log" );
+
+    if( !m_eventLogFile.empty() )
+        m_eventLog.Save( m_eventLogFile );
+}
+
+
+void ROUTER::logEvent( LOGGER::EVENT_TYPE aType, const VECTOR2I& aP, const ITEM* aItem,
+                       int aLayer, int aArg )
+{
+    if( m_eventLogFile.empty() )
+        return;
+
+    // The replay needs the settings the route or drag started with
+    if( aType == LOGGER::EVT_START_ROUTE || aType == LOGGER::EVT_START_DRAG )
+        m_eventLog.LogSettings( m_settings, m_sizes );
+
+    m_eventLog.LogEvent( aType, aP, aItem, aLayer, aArg );
 }
 
 
@@ -528,6 +590,8 @@ void ROUTER::SetInterface( ROUTER_IFACE *aIface )
 
 void ROUTER::BreakSegment( ITEM *aItem, const VECTOR2I& aP )
 {
+    ITEM_POOLS::SCOPE poolScope( m_itemPools );
+
     NODE *node = m_world->Branch();
 
     LINE_PLACER placer( this );
@@ -25,6 +25,7 @@
 #include <list>
 
 #include <memory>
+#include <string>
 #include <core/optional.h>
 #include <boost/unordered_set.hpp>
 
@@ -33,8 +34,10 @@
 #include "pns_routing_settings.h"
 #include "pns_sizes_settings.h"
 #include "pns_item.h"
+#include "pns_item_pool.h"
 #include "pns_itemset.h"
 #include "pns_node.h"
+#include "pns_logger.h"
 
 namespace KIGFX
 {
@@ -160,6 +163,15 @@ public:
 
     void DumpLog();
 
+    /**
+     * Records the routing calls in the event log, saved to aFilename by DumpLog() and
+     * replayed by the router_replay tool of qa_pcbnew_tools. Nothing is recorded if
+     * aFilename is empty.
+     */
+    void SetEventLogFile( const std::string& aFilename ) { m_eventLogFile = aFilename; }
+
+    LOGGER* EventLog() { return &m_eventLog; }
+
     RULE_RESOLVER* GetRuleResolver() const
     {
         return m_iface->GetRuleResolver();
@@ -244,12 +256,18 @@ private:
 
     void highlightCurrent( bool enabled );
 
+    void logEvent( LOGGER::EVENT_TYPE aType, const VECTOR2I& aP, const ITEM* aItem = nullptr,
+                   int aLayer = -1, int aArg = 0 );
+
     void markViolations( NODE* aNode, ITEM_SET& aCurrent, NODE::ITEM_VECTOR& aRemoved );
     bool isStartingPointRoutable( const VECTOR2I& aWhere, int aLayer );
 
     VECTOR2I m_currentEnd;
     RouterState m_state;
 
+    ///> Pools of the items created by the router calls, destroyed after all the nodes
+    ITEM_POOLS m_itemPools;
+
     std::unique_ptr< NODE > m_world;
     NODE*                   m_lastNode;
 
@@ -265,6 +283,9 @@ private:
     bool m_violation;
     bool m_forceMarkObstaclesMode = false;
 
+    std::string m_eventLogFile;
+    LOGGER m_eventLog;
+
     ROUTING_SETTINGS m_settings;
     SIZES_SETTINGS m_sizes;
     ROUTER_MODE m_mode;
@@ -142,6 +142,12 @@ public:
     bool GetSnapToTracks() const { return m_snapToTracks; }
     bool GetSnapToPads() const { return m_snapToPads; }
 
+    ///> Returns true if the walkaround directions are evaluated concurrently.
+    bool ParallelCandidates() const { return m_parallelCandidates; }
+
+    ///> Enables/disables the concurrent evaluation of the walkaround directions.
+    void SetParallelCandidates( bool aEnable ) { m_parallelCandidates = aEnable; }
+
 private:
     bool m_shoveVias;
     bool m_startDiagonal;
@@ -156,6 +162,7 @@ private:
     bool m_inlineDragEnabled;
     bool m_snapToTracks;
     bool m_snapToPads;
+    bool m_parallelCandidates;
 
     PNS_MODE m_routingMode;
     PNS_OPTIMIZATION_EFFORT m_optimizerEffort;
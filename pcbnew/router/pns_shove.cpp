@@ -1389,6 +1389,7 @@ void SHOVE::runOptimizer( NODE* aNode )
 
                 if( optimizer.Optimize( &line, &optimized ) )
                 {
+                    optimizer.CacheRemove( &line );
                     aNode->Remove( line );
                     line.SetShape( optimized.CLine() );
                     aNode->Add( line );
@@ -38,6 +38,7 @@ using namespace std::placeholders;
 #include <dialogs/dialog_pns_length_tuning_settings.h>
 #include <dialogs/dialog_track_via_size.h>
 #include <base_units.h>
+#include <advanced_config.h>
 #include <bitmaps.h>
 #include <hotkeys.h>
 
@@ -104,7 +105,13 @@ void TOOL_BASE::Reset( RESET_REASON aReason )
     m_router->ClearWorld();
     m_router->SyncWorld();
     m_router->LoadSettings( m_savedSettings );
+
+    // Only ever turned on from the advanced config, which must not override m_savedSettings
+    if( ADVANCED_CFG::GetCfg().m_routerParallelCandidates )
+        m_router->Settings().SetParallelCandidates( true );
+
     m_router->UpdateSizes( m_savedSizes );
+    m_router->SetEventLogFile( ADVANCED_CFG::GetCfg().m_routerEventLog.ToStdString() );
 
     m_gridHelper = new GRID_HELPER( frame() );
 }
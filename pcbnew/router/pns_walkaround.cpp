@@ -20,6 +20,7 @@
  */
 
 #include <core/optional.h>
+#include <thread_pool.h>
 
 #include <geometry/shape_line_chain.h>
 
@@ -58,6 +59,8 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
         aWindingDirection ? m_currentObstacle[0] : m_currentObstacle[1];
 
     bool& prev_recursive = aWindingDirection ? m_recursiveCollision[0] : m_recursiveCollision[1];
+    int& blockage_count =
+        aWindingDirection ? m_recursiveBlockageCount[0] : m_recursiveBlockageCount[1];
 
     if( !current_obs )
         return DONE;
@@ -68,9 +71,9 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
 
     if( ( current_obs->m_hull ).PointInside( last ) || ( current_obs->m_hull ).PointOnEdge( last ) )
     {
-        m_recursiveBlockageCount++;
+        blockage_count++;
 
-        if( m_recursiveBlockageCount < 3 )
+        if( blockage_count < 3 )
             aPath.Line().Append( current_obs->m_hull.NearestPoint( last ) );
         else
         {
@@ -88,12 +91,16 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
         return STUCK;
 
 #ifdef DEBUG
-    m_logger.NewGroup( aWindingDirection ? "walk-cw" : "walk-ccw", m_iteration );
-    m_logger.Log( &path_walk[0], 0, "path-walk" );
-    m_logger.Log( &path_pre[0], 1, "path-pre" );
-    m_logger.Log( &path_post[0], 4, "path-post" );
-    m_logger.Log( &current_obs->m_hull, 2, "hull" );
-    m_logger.Log( current_obs->m_item, 3, "item" );
+    // The logger is not thread safe, the directions walked concurrently are not logged
+    if( !Settings().ParallelCandidates() )
+    {
+        m_logger.NewGroup( aWindingDirection ? "walk-cw" : "walk-ccw", m_iteration );
+        m_logger.Log( &path_walk[0], 0, "path-walk" );
+        m_logger.Log( &path_pre[0], 1, "path-pre" );
+        m_logger.Log( &path_post[0], 4, "path-post" );
+        m_logger.Log( &current_obs->m_hull, 2, "hull" );
+        m_logger.Log( current_obs->m_item, 3, "item" );
+    }
 #endif
 
     int len_pre = path_walk[0].Length();
@@ -144,6 +151,44 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
 }
 
 
+WALKAROUND::WALKAROUND_STATUS WALKAROUND::walkToEnd( LINE& aPath, bool aWindingDirection,
+                                                    int& aSteps )
+{
+    WALKAROUND_STATUS st = IN_PROGRESS;
+
+    for( aSteps = 0; aSteps < m_iterationLimit; aSteps++ )
+    {
+        st = singleStep( aPath, aWindingDirection );
+
+        if( st != IN_PROGRESS )
+            break;
+    }
+
+    return st;
+}
+
+
+LINE& WALKAROUND::serialChoice( LINE& aPathCw, WALKAROUND_STATUS aStatusCw, int aStepsCw,
+                                LINE& aPathCcw, WALKAROUND_STATUS aStatusCcw, int aStepsCcw ) const
+{
+    bool              cwFirst = aStepsCw <= aStepsCcw;
+    WALKAROUND_STATUS firstStatus = cwFirst ? aStatusCw : aStatusCcw;
+    WALKAROUND_STATUS otherStatus = cwFirst ? aStatusCcw : aStatusCw;
+
+    // The serial walk stops at the first direction to get around, unless both get
+    // around at the same iteration
+    if( firstStatus == DONE && !( aStepsCw == aStepsCcw && otherStatus == DONE ) )
+        return cwFirst ? aPathCw : aPathCcw;
+
+    // A stuck direction is no longer walked, the other one may still get around
+    if( firstStatus == STUCK && otherStatus == DONE )
+        return cwFirst ? aPathCcw : aPathCw;
+
+    // Both got around at once, both got stuck or the iteration limit was reached
+    return aPathCw.CLine().Length() < aPathCcw.CLine().Length() ? aPathCw : aPathCcw;
+}
+
+
 WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
         LINE& aWalkPath, bool aOptimize )
 {
@@ -164,7 +209,8 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
     start( aInitialPath );
 
     m_currentObstacle[0] = m_currentObstacle[1] = nearestObstacle( aInitialPath );
-    m_recursiveBlockageCount = 0;
+    m_recursiveCollision[0] = m_recursiveCollision[1] = false;
+    m_recursiveBlockageCount[0] = m_recursiveBlockageCount[1] = 0;
 
     aWalkPath = aInitialPath;
 
@@ -177,38 +223,54 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
         m_forceSingleDirection = false;
     }
 
-    while( m_iteration < m_iterationLimit )
+    if( Settings().ParallelCandidates() && !m_forceSingleDirection && !m_forceLongerPath )
     {
-        if( s_cw != STUCK )
-            s_cw = singleStep( path_cw, true );
+        // Walk both directions to their end at once, then keep the path the serial walk
+        // below picks: each direction only depends on its own steps
+        TASK_GROUP group( THREAD_POOL::GetInstance() );
+        int        n_cw, n_ccw;
 
-        if( s_ccw != STUCK )
-            s_ccw = singleStep( path_ccw, false );
+        group.Run( [&]() { s_ccw = walkToEnd( path_ccw, false, n_ccw ); } );
+        s_cw = walkToEnd( path_cw, true, n_cw );
+        group.Wait();
 
-        if( ( s_cw == DONE && s_ccw == DONE ) || ( s_cw == STUCK && s_ccw == STUCK ) )
+        aWalkPath = serialChoice( path_cw, s_cw, n_cw, path_ccw, s_ccw, n_ccw );
+    }
+    else
+    {
+        while( m_iteration < m_iterationLimit )
         {
-            int len_cw  = path_cw.CLine().Length();
-            int len_ccw = path_ccw.CLine().Length();
+            if( s_cw != STUCK )
+                s_cw = singleStep( path_cw, true );
 
-            if( m_forceLongerPath )
-                aWalkPath = ( len_cw > len_ccw ? path_cw : path_ccw );
-            else
-                aWalkPath = ( len_cw < len_ccw ? path_cw : path_ccw );
+            if( s_ccw != STUCK )
+                s_ccw = singleStep( path_ccw, false );
 
-            break;
-        }
-        else if( s_cw == DONE && !m_forceLongerPath )
-        {
-            aWalkPath = path_cw;
-            break;
-        }
-        else if( s_ccw == DONE && !m_forceLongerPath )
-        {
-            aWalkPath = path_ccw;
-            break;
-        }
+            if( ( s_cw == DONE && s_ccw == DONE ) || ( s_cw == STUCK && s_ccw == STUCK ) )
+            {
+                int len_cw  = path_cw.CLine().Length();
+                int len_ccw = path_ccw.CLine().Length();
+
+                if( m_forceLongerPath )
+                    aWalkPath = ( len_cw > len_ccw ? path_cw : path_ccw );
+                else
+                    aWalkPath = ( len_cw < len_ccw ? path_cw : path_ccw );
 
-        m_iteration++;
+                break;
+            }
+            else if( s_cw == DONE && !m_forceLongerPath )
+            {
+                aWalkPath = path_cw;
+                break;
+            }
+            else if( s_ccw == DONE && !m_forceLongerPath )
+            {
+                aWalkPath = path_ccw;
+                break;
+            }
+
+            m_iteration++;
+        }
     }
 
     if( m_iteration == m_iterationLimit )
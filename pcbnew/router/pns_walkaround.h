@@ -49,7 +49,7 @@ public:
         m_itemMask = ITEM::ANY_T;
 
         // Initialize other members, to avoid uninitialized variables.
-        m_recursiveBlockageCount = 0;
+        m_recursiveBlockageCount[0] = m_recursiveBlockageCount[1] = 0;
         m_recursiveCollision[0] = m_recursiveCollision[1] = false;
         m_iteration = 0;
         m_forceCw = false;
@@ -130,11 +130,30 @@ private:
     void start( const LINE& aInitialPath );
 
     WALKAROUND_STATUS singleStep( LINE& aPath, bool aWindingDirection );
+
+    /**
+     * Function walkToEnd()
+     *
+     * Steps in a single direction until the path is done, stuck or the iteration
+     * limit is reached. Only reads the world, so both directions can be walked at once.
+     * @param aSteps is set to the iteration the walk ended at, or to the limit.
+     */
+    WALKAROUND_STATUS walkToEnd( LINE& aPath, bool aWindingDirection, int& aSteps );
+
+    /**
+     * Function serialChoice()
+     *
+     * Returns the path the serial walk of Route() keeps, given how both directions
+     * walked to their end.
+     */
+    LINE& serialChoice( LINE& aPathCw, WALKAROUND_STATUS aStatusCw, int aStepsCw,
+                        LINE& aPathCcw, WALKAROUND_STATUS aStatusCcw, int aStepsCcw ) const;
+
     NODE::OPT_OBSTACLE nearestObstacle( const LINE& aPath );
 
     NODE* m_world;
 
-    int m_recursiveBlockageCount;
+    int m_recursiveBlockageCount[2];
     int m_iteration;
     int m_iterationLimit;
     int m_itemMask;
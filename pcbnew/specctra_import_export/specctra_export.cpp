@@ -1144,11 +1144,11 @@ void SPECCTRA_DB::FromBOARD( BOARD* aBoard )
             mainPolygon->layer_id = layerIds[ kicadLayer2pcb[ item->GetLayer() ] ];
 
             // Handle the main outlines
-            SHAPE_POLY_SET::ITERATOR iterator;
+            SHAPE_POLY_SET::CONST_ITERATOR iterator;
             wxPoint startpoint;
             bool is_first_point = true;
 
-            for( iterator = item->IterateWithHoles(); iterator; iterator++ )
+            for( iterator = item->CIterateWithHoles(); iterator; iterator++ )
             {
                 wxPoint point( iterator->x, iterator->y );
 
@@ -1263,11 +1263,11 @@ void SPECCTRA_DB::FromBOARD( BOARD* aBoard )
                 mainPolygon->layer_id = layerIds[ kicadLayer2pcb[ layer ] ];
 
                 // Handle the main outlines
-                SHAPE_POLY_SET::ITERATOR iterator;
+                SHAPE_POLY_SET::CONST_ITERATOR iterator;
                 bool is_first_point = true;
                 wxPoint startpoint;
 
-                for( iterator = item->IterateWithHoles(); iterator; iterator++ )
+                for( iterator = item->CIterateWithHoles(); iterator; iterator++ )
                 {
                     wxPoint point( iterator->x, iterator->y );
 
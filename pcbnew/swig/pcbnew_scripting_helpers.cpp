@@ -42,6 +42,8 @@
 #include <stdlib.h>
 #include <pcb_draw_panel_gal.h>
 #include <action_plugin.h>
+#include <board_commit.h>
+#include <router/pns_batch_router.h>
 
 static PCB_EDIT_FRAME* s_PcbEditFrame = NULL;
 
@@ -135,6 +137,32 @@ bool ImportSpecctraSES( wxString& aFullFilename )
 }
 
 
+int AutorouteBoard( BOARD* aBoard, double aNetTimeBudget, int aRipupPasses )
+{
+    if( !aBoard )
+        return 0;
+
+    // The changes of the board of the editor go through a commit, for the undo list, the
+    // view and the DRC
+    std::unique_ptr<BOARD_COMMIT> commit;
+
+    if( s_PcbEditFrame && aBoard == s_PcbEditFrame->GetBoard() )
+        commit.reset( new BOARD_COMMIT( s_PcbEditFrame ) );
+
+    PNS_BATCH_ROUTER router( aBoard, commit.get() );
+
+    router.SetNetTimeBudget( std::chrono::milliseconds( KiROUND( aNetTimeBudget * 1000.0 ) ) );
+    router.SetRipupPasses( aRipupPasses );
+
+    int routed = router.Route();
+
+    if( commit )
+        commit->Push( _( "Autoroute" ) );
+
+    return routed;
+}
+
+
 bool ArchiveModulesOnBoard( bool aStoreInNewLib, const wxString& aLibName, wxString* aLibPath )
 {
     if( s_PcbEditFrame )
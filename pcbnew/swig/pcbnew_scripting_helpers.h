@@ -66,6 +66,21 @@ bool ExportSpecctraDSN( wxString& aFullFilename );
  */
 bool ImportSpecctraSES( wxString& aFullFilename );
 
+/**
+ * Routes the unconnected ratsnest edges of a board with the walkaround mode of the
+ * interactive router, several connections at a time, and rips up the routes in the way of
+ * the failed connections to route them again. Only the connections between items sharing
+ * a copper layer are routed.
+ * If aBoard is the board of the editor, the changes are pushed as one commit (and can be
+ * undone); call Refresh() afterwards.
+ * @param aBoard is the board to route
+ * @param aNetTimeBudget is the time in seconds after which the remaining connections of a
+ *                       net are given up
+ * @param aRipupPasses is the number of rip-up and retry passes
+ * @return the number of routed connections
+ */
+int AutorouteBoard( BOARD* aBoard, double aNetTimeBudget = 2.0, int aRipupPasses = 2 );
+
 /**
  * Function ArchiveModulesOnBoard
  * Save modules in a library:
@@ -577,7 +577,7 @@ void POINT_EDITOR::updateItem() const
 
         for( int i = 0; i < outline.TotalVertices(); ++i )
         {
-            if( outline.Vertex( i ) != m_editPoints->Point( i ).GetPosition() )
+            if( outline.CVertex( i ) != m_editPoints->Point( i ).GetPosition() )
                 zone->SetNeedRefill( true );
 
             outline.Vertex( i ) = m_editPoints->Point( i ).GetPosition();
@@ -929,11 +929,11 @@ bool POINT_EDITOR::addCornerCondition( const SELECTION& aSelection )
 static std::pair<bool, SHAPE_POLY_SET::VERTEX_INDEX>
 findVertex( SHAPE_POLY_SET& aPolySet, const EDIT_POINT& aPoint )
 {
-    for( auto it = aPolySet.IterateWithHoles(); it; ++it )
+    for( auto it = aPolySet.CIterateWithHoles(); it; ++it )
     {
         auto vertexIdx = it.GetIndex();
 
-        if( aPolySet.Vertex( vertexIdx ) == aPoint.GetPosition() )
+        if( aPolySet.CVertex( vertexIdx ) == aPoint.GetPosition() )
             return std::make_pair( true, vertexIdx );
     }
 
@@ -1022,7 +1022,7 @@ int POINT_EDITOR::addCorner( const TOOL_EVENT& aEvent )
         // and therefore break this segment into two segments
 
         // Object to iterate through the corners of the outlines (main contour and its holes)
-        SHAPE_POLY_SET::ITERATOR iterator = zoneOutline->Iterate( 0,
+        SHAPE_POLY_SET::CONST_ITERATOR iterator = zoneOutline->CIterate( 0,
                 zoneOutline->OutlineCount()-1, /* IterateHoles */ true );
         int curr_idx = 0;
 
@@ -1037,7 +1037,7 @@ int POINT_EDITOR::addCorner( const TOOL_EVENT& aEvent )
                 firstPointInContour = curr_idx+1;     // Prepare next contour analysis
             }
 
-            SEG curr_segment( zoneOutline->Vertex( curr_idx ), zoneOutline->Vertex( jj ) );
+            SEG curr_segment( zoneOutline->CVertex( curr_idx ), zoneOutline->CVertex( jj ) );
 
             unsigned int distance = curr_segment.Distance( cursorPos );
 
@@ -1050,8 +1050,8 @@ int POINT_EDITOR::addCorner( const TOOL_EVENT& aEvent )
         }
 
         // Find the point on the closest segment
-        VECTOR2I sideOrigin = zoneOutline->Vertex( nearestIdx );
-        VECTOR2I sideEnd = zoneOutline->Vertex( nextNearestIdx );
+        VECTOR2I sideOrigin = zoneOutline->CVertex( nearestIdx );
+        VECTOR2I sideEnd = zoneOutline->CVertex( nextNearestIdx );
         SEG nearestSide( sideOrigin, sideEnd );
         VECTOR2I nearestPoint = nearestSide.NearestPoint( cursorPos );
 
@@ -45,6 +45,7 @@ using namespace std::placeholders;
 #include <class_edge_mod.h>
 #include <origin_viewitem.h>
 #include <connectivity/connectivity_data.h>
+#include <drc.h>
 #include <tool/tool_manager.h>
 #include <tool/actions.h>
 #include <tools/selection_tool.h>
@@ -585,6 +586,15 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
         Compile_Ratsnest( NULL, false );
     }
 
+    // The items restored in place are unknown to the incremental DRC indexes
+    if( IsType( FRAME_PCB ) )
+    {
+        DRC* drc = static_cast<PCB_EDIT_FRAME*>( this )->GetDrcController();
+
+        if( drc )
+            drc->InvalidateIndexes();
+    }
+
     SELECTION_TOOL* selTool = m_toolManager->GetTool<SELECTION_TOOL>();
     selTool->RebuildSelection();
 
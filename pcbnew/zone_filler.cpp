@@ -23,11 +23,11 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <array>
 #include <cstdint>
-#include <thread>
 #include <mutex>
 #include <algorithm>
-#include <future>
+#include <atomic>
 
 #include <class_board.h>
 #include <class_zone.h>
@@ -47,7 +47,10 @@
 #include <geometry/shape_file_io.h>
 #include <geometry/convex_hull.h>
 #include <geometry/geometry_utils.h>
+#include <geometry/rtree.h>
 #include <confirm.h>
+#include <advanced_config.h>
+#include <thread_pool.h>
 
 #include "zone_filler.h"
 
@@ -82,8 +85,249 @@ static double s_thermalRot = 450;   // angle of stubs in thermal reliefs for rou
 static const bool s_DumpZonesWhenFilling = false;
 
 
+/*
+ * Helpers to build the hash of the fill inputs of a zone
+ */
+static void hashDouble( MD5_HASH& aHash, double aValue )
+{
+    aHash.Hash( reinterpret_cast<uint8_t*>( &aValue ), sizeof( aValue ) );
+}
+
+
+static void hashPoint( MD5_HASH& aHash, const wxPoint& aPoint )
+{
+    aHash.Hash( aPoint.x );
+    aHash.Hash( aPoint.y );
+}
+
+
+static void hashSize( MD5_HASH& aHash, const wxSize& aSize )
+{
+    aHash.Hash( aSize.x );
+    aHash.Hash( aSize.y );
+}
+
+
+static void hashRect( MD5_HASH& aHash, const EDA_RECT& aRect )
+{
+    hashPoint( aHash, aRect.GetOrigin() );
+    aHash.Hash( aRect.GetWidth() );
+    aHash.Hash( aRect.GetHeight() );
+}
+
+
+static void hashLayers( MD5_HASH& aHash, LSET aLayers )
+{
+    aHash.Hash( (int) aLayers.count() );
+
+    for( PCB_LAYER_ID layer : aLayers.Seq() )
+        aHash.Hash( layer );
+}
+
+
+static void hashPolys( MD5_HASH& aHash, const SHAPE_POLY_SET& aPolys )
+{
+    aHash.Hash( aPolys.OutlineCount() );
+
+    for( int ii = 0; ii < aPolys.OutlineCount(); ii++ )
+    {
+        const SHAPE_POLY_SET::POLYGON& polygon = aPolys.CPolygon( ii );
+
+        aHash.Hash( (int) polygon.size() );
+
+        for( const SHAPE_LINE_CHAIN& chain : polygon )
+        {
+            aHash.Hash( chain.PointCount() );
+
+            for( int jj = 0; jj < chain.PointCount(); jj++ )
+            {
+                aHash.Hash( chain.CPoint( jj ).x );
+                aHash.Hash( chain.CPoint( jj ).y );
+            }
+        }
+    }
+}
+
+
+/**
+ * @return a hash of the point coordinates of aPolys.  Unlike SHAPE_POLY_SET::GetHash(),
+ * it is never a cached value, so it can be used on a modified copy of a polygon set.
+ */
+static MD5_HASH polysHash( const SHAPE_POLY_SET& aPolys )
+{
+    MD5_HASH hash;
+
+    hashPolys( hash, aPolys );
+    hash.Finalize();
+
+    return hash;
+}
+
+
+/**
+ * Class ZONE_OBSTACLE_INDEX
+ * Per-layer R-tree of the board items which can make holes in zone fills (pads, tracks,
+ * graphic items on copper layers or on the board edges, and zones), built once per
+ * ZONE_FILLER::Fill() call, so each zone only examines the items near it.
+ *
+ * Items are stored with their own bounding box (merged with the hole for pads), and
+ * returned in the order ZONE_FILLER used to walk the board, so the fills do not depend
+ * on the index.
+ */
+class ZONE_OBSTACLE_INDEX
+{
+public:
+    ZONE_OBSTACLE_INDEX( BOARD* aBoard )
+    {
+        m_maxItemMargin = 0;
+
+        for( auto& tree : m_trees )
+            tree.reset( new TREE() );
+
+        const LSET copper = LSET::AllCuMask();
+        const LSET graphics = copper | LSET( Edge_Cuts );
+
+        for( auto module : aBoard->Modules() )
+        {
+            for( auto pad : module->Pads() )
+            {
+                EDA_RECT box = pad->GetBoundingBox();
+                LSET     layers = pad->GetLayerSet() & copper;
+
+                // A pad hole makes a hole in the zones on all copper layers, and can be
+                // larger than the pad itself
+                if( pad->GetDrillSize().x > 0 || pad->GetDrillSize().y > 0 )
+                {
+                    EDA_RECT hole( pad->GetPosition(), wxSize( 0, 0 ) );
+                    hole.Inflate( std::max( pad->GetDrillSize().x, pad->GetDrillSize().y ) );
+                    box.Merge( hole );
+                    layers = copper;
+                }
+
+                m_maxItemMargin = std::max( m_maxItemMargin,
+                                            pad->GetClearance() + pad->GetThermalGap() );
+                insert( pad, box, layers );
+            }
+        }
+
+        for( auto track : aBoard->Tracks() )
+        {
+            m_maxItemMargin = std::max( m_maxItemMargin, track->GetClearance() );
+            insert( track, track->GetBoundingBox(), track->GetLayerSet() & copper );
+        }
+
+        auto insertGraphicItem = [&]( BOARD_ITEM* aItem )
+        {
+            insert( aItem, aItem->GetBoundingBox(), aItem->GetLayerSet() & graphics );
+        };
+
+        for( auto module : aBoard->Modules() )
+        {
+            insertGraphicItem( &module->Reference() );
+            insertGraphicItem( &module->Value() );
+
+            for( auto item : module->GraphicalItems() )
+                insertGraphicItem( item );
+        }
+
+        for( auto item : aBoard->Drawings() )
+            insertGraphicItem( item );
+
+        for( int ii = 0; ii < aBoard->GetAreaCount(); ii++ )
+        {
+            ZONE_CONTAINER* zone = aBoard->GetArea( ii );
+            insert( zone, zone->GetBoundingBox(), zone->GetLayerSet() & copper );
+        }
+    }
+
+    /**
+     * Function Query
+     * Collects the items on at least one layer of aLayers whose box overlaps aBox.
+     * @param aResult receives the items, in board order.
+     */
+    void Query( const EDA_RECT& aBox, LSET aLayers, std::vector<BOARD_ITEM*>& aResult ) const
+    {
+        EDA_RECT         box = aBox;
+        std::vector<int> found;
+
+        box.Normalize();
+
+        const int mmin[2] = { box.GetX(), box.GetY() };
+        const int mmax[2] = { box.GetRight(), box.GetBottom() };
+
+        auto visitor = [&]( const int& aIndex ) -> bool
+        {
+            found.push_back( aIndex );
+            return true;
+        };
+
+        for( PCB_LAYER_ID layer : aLayers.Seq() )
+            m_trees[ layer ]->Search( mmin, mmax, visitor );
+
+        std::sort( found.begin(), found.end() );
+        found.erase( std::unique( found.begin(), found.end() ), found.end() );
+
+        aResult.clear();
+        aResult.reserve( found.size() );
+
+        for( int index : found )
+            aResult.push_back( m_items[ index ] );
+    }
+
+    /**
+     * Function GetMaxItemMargin
+     * @return the largest margin (clearance plus thermal relief gap for pads) ZONE_FILLER
+     * can add around the box of an indexed item.
+     */
+    int GetMaxItemMargin() const { return m_maxItemMargin; }
+
+private:
+    typedef RTree<int, int, 2, double> TREE;
+
+    void insert( BOARD_ITEM* aItem, EDA_RECT aBox, LSET aLayers )
+    {
+        if( aLayers.none() )
+            return;
+
+        aBox.Normalize();
+
+        const int index = (int) m_items.size();
+        const int mmin[2] = { aBox.GetX(), aBox.GetY() };
+        const int mmax[2] = { aBox.GetRight(), aBox.GetBottom() };
+
+        m_items.push_back( aItem );
+
+        for( PCB_LAYER_ID layer : aLayers.Seq() )
+            m_trees[ layer ]->Insert( mmin, mmax, index );
+    }
+
+    std::array<std::unique_ptr<TREE>, PCB_LAYER_ID_COUNT> m_trees;
+    std::vector<BOARD_ITEM*>                              m_items;
+    int                                                   m_maxItemMargin;
+};
+
+
+/**
+ * @return the box to query aIndex with, to get all the items ZONE_FILLER can use to make
+ * holes in aZone: the items whose box, inflated by up to their clearance or thermal gap
+ * and the zone clearance, overlaps aZoneBox (the zone bounding box inflated by the
+ * biggest clearance).
+ */
+static EDA_RECT obstacleQueryBox( const ZONE_OBSTACLE_INDEX& aIndex, const ZONE_CONTAINER* aZone,
+                                  const EDA_RECT& aZoneBox )
+{
+    EDA_RECT box = aZoneBox;
+
+    box.Inflate( aIndex.GetMaxItemMargin() + aZone->GetClearance()
+                 + aZone->GetMinThickness() / 2 + aZone->GetThermalReliefGap() );
+
+    return box;
+}
+
+
 ZONE_FILLER::ZONE_FILLER(  BOARD* aBoard, COMMIT* aCommit ) :
-    m_board( aBoard ), m_commit( aCommit ), m_progressReporter( nullptr )
+    m_board( aBoard ), m_commit( aCommit ), m_progressReporter( nullptr ),
+    m_tilingThreshold( ADVANCED_CFG::GetCfg().m_zoneFillTilingThreshold )
 {
 }
 
@@ -109,12 +353,21 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
     if( !lock )
         return false;
 
+    // The obstacles of all the zones are indexed once
+    m_obstacles.reset( new ZONE_OBSTACLE_INDEX( m_board ) );
+
     if( m_progressReporter )
     {
         m_progressReporter->Report( _( "Checking zone fills..." ) );
         m_progressReporter->SetMaxProgress( toFill.size() );
     }
 
+    // For each zone to fill, the hash of its fill inputs, and for the zones whose cached
+    // fill can be reused, their current filled polygons (with their triangulation)
+    std::vector<MD5_HASH>       inputsHashes;
+    std::vector<bool>           reuseFill;
+    std::vector<SHAPE_POLY_SET> previousFills;
+
     for( auto zone : aZones )
     {
         // Keepout zones are not filled
@@ -131,60 +384,76 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         // Add the zone to the list of zones to test or refill
         toFill.emplace_back( CN_ZONE_ISOLATED_ISLAND_LIST(zone) );
 
-        // Remove existing fill first to prevent drawing invalid polygons
-        // on some platforms
-        zone->UnFill();
+        // If nothing the fill depends on has changed since the last fill, the cached fill is
+        // reused.  Its insulated islands are removed again, because they depend on the
+        // connections of the whole net, not only on the items near the zone.
+        MD5_HASH inputsHash = computeFillInputsHash( zone );
+        bool     reuse = zone->GetFillCacheHash().IsValid()
+                         && zone->GetFillCacheHash() == inputsHash;
+
+        inputsHashes.push_back( inputsHash );
+        reuseFill.push_back( reuse );
+        previousFills.emplace_back();
+
+        if( reuse )
+        {
+            previousFills.back() = zone->GetFilledPolysList();
+
+            SHAPE_POLY_SET cachedFill = zone->GetFillCachePolys();
+            zone->SetFilledPolysList( cachedFill );
+        }
+        else
+        {
+            // Remove existing fill first to prevent drawing invalid polygons
+            // on some platforms
+            zone->UnFill();
+        }
     }
 
     std::atomic<size_t> nextItem( 0 );
+    TASK_GROUP          group;
     size_t              parallelThreadCount =
-            std::min<size_t>( std::thread::hardware_concurrency(), aZones.size() );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
+            std::min<size_t>( group.GetPool().GetThreadCount(), aZones.size() );
 
-    auto fill_lambda = [&] ( PROGRESS_REPORTER* aReporter ) -> size_t
+    auto fill_lambda = [&]()
     {
-        size_t num = 0;
-
         for( size_t i = nextItem++; i < toFill.size(); i = nextItem++ )
         {
             ZONE_CONTAINER* zone = toFill[i].m_zone;
-            SHAPE_POLY_SET rawPolys, finalPolys;
-            fillSingleZone( zone, rawPolys, finalPolys );
 
-            zone->SetRawPolysList( rawPolys );
-            zone->SetFilledPolysList( finalPolys );
+            if( reuseFill[i] )
+            {
+                zone->SetNeedRefill( false );
+            }
+            else
+            {
+                SHAPE_POLY_SET rawPolys, finalPolys;
+                fillSingleZone( zone, rawPolys, finalPolys );
+
+                zone->SetRawPolysList( rawPolys );
+                zone->SetFilledPolysList( finalPolys );
+                zone->SetFillCache( inputsHashes[i], finalPolys );
+            }
+
             zone->SetIsFilled( true );
 
             if( m_progressReporter )
                 m_progressReporter->AdvanceProgress();
-
-            num++;
         }
-
-        return num;
     };
 
-    if( parallelThreadCount <= 1 )
-        fill_lambda( m_progressReporter );
-    else
-    {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, fill_lambda, m_progressReporter );
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        group.Run( fill_lambda );
 
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            // Here we balance returns with a 100ms timeout to allow UI updating
-            std::future_status status;
-            do
-            {
-                if( m_progressReporter )
-                    m_progressReporter->KeepRefreshing();
-
-                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-            } while( status != std::future_status::ready );
-        }
+    // Here we wait with a 100ms timeout to allow UI updating
+    while( !group.WaitFor( std::chrono::milliseconds( 100 ) ) )
+    {
+        if( m_progressReporter )
+            m_progressReporter->KeepRefreshing();
     }
 
+    group.Wait();
+
     // Now update the connectivity to check for copper islands
     if( m_progressReporter )
     {
@@ -201,8 +470,10 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
     SHAPE_POLY_SET boardOutline;
     bool clip_to_brd_outlines = m_board->GetBoardPolygonOutlines( boardOutline );
 
-    for( auto& zone : toFill )
+    for( size_t i = 0; i < toFill.size(); i++ )
     {
+        CN_ZONE_ISOLATED_ISLAND_LIST& zone = toFill[i];
+
         std::sort( zone.m_islands.begin(), zone.m_islands.end(), std::greater<int>() );
         SHAPE_POLY_SET poly = zone.m_zone->GetFilledPolysList();
 
@@ -227,8 +498,8 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         {
              for( int idx = 0; idx < poly.OutlineCount(); )
             {
-                if( poly.Polygon( idx ).empty() ||
-                    !boardOutline.Contains( poly.Polygon( idx ).front().CPoint( 0 ) ) )
+                if( poly.CPolygon( idx ).empty() ||
+                    !boardOutline.Contains( poly.CPolygon( idx ).front().CPoint( 0 ) ) )
                 {
                     poly.DeletePolygon( idx );
                 }
@@ -237,7 +508,13 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
             }
         }
 
-        zone.m_zone->SetFilledPolysList( poly );
+        // When a reused fill ends up identical to the previous one, keep the previous
+        // polygons: they come with their triangulation, which CacheTriangulation() below
+        // only rebuilds if it is not up to date
+        if( reuseFill[i] && polysHash( poly ) == polysHash( previousFills[i] ) )
+            zone.m_zone->SetFilledPolysList( previousFills[i] );
+        else
+            zone.m_zone->SetFilledPolysList( poly );
 
         if( aCheck && zone.m_zone->GetHashValue() != poly.GetHash() )
             outOfDate = true;
@@ -258,6 +535,7 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
                 m_commit->Revert();
 
             connectivity->SetProgressReporter( nullptr );
+            m_obstacles.reset();
             return false;
         }
     }
@@ -272,43 +550,28 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
 
     nextItem = 0;
 
-    auto tri_lambda = [&] ( PROGRESS_REPORTER* aReporter ) -> size_t
+    auto tri_lambda = [&]()
     {
-        size_t num = 0;
-
         for( size_t i = nextItem++; i < toFill.size(); i = nextItem++ )
         {
             toFill[i].m_zone->CacheTriangulation();
-            num++;
 
             if( m_progressReporter )
                 m_progressReporter->AdvanceProgress();
         }
-
-        return num;
     };
 
-    if( parallelThreadCount <= 1 )
-        tri_lambda( m_progressReporter );
-    else
-    {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, tri_lambda, m_progressReporter );
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        group.Run( tri_lambda );
 
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            // Here we balance returns with a 100ms timeout to allow UI updating
-            std::future_status status;
-            do
-            {
-                if( m_progressReporter )
-                    m_progressReporter->KeepRefreshing();
-
-                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-            } while( status != std::future_status::ready );
-        }
+    while( !group.WaitFor( std::chrono::milliseconds( 100 ) ) )
+    {
+        if( m_progressReporter )
+            m_progressReporter->KeepRefreshing();
     }
 
+    group.Wait();
+
     if( m_progressReporter )
     {
         m_progressReporter->AdvancePhase();
@@ -330,6 +593,8 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         connectivity->RecalculateRatsnest();
     }
 
+    m_obstacles.reset();
+
     return true;
 }
 
@@ -362,6 +627,12 @@ void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
     biggest_clearance = std::max( biggest_clearance, zone_clearance );
     zone_boundingbox.Inflate( biggest_clearance );
 
+    // Candidate items, in board order.  The item tests below are still needed: the
+    // query box only has to include all the item boxes they can accept.
+    std::vector<BOARD_ITEM*> obstacles;
+    m_obstacles->Query( obstacleQueryBox( *m_obstacles, aZone, zone_boundingbox ),
+                        aZone->GetLayerSet() | LSET( Edge_Cuts ), obstacles );
+
     /*
      * First : Add pads. Note: pads having the same net as zone are left in zone.
      * Thermal shapes will be created later if necessary
@@ -377,113 +648,62 @@ void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
     MODULE  dummymodule( m_board );   // Creates a dummy parent
     D_PAD   dummypad( &dummymodule );
 
-    for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    for( BOARD_ITEM* obstacle : obstacles )
     {
-        D_PAD* nextpad;
-
-        for( D_PAD* pad = module->PadsList(); pad != NULL; pad = nextpad )
-        {
-            nextpad = pad->Next();      // pad pointer can be modified by next code, so
-                                        // calculate the next pad here
+        if( obstacle->Type() != PCB_PAD_T )
+            continue;
 
-            if( !pad->IsOnLayer( aZone->GetLayer() ) )
-            {
-                /* Test for pads that are on top or bottom only and have a hole.
-                 * There are curious pads but they can be used for some components that are
-                 * inside the board (in fact inside the hole. Some photo diodes and Leds are
-                 * like this)
-                 */
-                if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
-                    continue;
-
-                // Use a dummy pad to calculate a hole shape that have the same dimension as
-                // the pad hole
-                dummypad.SetSize( pad->GetDrillSize() );
-                dummypad.SetOrientation( pad->GetOrientation() );
-                dummypad.SetShape( pad->GetDrillShape() == PAD_DRILL_SHAPE_OBLONG ?
-                        PAD_SHAPE_OVAL : PAD_SHAPE_CIRCLE );
-                dummypad.SetPosition( pad->GetPosition() );
-
-                pad = &dummypad;
-            }
+        D_PAD* pad = static_cast<D_PAD*>( obstacle );   // can be modified by next code
 
-            // Note: netcode <=0 means not connected item
-            if( ( pad->GetNetCode() != aZone->GetNetCode() ) || ( pad->GetNetCode() <= 0 ) )
-            {
-                int item_clearance = pad->GetClearance() + outline_half_thickness;
-                item_boundingbox = pad->GetBoundingBox();
-                item_boundingbox.Inflate( item_clearance );
+        if( !pad->IsOnLayer( aZone->GetLayer() ) )
+        {
+            /* Test for pads that are on top or bottom only and have a hole.
+             * There are curious pads but they can be used for some components that are
+             * inside the board (in fact inside the hole. Some photo diodes and Leds are
+             * like this)
+             */
+            if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
+                continue;
 
-                if( item_boundingbox.Intersects( zone_boundingbox ) )
-                {
-                    int clearance = std::max( zone_clearance, item_clearance );
+            // Use a dummy pad to calculate a hole shape that have the same dimension as
+            // the pad hole
+            dummypad.SetSize( pad->GetDrillSize() );
+            dummypad.SetOrientation( pad->GetOrientation() );
+            dummypad.SetShape( pad->GetDrillShape() == PAD_DRILL_SHAPE_OBLONG ?
+                    PAD_SHAPE_OVAL : PAD_SHAPE_CIRCLE );
+            dummypad.SetPosition( pad->GetPosition() );
 
-                    // PAD_SHAPE_CUSTOM can have a specific keepout, to avoid to break the shape
-                    if( pad->GetShape() == PAD_SHAPE_CUSTOM
-                        && pad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
-                    {
-                        // the pad shape in zone can be its convex hull or
-                        // the shape itself
-                        SHAPE_POLY_SET outline( pad->GetCustomShapeAsPolygon() );
-                        int numSegs = std::max(
-                                GetArcToSegmentCount( clearance,
-                                        m_board->GetDesignSettings().m_MaxError, 360.0 ), 6 );
-                        double correction = GetCircletoPolyCorrectionFactor( numSegs );
-                        outline.Inflate( KiROUND( clearance * correction ), numSegs );
-                        pad->CustomShapeAsPolygonToBoardPosition(
-                                &outline, pad->GetPosition(), pad->GetOrientation() );
-
-                        if( pad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
-                        {
-                            std::vector<wxPoint> convex_hull;
-                            BuildConvexHull( convex_hull, outline );
-
-                            aFeatures.NewOutline();
-
-                            for( unsigned ii = 0; ii < convex_hull.size(); ++ii )
-                                aFeatures.Append( convex_hull[ii] );
-                        }
-                        else
-                            aFeatures.Append( outline );
-                    }
-                    else
-                        pad->TransformShapeWithClearanceToPolygon( aFeatures, clearance );
-                }
+            pad = &dummypad;
+        }
 
-                continue;
-            }
+        // Note: netcode <=0 means not connected item
+        if( ( pad->GetNetCode() != aZone->GetNetCode() ) || ( pad->GetNetCode() <= 0 ) )
+        {
+            int item_clearance = pad->GetClearance() + outline_half_thickness;
+            item_boundingbox = pad->GetBoundingBox();
+            item_boundingbox.Inflate( item_clearance );
 
-            // Pads are removed from zone if the setup is PAD_ZONE_CONN_NONE
-            // or if they have a custom shape and not PAD_ZONE_CONN_FULL,
-            // because a thermal relief will break
-            // the shape
-            if( aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_NONE
-                || ( pad->GetShape() == PAD_SHAPE_CUSTOM && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_FULL ) )
+            if( item_boundingbox.Intersects( zone_boundingbox ) )
             {
-                int gap = zone_clearance;
-                int thermalGap = aZone->GetThermalReliefGap( pad );
-                gap = std::max( gap, thermalGap );
-                item_boundingbox = pad->GetBoundingBox();
-                item_boundingbox.Inflate( gap );
+                int clearance = std::max( zone_clearance, item_clearance );
 
-                if( item_boundingbox.Intersects( zone_boundingbox ) )
+                // PAD_SHAPE_CUSTOM can have a specific keepout, to avoid to break the shape
+                if( pad->GetShape() == PAD_SHAPE_CUSTOM
+                    && pad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
                 {
-                    // PAD_SHAPE_CUSTOM has a specific keepout, to avoid to break the shape
-                    // the pad shape in zone can be its convex hull or the shape itself
-                    if( pad->GetShape() == PAD_SHAPE_CUSTOM
-                        && pad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
+                    // the pad shape in zone can be its convex hull or
+                    // the shape itself
+                    SHAPE_POLY_SET outline( pad->GetCustomShapeAsPolygon() );
+                    int numSegs = std::max(
+                            GetArcToSegmentCount( clearance,
+                                    m_board->GetDesignSettings().m_MaxError, 360.0 ), 6 );
+                    double correction = GetCircletoPolyCorrectionFactor( numSegs );
+                    outline.Inflate( KiROUND( clearance * correction ), numSegs );
+                    pad->CustomShapeAsPolygonToBoardPosition(
+                            &outline, pad->GetPosition(), pad->GetOrientation() );
+
+                    if( pad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
                     {
-                        // the pad shape in zone can be its convex hull or
-                        // the shape itself
-                        int numSegs = std::max(
-                                GetArcToSegmentCount( gap, m_board->GetDesignSettings().m_MaxError,
-                                        360.0 ), 6 );
-                        double         correction = GetCircletoPolyCorrectionFactor( numSegs );
-                        SHAPE_POLY_SET outline( pad->GetCustomShapeAsPolygon() );
-                        outline.Inflate( KiROUND( gap * correction ), numSegs );
-                        pad->CustomShapeAsPolygonToBoardPosition(
-                                &outline, pad->GetPosition(), pad->GetOrientation() );
-
                         std::vector<wxPoint> convex_hull;
                         BuildConvexHull( convex_hull, outline );
 
@@ -493,8 +713,56 @@ void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
                             aFeatures.Append( convex_hull[ii] );
                     }
                     else
-                        pad->TransformShapeWithClearanceToPolygon( aFeatures, gap );
+                        aFeatures.Append( outline );
                 }
+                else
+                    pad->TransformShapeWithClearanceToPolygon( aFeatures, clearance );
+            }
+
+            continue;
+        }
+
+        // Pads are removed from zone if the setup is PAD_ZONE_CONN_NONE
+        // or if they have a custom shape and not PAD_ZONE_CONN_FULL,
+        // because a thermal relief will break
+        // the shape
+        if( aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_NONE
+            || ( pad->GetShape() == PAD_SHAPE_CUSTOM && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_FULL ) )
+        {
+            int gap = zone_clearance;
+            int thermalGap = aZone->GetThermalReliefGap( pad );
+            gap = std::max( gap, thermalGap );
+            item_boundingbox = pad->GetBoundingBox();
+            item_boundingbox.Inflate( gap );
+
+            if( item_boundingbox.Intersects( zone_boundingbox ) )
+            {
+                // PAD_SHAPE_CUSTOM has a specific keepout, to avoid to break the shape
+                // the pad shape in zone can be its convex hull or the shape itself
+                if( pad->GetShape() == PAD_SHAPE_CUSTOM
+                    && pad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
+                {
+                    // the pad shape in zone can be its convex hull or
+                    // the shape itself
+                    int numSegs = std::max(
+                            GetArcToSegmentCount( gap, m_board->GetDesignSettings().m_MaxError,
+                                    360.0 ), 6 );
+                    double         correction = GetCircletoPolyCorrectionFactor( numSegs );
+                    SHAPE_POLY_SET outline( pad->GetCustomShapeAsPolygon() );
+                    outline.Inflate( KiROUND( gap * correction ), numSegs );
+                    pad->CustomShapeAsPolygonToBoardPosition(
+                            &outline, pad->GetPosition(), pad->GetOrientation() );
+
+                    std::vector<wxPoint> convex_hull;
+                    BuildConvexHull( convex_hull, outline );
+
+                    aFeatures.NewOutline();
+
+                    for( unsigned ii = 0; ii < convex_hull.size(); ++ii )
+                        aFeatures.Append( convex_hull[ii] );
+                }
+                else
+                    pad->TransformShapeWithClearanceToPolygon( aFeatures, gap );
             }
         }
     }
@@ -502,8 +770,13 @@ void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
     /* Add holes (i.e. tracks and vias areas as polygons outlines)
      * in cornerBufferPolysToSubstract
      */
-    for( auto track : m_board->Tracks() )
+    for( BOARD_ITEM* obstacle : obstacles )
     {
+        if( obstacle->Type() != PCB_TRACE_T && obstacle->Type() != PCB_VIA_T )
+            continue;
+
+        TRACK* track = static_cast<TRACK*>( obstacle );
+
         if( !track->IsOnLayer( aZone->GetLayer() ) )
             continue;
 
@@ -577,23 +850,17 @@ void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
         }
     };
 
-    for( auto module : m_board->Modules() )
-    {
-        doGraphicItem( &module->Reference() );
-        doGraphicItem( &module->Value() );
-
-        for( auto item : module->GraphicalItems() )
-            doGraphicItem( item );
-    }
-
-    for( auto item : m_board->Drawings() )
-        doGraphicItem( item );
+    for( BOARD_ITEM* obstacle : obstacles )
+        doGraphicItem( obstacle );
 
     /* Add zones outlines having an higher priority and keepout
      */
-    for( int ii = 0; ii < m_board->GetAreaCount(); ii++ )
+    for( BOARD_ITEM* obstacle : obstacles )
     {
-        ZONE_CONTAINER* zone = m_board->GetArea( ii );
+        if( obstacle->Type() != PCB_ZONE_AREA_T )
+            continue;
+
+        ZONE_CONTAINER* zone = static_cast<ZONE_CONTAINER*>( obstacle );
 
         // If the zones share no common layers
         if( !aZone->CommonLayerExists( zone->GetLayerSet() ) )
@@ -641,42 +908,257 @@ void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
 
     /* Remove thermal symbols
      */
-    for( auto module : m_board->Modules() )
+    for( BOARD_ITEM* obstacle : obstacles )
+    {
+        if( obstacle->Type() != PCB_PAD_T )
+            continue;
+
+        D_PAD* pad = static_cast<D_PAD*>( obstacle );
+
+        // Rejects non-standard pads with tht-only thermal reliefs
+        if( aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_THT_THERMAL
+            && pad->GetAttribute() != PAD_ATTRIB_STANDARD )
+            continue;
+
+        if( aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THERMAL
+            && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THT_THERMAL )
+            continue;
+
+        if( !pad->IsOnLayer( aZone->GetLayer() ) )
+            continue;
+
+        if( pad->GetNetCode() != aZone->GetNetCode() )
+            continue;
+
+        if( pad->GetNetCode() <= 0 )
+            continue;
+
+        item_boundingbox = pad->GetBoundingBox();
+        int thermalGap = aZone->GetThermalReliefGap( pad );
+        item_boundingbox.Inflate( thermalGap, thermalGap );
+
+        if( item_boundingbox.Intersects( zone_boundingbox ) )
+        {
+            CreateThermalReliefPadPolygon( aFeatures, *pad, thermalGap,
+                    aZone->GetThermalReliefCopperBridge( pad ), aZone->GetMinThickness(),
+                    m_board->GetDesignSettings().m_MaxError, s_thermalRot );
+        }
+    }
+}
+
+MD5_HASH ZONE_FILLER::computeFillInputsHash( const ZONE_CONTAINER* aZone ) const
+{
+    MD5_HASH                     hash;
+    const BOARD_DESIGN_SETTINGS& bds = m_board->GetDesignSettings();
+
+    // The board settings used by the filler
+    hash.Hash( bds.m_MaxError );
+    hash.Hash( bds.m_CopperEdgeClearance );
+    hash.Hash( bds.GetBiggestClearanceValue() );
+    hashDouble( hash, s_thermalRot );
+
+    // The zone outline and settings
+    hashPolys( hash, *aZone->Outline() );
+    hashLayers( hash, aZone->GetLayerSet() );
+    hash.Hash( aZone->GetNetCode() );
+    hash.Hash( aZone->GetClearance() );
+    hash.Hash( aZone->GetZoneClearance() );
+    hash.Hash( aZone->GetMinThickness() );
+    hash.Hash( aZone->GetPriority() );
+    hash.Hash( aZone->GetFillMode() );
+    hash.Hash( aZone->GetHatchFillTypeThickness() );
+    hash.Hash( aZone->GetHatchFillTypeGap() );
+    hashDouble( hash, aZone->GetHatchFillTypeOrientation() );
+    hash.Hash( aZone->GetHatchFillTypeSmoothingLevel() );
+    hashDouble( hash, aZone->GetHatchFillTypeSmoothingValue() );
+    hash.Hash( aZone->GetCornerSmoothingType() );
+    hash.Hash( aZone->GetCornerRadius() );
+
+    // The items buildZoneFeatureHoleList() can use: all the items it gets from the
+    // obstacle index.
+    int zone_clearance = aZone->GetClearance() + aZone->GetMinThickness() / 2;
+
+    EDA_RECT zone_boundingbox = aZone->GetBoundingBox();
+    zone_boundingbox.Inflate( std::max( bds.GetBiggestClearanceValue(), zone_clearance ) );
+
+    std::vector<BOARD_ITEM*> obstacles;
+    m_obstacles->Query( obstacleQueryBox( *m_obstacles, aZone, zone_boundingbox ),
+                        aZone->GetLayerSet() | LSET( Edge_Cuts ), obstacles );
+
+    for( BOARD_ITEM* obstacle : obstacles )
     {
-        for( auto pad : module->Pads() )
+        hash.Hash( obstacle->Type() );
+        hashLayers( hash, obstacle->GetLayerSet() );
+        hashRect( hash, obstacle->GetBoundingBox() );
+
+        switch( obstacle->Type() )
         {
-            // Rejects non-standard pads with tht-only thermal reliefs
-            if( aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_THT_THERMAL
-                && pad->GetAttribute() != PAD_ATTRIB_STANDARD )
-                continue;
+        case PCB_PAD_T:
+        {
+            D_PAD* pad = static_cast<D_PAD*>( obstacle );
+
+            hash.Hash( pad->GetNetCode() );
+            hash.Hash( pad->GetClearance() );
+            hash.Hash( pad->GetAttribute() );
+            hash.Hash( pad->GetShape() );
+            hash.Hash( pad->GetAnchorPadShape() );
+            hashPoint( hash, pad->GetPosition() );
+            hashDouble( hash, pad->GetOrientation() );
+            hashSize( hash, pad->GetSize() );
+            hashSize( hash, pad->GetDelta() );
+            hashPoint( hash, pad->GetOffset() );
+            hashSize( hash, pad->GetDrillSize() );
+            hash.Hash( pad->GetDrillShape() );
+            hashDouble( hash, pad->GetRoundRectRadiusRatio() );
+            hashDouble( hash, pad->GetChamferRectRatio() );
+            hash.Hash( pad->GetChamferPositions() );
+            hash.Hash( pad->GetCustomShapeInZoneOpt() );
+            hashPolys( hash, pad->GetCustomShapeAsPolygon() );
+            hash.Hash( aZone->GetPadConnection( pad ) );
+            hash.Hash( aZone->GetThermalReliefGap( pad ) );
+            hash.Hash( aZone->GetThermalReliefCopperBridge( pad ) );
+            break;
+        }
 
-            if( aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THERMAL
-                && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THT_THERMAL )
-                continue;
+        case PCB_TRACE_T:
+        case PCB_VIA_T:
+        {
+            TRACK* track = static_cast<TRACK*>( obstacle );
 
-            if( !pad->IsOnLayer( aZone->GetLayer() ) )
-                continue;
+            hash.Hash( track->GetNetCode() );
+            hash.Hash( track->GetClearance() );
+            hashPoint( hash, track->GetStart() );
+            hashPoint( hash, track->GetEnd() );
+            hash.Hash( track->GetWidth() );
+            break;
+        }
 
-            if( pad->GetNetCode() != aZone->GetNetCode() )
-                continue;
+        case PCB_LINE_T:
+        case PCB_MODULE_EDGE_T:
+        {
+            DRAWSEGMENT* segment = static_cast<DRAWSEGMENT*>( obstacle );
+
+            hash.Hash( segment->GetShape() );
+            hashPoint( hash, segment->GetStart() );
+            hashPoint( hash, segment->GetEnd() );
+            hashPoint( hash, segment->GetBezControl1() );
+            hashPoint( hash, segment->GetBezControl2() );
+            hashDouble( hash, segment->GetAngle() );
+            hash.Hash( segment->GetWidth() );
+            hashPolys( hash, segment->GetPolyShape() );
+            break;
+        }
 
-            if( pad->GetNetCode() <= 0 )
-                continue;
+        case PCB_TEXT_T:
+        case PCB_MODULE_TEXT_T:
+        {
+            EDA_TEXT* text = obstacle->Type() == PCB_TEXT_T ?
+                                     static_cast<EDA_TEXT*>( static_cast<TEXTE_PCB*>( obstacle ) ) :
+                                     static_cast<EDA_TEXT*>( static_cast<TEXTE_MODULE*>( obstacle ) );
 
-            item_boundingbox = pad->GetBoundingBox();
-            int thermalGap = aZone->GetThermalReliefGap( pad );
-            item_boundingbox.Inflate( thermalGap, thermalGap );
+            hashPoint( hash, text->GetTextPos() );
+            hashDouble( hash, text->GetTextAngle() );
+            hash.Hash( text->IsVisible() );
+            break;
+        }
 
-            if( item_boundingbox.Intersects( zone_boundingbox ) )
-            {
-                CreateThermalReliefPadPolygon( aFeatures, *pad, thermalGap,
-                        aZone->GetThermalReliefCopperBridge( pad ), aZone->GetMinThickness(),
-                        m_board->GetDesignSettings().m_MaxError, s_thermalRot );
-            }
+        case PCB_ZONE_AREA_T:
+        {
+            ZONE_CONTAINER* zone = static_cast<ZONE_CONTAINER*>( obstacle );
+
+            if( zone == aZone )
+                break;
+
+            hash.Hash( zone->GetNetCode() );
+            hash.Hash( zone->GetClearance() );
+            hash.Hash( zone->GetPriority() );
+            hash.Hash( zone->GetIsKeepout() );
+            hash.Hash( zone->GetDoNotAllowCopperPour() );
+            hashPolys( hash, *zone->Outline() );
+            break;
+        }
+
+        default:
+            break;
         }
     }
+
+    hash.Finalize();
+
+    return hash;
 }
 
+
+void ZONE_FILLER::subtractHolesByTiles( SHAPE_POLY_SET& aSolidAreas,
+        const SHAPE_POLY_SET& aHoles ) const
+{
+    const BOX2I bbox = aSolidAreas.BBox();
+    size_t      parallelThreadCount = THREAD_POOL::GetInstance().GetThreadCount();
+
+    // A few tiles per thread, because some tiles have much more holes than others
+    int tilesPerSide = std::max( 2, KiROUND( std::sqrt( 2.0 * parallelThreadCount ) ) );
+    int tileWidth = bbox.GetWidth() / tilesPerSide + 1;
+    int tileHeight = bbox.GetHeight() / tilesPerSide + 1;
+
+    std::vector<BOX2I> holeBoxes;
+    holeBoxes.reserve( aHoles.OutlineCount() );
+
+    for( int ii = 0; ii < aHoles.OutlineCount(); ii++ )
+        holeBoxes.push_back( aHoles.COutline( ii ).BBox() );
+
+    std::vector<SHAPE_POLY_SET> tiles( tilesPerSide * tilesPerSide );
+
+    // The zones are already filled in parallel: the tiles of this zone are run by the
+    // workers idle because they have no zone left to fill
+    ParallelFor( tiles.size(), [&]( size_t i )
+    {
+        int   col = (int) i % tilesPerSide;
+        int   row = (int) i / tilesPerSide;
+        BOX2I tileBox( VECTOR2I( bbox.GetX() + col * tileWidth, bbox.GetY() + row * tileHeight ),
+                       VECTOR2I( tileWidth, tileHeight ) );
+
+        SHAPE_POLY_SET tileShape;
+        tileShape.NewOutline();
+        tileShape.Append( tileBox.GetLeft(), tileBox.GetTop() );
+        tileShape.Append( tileBox.GetRight(), tileBox.GetTop() );
+        tileShape.Append( tileBox.GetRight(), tileBox.GetBottom() );
+        tileShape.Append( tileBox.GetLeft(), tileBox.GetBottom() );
+
+        // Only the holes overlapping the tile are merged and subtracted
+        SHAPE_POLY_SET tileHoles;
+
+        for( int ii = 0; ii < aHoles.OutlineCount(); ii++ )
+        {
+            if( !holeBoxes[ii].Intersects( tileBox ) )
+                continue;
+
+            const SHAPE_POLY_SET::POLYGON& hole = aHoles.CPolygon( ii );
+            int outline = tileHoles.AddOutline( hole[0] );
+
+            for( size_t jj = 1; jj < hole.size(); jj++ )
+                tileHoles.AddHole( hole[jj], outline );
+        }
+
+        tileHoles.Simplify( SHAPE_POLY_SET::PM_FAST );
+
+        SHAPE_POLY_SET& tile = tiles[i];
+        tile = aSolidAreas;
+        tile.BooleanIntersection( tileShape, SHAPE_POLY_SET::PM_FAST );
+        tile.BooleanSubtract( tileHoles, SHAPE_POLY_SET::PM_FAST );
+    } );
+
+    // Stitch the tiles: the union merges the pieces of copper cut by the tile borders.
+    // Use SHAPE_POLY_SET::PM_STRICTLY_SIMPLE to generate strictly simple polygons
+    // needed by Gerber files and Fracture()
+    aSolidAreas.RemoveAllContours();
+
+    for( const SHAPE_POLY_SET& tile : tiles )
+        aSolidAreas.Append( tile );
+
+    aSolidAreas.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+}
+
+
 /**
  * Function ComputeRawFilledAreas
  * Supports a min thickness area constraint.
@@ -739,16 +1221,23 @@ void ZONE_FILLER::computeRawFilledAreas( const ZONE_CONTAINER* aZone,
     if( s_DumpZonesWhenFilling )
         dumper->Write( &holes, "feature-holes" );
 
-    holes.Simplify( SHAPE_POLY_SET::PM_FAST );
+    if( m_tilingThreshold > 0 && holes.OutlineCount() >= m_tilingThreshold )
+    {
+        subtractHolesByTiles( solidAreas, holes );
+    }
+    else
+    {
+        holes.Simplify( SHAPE_POLY_SET::PM_FAST );
 
-    if( s_DumpZonesWhenFilling )
-        dumper->Write( &holes, "feature-holes-postsimplify" );
+        if( s_DumpZonesWhenFilling )
+            dumper->Write( &holes, "feature-holes-postsimplify" );
 
-    // Generate the filled areas (currently, without thermal shapes, which will
-    // be created later).
-    // Use SHAPE_POLY_SET::PM_STRICTLY_SIMPLE to generate strictly simple polygons
-    // needed by Gerber files and Fracture()
-    solidAreas.BooleanSubtract( holes, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+        // Generate the filled areas (currently, without thermal shapes, which will
+        // be created later).
+        // Use SHAPE_POLY_SET::PM_STRICTLY_SIMPLE to generate strictly simple polygons
+        // needed by Gerber files and Fracture()
+        solidAreas.BooleanSubtract( holes, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    }
 
     // Now remove the non filled areas due to the hatch pattern
     if( aZone->GetFillMode() == ZFM_HATCH_PATTERN )
@@ -899,144 +1388,154 @@ void ZONE_FILLER::buildUnconnectedThermalStubsPolygonList( SHAPE_POLY_SET& aCorn
     // half size of the pen used to draw/plot zones outlines
     int pen_radius = aZone->GetMinThickness() / 2;
 
-    for( auto module : m_board->Modules() )
+    // Only the pads near the zone can have thermal reliefs in it
+    EDA_RECT queryBox( wxPoint( zoneBB.GetX(), zoneBB.GetY() ),
+                       wxSize( zoneBB.GetWidth(), zoneBB.GetHeight() ) );
+    queryBox.Inflate( m_obstacles->GetMaxItemMargin() + aZone->GetThermalReliefGap() );
+
+    std::vector<BOARD_ITEM*> obstacles;
+    m_obstacles->Query( queryBox, LSET( aZone->GetLayer() ), obstacles );
+
+    for( BOARD_ITEM* obstacle : obstacles )
     {
-        for( auto pad : module->Pads() )
-        {
-            // Rejects non-standard pads with tht-only thermal reliefs
-            if( aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_THT_THERMAL
-             && pad->GetAttribute() != PAD_ATTRIB_STANDARD )
-                continue;
+        if( obstacle->Type() != PCB_PAD_T )
+            continue;
 
-            if( aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THERMAL
-             && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THT_THERMAL )
-                continue;
+        D_PAD* pad = static_cast<D_PAD*>( obstacle );
 
-            if( !pad->IsOnLayer( aZone->GetLayer() ) )
-                continue;
+        // Rejects non-standard pads with tht-only thermal reliefs
+        if( aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_THT_THERMAL
+         && pad->GetAttribute() != PAD_ATTRIB_STANDARD )
+            continue;
 
-            if( pad->GetNetCode() != aZone->GetNetCode() )
-                continue;
+        if( aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THERMAL
+         && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THT_THERMAL )
+            continue;
 
-            // Calculate thermal bridge half width
-            int thermalBridgeWidth = aZone->GetThermalReliefCopperBridge( pad )
-                                     - aZone->GetMinThickness();
-            if( thermalBridgeWidth <= 0 )
-                continue;
+        if( !pad->IsOnLayer( aZone->GetLayer() ) )
+            continue;
 
-            // we need the thermal bridge half width
-            // with a small extra size to be sure we create a stub
-            // slightly larger than the actual stub
-            thermalBridgeWidth = ( thermalBridgeWidth + 4 ) / 2;
+        if( pad->GetNetCode() != aZone->GetNetCode() )
+            continue;
 
-            int thermalReliefGap = aZone->GetThermalReliefGap( pad );
+        // Calculate thermal bridge half width
+        int thermalBridgeWidth = aZone->GetThermalReliefCopperBridge( pad )
+                                 - aZone->GetMinThickness();
+        if( thermalBridgeWidth <= 0 )
+            continue;
 
-            itemBB = pad->GetBoundingBox();
-            itemBB.Inflate( thermalReliefGap );
-            if( !( itemBB.Intersects( zoneBB ) ) )
-                continue;
+        // we need the thermal bridge half width
+        // with a small extra size to be sure we create a stub
+        // slightly larger than the actual stub
+        thermalBridgeWidth = ( thermalBridgeWidth + 4 ) / 2;
 
-            // Thermal bridges are like a segment from a starting point inside the pad
-            // to an ending point outside the pad
+        int thermalReliefGap = aZone->GetThermalReliefGap( pad );
 
-            // calculate the ending point of the thermal pad, outside the pad
-            VECTOR2I endpoint;
-            endpoint.x = ( pad->GetSize().x / 2 ) + thermalReliefGap;
-            endpoint.y = ( pad->GetSize().y / 2 ) + thermalReliefGap;
+        itemBB = pad->GetBoundingBox();
+        itemBB.Inflate( thermalReliefGap );
+        if( !( itemBB.Intersects( zoneBB ) ) )
+            continue;
 
-            // Calculate the starting point of the thermal stub
-            // inside the pad
-            VECTOR2I startpoint;
-            int copperThickness = aZone->GetThermalReliefCopperBridge( pad )
-                                  - aZone->GetMinThickness();
+        // Thermal bridges are like a segment from a starting point inside the pad
+        // to an ending point outside the pad
 
-            if( copperThickness < 0 )
-                copperThickness = 0;
+        // calculate the ending point of the thermal pad, outside the pad
+        VECTOR2I endpoint;
+        endpoint.x = ( pad->GetSize().x / 2 ) + thermalReliefGap;
+        endpoint.y = ( pad->GetSize().y / 2 ) + thermalReliefGap;
 
-            // Leave a small extra size to the copper area inside to pad
-            copperThickness += KiROUND( IU_PER_MM * 0.04 );
+        // Calculate the starting point of the thermal stub
+        // inside the pad
+        VECTOR2I startpoint;
+        int copperThickness = aZone->GetThermalReliefCopperBridge( pad )
+                              - aZone->GetMinThickness();
 
-            startpoint.x = std::min( pad->GetSize().x, copperThickness );
-            startpoint.y = std::min( pad->GetSize().y, copperThickness );
+        if( copperThickness < 0 )
+            copperThickness = 0;
 
-            startpoint.x /= 2;
-            startpoint.y /= 2;
+        // Leave a small extra size to the copper area inside to pad
+        copperThickness += KiROUND( IU_PER_MM * 0.04 );
 
-            // This is a CIRCLE pad tweak
-            // for circle pads, the thermal stubs orientation is 45 deg
-            double fAngle = pad->GetOrientation();
-            if( pad->GetShape() == PAD_SHAPE_CIRCLE )
-            {
-                endpoint.x     = KiROUND( endpoint.x * aArcCorrection );
-                endpoint.y     = endpoint.x;
-                fAngle = aRoundPadThermalRotation;
-            }
+        startpoint.x = std::min( pad->GetSize().x, copperThickness );
+        startpoint.y = std::min( pad->GetSize().y, copperThickness );
 
-            // contour line width has to be taken into calculation to avoid "thermal stub bleed"
-            endpoint.x += pen_radius;
-            endpoint.y += pen_radius;
-            // compute north, south, west and east points for zone connection.
-            ptTest[0] = VECTOR2I( 0, endpoint.y );       // lower point
-            ptTest[1] = VECTOR2I( 0, -endpoint.y );      // upper point
-            ptTest[2] = VECTOR2I( endpoint.x, 0 );       // right point
-            ptTest[3] = VECTOR2I( -endpoint.x, 0 );      // left point
-
-            // Test all sides
-            for( int i = 0; i < 4; i++ )
-            {
-                // rotate point
-                RotatePoint( ptTest[i], fAngle );
+        startpoint.x /= 2;
+        startpoint.y /= 2;
 
-                // translate point
-                ptTest[i] += pad->ShapePos();
+        // This is a CIRCLE pad tweak
+        // for circle pads, the thermal stubs orientation is 45 deg
+        double fAngle = pad->GetOrientation();
+        if( pad->GetShape() == PAD_SHAPE_CIRCLE )
+        {
+            endpoint.x     = KiROUND( endpoint.x * aArcCorrection );
+            endpoint.y     = endpoint.x;
+            fAngle = aRoundPadThermalRotation;
+        }
 
-                if( aRawFilledArea.Contains( ptTest[i] ) )
-                    continue;
+        // contour line width has to be taken into calculation to avoid "thermal stub bleed"
+        endpoint.x += pen_radius;
+        endpoint.y += pen_radius;
+        // compute north, south, west and east points for zone connection.
+        ptTest[0] = VECTOR2I( 0, endpoint.y );       // lower point
+        ptTest[1] = VECTOR2I( 0, -endpoint.y );      // upper point
+        ptTest[2] = VECTOR2I( endpoint.x, 0 );       // right point
+        ptTest[3] = VECTOR2I( -endpoint.x, 0 );      // left point
+
+        // Test all sides
+        for( int i = 0; i < 4; i++ )
+        {
+            // rotate point
+            RotatePoint( ptTest[i], fAngle );
 
-                spokes.Clear();
+            // translate point
+            ptTest[i] += pad->ShapePos();
 
-                // polygons are rectangles with width of copper bridge value
-                switch( i )
-                {
-                case 0:       // lower stub
-                    spokes.Append( -thermalBridgeWidth, endpoint.y );
-                    spokes.Append( +thermalBridgeWidth, endpoint.y );
-                    spokes.Append( +thermalBridgeWidth, startpoint.y );
-                    spokes.Append( -thermalBridgeWidth, startpoint.y );
-                    break;
-
-                case 1:       // upper stub
-                    spokes.Append( -thermalBridgeWidth, -endpoint.y );
-                    spokes.Append( +thermalBridgeWidth, -endpoint.y );
-                    spokes.Append( +thermalBridgeWidth, -startpoint.y );
-                    spokes.Append( -thermalBridgeWidth, -startpoint.y );
-                    break;
-
-                case 2:       // right stub
-                    spokes.Append( endpoint.x, -thermalBridgeWidth );
-                    spokes.Append( endpoint.x, thermalBridgeWidth );
-                    spokes.Append( +startpoint.x, thermalBridgeWidth );
-                    spokes.Append( +startpoint.x, -thermalBridgeWidth );
-                    break;
-
-                case 3:       // left stub
-                    spokes.Append( -endpoint.x, -thermalBridgeWidth );
-                    spokes.Append( -endpoint.x, thermalBridgeWidth );
-                    spokes.Append( -startpoint.x, thermalBridgeWidth );
-                    spokes.Append( -startpoint.x, -thermalBridgeWidth );
-                    break;
-                }
+            if( aRawFilledArea.Contains( ptTest[i] ) )
+                continue;
 
-                aCornerBuffer.NewOutline();
+            spokes.Clear();
 
-                // add computed polygon to list
-                for( int ic = 0; ic < spokes.PointCount(); ic++ )
-                {
-                    auto cpos = spokes.CPoint( ic );
-                    RotatePoint( cpos, fAngle );                               // Rotate according to module orientation
-                    cpos += pad->ShapePos();                              // Shift origin to position
-                    aCornerBuffer.Append( cpos );
-                }
+            // polygons are rectangles with width of copper bridge value
+            switch( i )
+            {
+            case 0:       // lower stub
+                spokes.Append( -thermalBridgeWidth, endpoint.y );
+                spokes.Append( +thermalBridgeWidth, endpoint.y );
+                spokes.Append( +thermalBridgeWidth, startpoint.y );
+                spokes.Append( -thermalBridgeWidth, startpoint.y );
+                break;
+
+            case 1:       // upper stub
+                spokes.Append( -thermalBridgeWidth, -endpoint.y );
+                spokes.Append( +thermalBridgeWidth, -endpoint.y );
+                spokes.Append( +thermalBridgeWidth, -startpoint.y );
+                spokes.Append( -thermalBridgeWidth, -startpoint.y );
+                break;
+
+            case 2:       // right stub
+                spokes.Append( endpoint.x, -thermalBridgeWidth );
+                spokes.Append( endpoint.x, thermalBridgeWidth );
+                spokes.Append( +startpoint.x, thermalBridgeWidth );
+                spokes.Append( +startpoint.x, -thermalBridgeWidth );
+                break;
+
+            case 3:       // left stub
+                spokes.Append( -endpoint.x, -thermalBridgeWidth );
+                spokes.Append( -endpoint.x, thermalBridgeWidth );
+                spokes.Append( -startpoint.x, thermalBridgeWidth );
+                spokes.Append( -startpoint.x, -thermalBridgeWidth );
+                break;
+            }
+
+            aCornerBuffer.NewOutline();
+
+            // add computed polygon to list
+            for( int ic = 0; ic < spokes.PointCount(); ic++ )
+            {
+                auto cpos = spokes.CPoint( ic );
+                RotatePoint( cpos, fAngle );                               // Rotate according to module orientation
+                cpos += pad->ShapePos();                              // Shift origin to position
+                aCornerBuffer.Append( cpos );
             }
         }
     }
@@ -1175,7 +1674,7 @@ void ZONE_FILLER::addHatchFillTypeOnZone( const ZONE_CONTAINER* aZone, SHAPE_POL
     // It happens for holes near the zone outline
     for( int ii = 0; ii < holes.OutlineCount(); )
     {
-        double area = holes.Outline( ii ).Area();
+        double area = holes.COutline( ii ).Area();
 
         if( area < minimal_hole_area ) // The current hole is too small: remove it
             holes.DeletePolygon( ii );
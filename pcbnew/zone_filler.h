@@ -26,6 +26,7 @@
 #ifndef __ZONE_FILLER_H
 #define __ZONE_FILLER_H
 
+#include <memory>
 #include <vector>
 #include <class_zone.h>
 
@@ -34,6 +35,7 @@ class BOARD;
 class COMMIT;
 class SHAPE_POLY_SET;
 class SHAPE_LINE_CHAIN;
+class ZONE_OBSTACLE_INDEX;
 
 class ZONE_FILLER
 {
@@ -42,6 +44,14 @@ public:
     ~ZONE_FILLER();
 
     void SetProgressReporter( WX_PROGRESS_REPORTER* aReporter );
+
+    /**
+     * Set the count of clearance holes from which a zone is filled by tiles (see
+     * subtractHolesByTiles()), 0 to never use tiles.  The ZoneFillTilingThreshold
+     * advanced config value is used by default.
+     */
+    void SetTilingThreshold( int aHoleCount ) { m_tilingThreshold = aHoleCount; }
+
     bool Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck = false );
 
 private:
@@ -49,6 +59,16 @@ private:
     void buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
             SHAPE_POLY_SET& aFeatures ) const;
 
+    /**
+     * Function computeFillInputsHash
+     * Builds a hash of everything the fill of aZone depends on: its outline and settings,
+     * the board settings used by the filler and the items buildZoneFeatureHoleList() can
+     * use to make holes in the fill.
+     * If the hash has not changed since the zone was filled, the fill cached in the zone
+     * is still valid.
+     */
+    MD5_HASH computeFillInputsHash( const ZONE_CONTAINER* aZone ) const;
+
     /**
      * Function computeRawFilledAreas
      * Add non copper areas polygons (pads and tracks with clearance)
@@ -66,6 +86,15 @@ private:
             SHAPE_POLY_SET& aRawPolys,
             SHAPE_POLY_SET& aFinalPolys ) const;
 
+    /**
+     * Function subtractHolesByTiles
+     * Subtracts aHoles from aSolidAreas like BooleanSubtract(), but splits the bounding box
+     * of aSolidAreas in tiles: the holes are merged and subtracted in each tile in parallel,
+     * then the tiles are stitched back together.
+     * Used for the zones having a lot of holes, whose fill would otherwise run on one thread.
+     */
+    void subtractHolesByTiles( SHAPE_POLY_SET& aSolidAreas, const SHAPE_POLY_SET& aHoles ) const;
+
     /**
      * Function buildUnconnectedThermalStubsPolygonList
      * Creates a set of polygons corresponding to stubs created by thermal shapes on pads
@@ -111,6 +140,10 @@ private:
     BOARD* m_board;
     COMMIT* m_commit;
     WX_PROGRESS_REPORTER* m_progressReporter;
+    int m_tilingThreshold;
+
+    ///< Index of the items which can make holes in the zones, valid during Fill()
+    std::unique_ptr<ZONE_OBSTACLE_INDEX> m_obstacles;
 };
 
 #endif
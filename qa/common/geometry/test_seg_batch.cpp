@@ -0,0 +1,248 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <chrono>
+#include <random>
+
+#include <geometry/seg_batch.h>
+#include <geometry/shape_line_chain.h>
+
+
+/**
+ * The smallest SEG::SquaredDistance() between aP and the segments of aChain, one by one
+ */
+static SEG::ecoord scalarSquaredDistance( const SHAPE_LINE_CHAIN& aChain, const VECTOR2I& aP )
+{
+    SEG::ecoord d = VECTOR2I::ECOORD_MAX;
+
+    for( int i = 0; i < aChain.SegmentCount(); i++ )
+        d = std::min( d, aChain.CSegment( i ).SquaredDistance( aP ) );
+
+    return d;
+}
+
+
+/**
+ * The smallest SEG::Distance() between aSeg and the segments of aChain, one by one
+ */
+static int scalarDistance( const SHAPE_LINE_CHAIN& aChain, const SEG& aSeg )
+{
+    int d = std::numeric_limits<int>::max();
+
+    for( int i = 0; i < aChain.SegmentCount(); i++ )
+        d = std::min( d, aChain.CSegment( i ).Distance( aSeg ) );
+
+    return d;
+}
+
+
+/**
+ * The collision test of SHAPE_LINE_CHAIN::Collide() for one segment
+ */
+static bool segmentCollision( const SEG& aSegA, const SEG& aSegB, int aClearance )
+{
+    BOX2I box_a( aSegB.A, aSegB.B - aSegB.A );
+    BOX2I box_b( aSegA.A, aSegA.B - aSegA.A );
+
+    return box_a.SquaredDistance( box_b ) < (BOX2I::ecoord_type) aClearance * aClearance
+           && aSegA.Collide( aSegB, aClearance );
+}
+
+
+/**
+ * The index of the first segment of aChain colliding with aSeg, one by one
+ */
+static int scalarCollision( const SHAPE_LINE_CHAIN& aChain, const SEG& aSeg, int aClearance )
+{
+    for( int i = 0; i < aChain.SegmentCount(); i++ )
+    {
+        if( segmentCollision( aChain.CSegment( i ), aSeg, aClearance ) )
+            return i;
+    }
+
+    return -1;
+}
+
+
+/**
+ * A chain of aCount random points, in a square of aRange units around the origin
+ */
+static SHAPE_LINE_CHAIN randomChain( std::mt19937& aRng, int aCount, int aRange, bool aClosed )
+{
+    std::uniform_int_distribution<int> coord( -aRange, aRange );
+    SHAPE_LINE_CHAIN                   chain;
+
+    for( int i = 0; i < aCount; i++ )
+        chain.Append( VECTOR2I( coord( aRng ), coord( aRng ) ), true );
+
+    chain.SetClosed( aClosed );
+
+    return chain;
+}
+
+
+BOOST_AUTO_TEST_SUITE( SegBatch )
+
+
+/**
+ * The batch results must be exactly the ones of the SEG methods, for any number of segments
+ * (to cover the vectorized blocks and the remaining segments) and coordinate range.
+ */
+BOOST_AUTO_TEST_CASE( MatchesScalar )
+{
+    BOOST_TEST_MESSAGE( "Instruction set: " << SEG_BATCH::InstructionSet() );
+
+    std::mt19937 rng( 42 );
+    const int    ranges[] = { 10, 100000, 1000000000 };
+
+    for( int range : ranges )
+    {
+        std::uniform_int_distribution<int> coord( -range, range );
+
+        for( int count = 0; count < 40; count++ )
+        {
+            for( int closed = 0; closed < 2; closed++ )
+            {
+                SHAPE_LINE_CHAIN chain = randomChain( rng, count, range, closed );
+                const VECTOR2I*  pts = chain.CPoints().data();
+
+                for( int k = 0; k < 20; k++ )
+                {
+                    VECTOR2I p( coord( rng ), coord( rng ) );
+                    SEG      seg( p, VECTOR2I( coord( rng ), coord( rng ) ) );
+                    int      clearance = std::abs( coord( rng ) ) / 8;
+
+                    BOOST_CHECK_EQUAL( SEG_BATCH::SquaredDistance( pts, count, closed, p ),
+                                       scalarSquaredDistance( chain, p ) );
+
+                    BOOST_CHECK_EQUAL( SEG_BATCH::Distance( pts, count, closed, seg ),
+                                       scalarDistance( chain, seg ) );
+
+                    auto collide = [&]( const SEG& aSeg )
+                    {
+                        return segmentCollision( aSeg, seg, clearance );
+                    };
+
+                    int expected = scalarCollision( chain, seg, clearance );
+
+                    BOOST_CHECK_EQUAL( SEG_BATCH::FindCollision( pts, count, closed, seg,
+                                                                 clearance, collide ),
+                                       expected );
+                    BOOST_CHECK_EQUAL( chain.Collide( seg, clearance ), expected >= 0 );
+                }
+            }
+        }
+    }
+}
+
+
+/**
+ * The points on the segments and on their ends, and the points very close to them.
+ */
+BOOST_AUTO_TEST_CASE( NearSegments )
+{
+    std::mt19937     rng( 7 );
+    SHAPE_LINE_CHAIN chain = randomChain( rng, 37, 5000000, true );
+
+    for( int i = 0; i < chain.SegmentCount(); i++ )
+    {
+        const SEG s = chain.CSegment( i );
+
+        for( const VECTOR2I& pt : { s.A, s.B, s.Center() } )
+        {
+            for( int dx = -2; dx <= 2; dx++ )
+            {
+                VECTOR2I p = pt + VECTOR2I( dx, -dx );
+
+                BOOST_CHECK_EQUAL( SEG_BATCH::SquaredDistance( chain.CPoints().data(),
+                                                               chain.PointCount(), true, p ),
+                                   scalarSquaredDistance( chain, p ) );
+                BOOST_CHECK_EQUAL( chain.Distance( p, true ),
+                                   (int) sqrt( scalarSquaredDistance( chain, p ) ) );
+            }
+        }
+    }
+}
+
+
+/**
+ * Micro-benchmark of the batch tests against the SEG methods, on a circle of 4000
+ * segments.  The timings are reported with --log_level=message.
+ */
+BOOST_AUTO_TEST_CASE( Benchmark )
+{
+    using CLOCK = std::chrono::steady_clock;
+
+    SHAPE_LINE_CHAIN circle;
+
+    for( int i = 0; i < 4000; i++ )
+    {
+        double angle = 2 * M_PI * i / 4000;
+        circle.Append( int( 1e6 * cos( angle ) ), int( 1e6 * sin( angle ) ) );
+    }
+
+    circle.SetClosed( true );
+
+    const int   queries = 500;
+    SEG::ecoord scalarSum = 0, batchSum = 0;
+    int         scalarHits = 0, batchHits = 0;
+
+    auto query = []( int aIndex )
+    {
+        return VECTOR2I( aIndex * 4000 - 1000000, aIndex * 1500 - 400000 );
+    };
+
+    CLOCK::time_point start = CLOCK::now();
+
+    for( int i = 0; i < queries; i++ )
+    {
+        scalarSum += scalarSquaredDistance( circle, query( i ) );
+        scalarHits += scalarCollision( circle, SEG( query( i ), VECTOR2I( 0, 0 ) ), 100 ) >= 0;
+    }
+
+    CLOCK::time_point mid = CLOCK::now();
+
+    for( int i = 0; i < queries; i++ )
+    {
+        batchSum += SEG_BATCH::SquaredDistance( circle.CPoints().data(), circle.PointCount(),
+                                                true, query( i ) );
+        batchHits += circle.Collide( SEG( query( i ), VECTOR2I( 0, 0 ) ), 100 );
+    }
+
+    CLOCK::time_point end = CLOCK::now();
+
+    BOOST_CHECK_EQUAL( scalarSum, batchSum );
+    BOOST_CHECK_EQUAL( scalarHits, batchHits );
+
+    auto ms = []( CLOCK::duration aDuration )
+    {
+        return std::chrono::duration<double, std::milli>( aDuration ).count();
+    };
+
+    BOOST_TEST_MESSAGE( "Scalar: " << ms( mid - start ) << " ms, "
+                        << SEG_BATCH::InstructionSet() << ": " << ms( end - mid ) << " ms" );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
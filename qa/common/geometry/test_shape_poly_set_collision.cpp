@@ -193,4 +193,80 @@ BOOST_AUTO_TEST_CASE( CollideVertexWithClearance )
     }
 }
 
+/**
+ * Contains() indexes the contours of a set queried many times. Checks that the results with
+ * the index are the ones of the contours, on the edges too, and after the set is modified.
+ */
+BOOST_AUTO_TEST_CASE( IndexedContains )
+{
+    // A star with many vertices and a hole, so both contours are indexed
+    SHAPE_LINE_CHAIN outline, hole;
+
+    for( int ii = 0; ii < 100; ii++ )
+    {
+        double angle = 2 * M_PI * ii / 100;
+        int    radius = ( ii % 2 ) ? 1000 : 600;
+
+        outline.Append( int( radius * cos( angle ) ), int( radius * sin( angle ) ) );
+        hole.Append( int( 200 * cos( -angle ) ), int( 200 * sin( -angle ) ) );
+    }
+
+    outline.SetClosed( true );
+    hole.SetClosed( true );
+
+    SHAPE_POLY_SET polySet;
+    polySet.AddOutline( outline );
+    polySet.AddHole( hole );
+
+    auto expected = [&]( const VECTOR2I& aP )
+    {
+        const SHAPE_LINE_CHAIN& o = polySet.COutline( 0 );
+        const SHAPE_LINE_CHAIN& h = polySet.CHole( 0, 0 );
+
+        return o.PointInside( aP ) && !( h.PointInside( aP ) && !h.PointOnEdge( aP ) );
+    };
+
+    auto checkAll = [&]()
+    {
+        // A grid of points, and the points around the vertices
+        for( int x = -1100; x <= 1100; x += 37 )
+        {
+            for( int y = -1100; y <= 1100; y += 41 )
+                BOOST_CHECK_EQUAL( polySet.Contains( VECTOR2I( x, y ) ), expected( VECTOR2I( x, y ) ) );
+        }
+
+        for( int c = 0; c < 2; c++ )
+        {
+            const SHAPE_LINE_CHAIN& chain = c ? polySet.CHole( 0, 0 ) : polySet.COutline( 0 );
+
+            for( const VECTOR2I& pt : chain.CPoints() )
+            {
+                for( int dx = -2; dx <= 2; dx++ )
+                {
+                    for( int dy = -2; dy <= 2; dy++ )
+                    {
+                        VECTOR2I p = pt + VECTOR2I( dx, dy );
+                        BOOST_CHECK_EQUAL( polySet.Contains( p ), expected( p ) );
+                    }
+                }
+            }
+        }
+    };
+
+    checkAll();
+
+    // A copy shares the index
+    SHAPE_POLY_SET copy( polySet );
+    BOOST_CHECK_EQUAL( copy.Contains( VECTOR2I( 500, 0 ) ), polySet.Contains( VECTOR2I( 500, 0 ) ) );
+
+    // The index must follow the modifications
+    polySet.Move( VECTOR2I( 150, -70 ) );
+    checkAll();
+
+    polySet.Outline( 0 ).Point( 0 ) = VECTOR2I( 2000, 0 );
+    checkAll();
+
+    BOOST_CHECK( !copy.Contains( VECTOR2I( 1500, 0 ) ) );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
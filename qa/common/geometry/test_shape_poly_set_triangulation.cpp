@@ -0,0 +1,80 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_poly_set.h>
+
+#include <qa_utils/geometry/poly_set_construction.h>
+
+
+BOOST_AUTO_TEST_SUITE( SPSTriangulation )
+
+
+/**
+ * Copies of a triangulated polygon set keep the triangulation, whether they are made
+ * by the copy constructor or by assignment.  The zone filler relies on this to reuse
+ * the triangulation of unchanged fills.
+ */
+BOOST_AUTO_TEST_CASE( CopyKeepsTriangulation )
+{
+    SHAPE_POLY_SET poly = KI_TEST::BuildHollowSquare( 1000, 500 );
+
+    poly.CacheTriangulation();
+    BOOST_REQUIRE( poly.IsTriangulationUpToDate() );
+
+    SHAPE_POLY_SET copy( poly );
+    BOOST_CHECK( copy.IsTriangulationUpToDate() );
+    BOOST_CHECK_EQUAL( copy.TriangulatedPolyCount(), poly.TriangulatedPolyCount() );
+
+    SHAPE_POLY_SET assigned;
+    assigned = poly;
+    BOOST_CHECK( assigned.IsTriangulationUpToDate() );
+    BOOST_CHECK_EQUAL( assigned.TriangulatedPolyCount(), poly.TriangulatedPolyCount() );
+}
+
+
+/**
+ * A triangulation which is not up to date is copied, but still known to be out of date.
+ */
+BOOST_AUTO_TEST_CASE( CopyKeepsStaleTriangulationStale )
+{
+    SHAPE_POLY_SET poly = KI_TEST::BuildHollowSquare( 1000, 500 );
+
+    poly.CacheTriangulation();
+    poly.Move( VECTOR2I( 100, 0 ) );
+    BOOST_REQUIRE( !poly.IsTriangulationUpToDate() );
+
+    SHAPE_POLY_SET copy( poly );
+    BOOST_CHECK( !copy.IsTriangulationUpToDate() );
+
+    SHAPE_POLY_SET assigned;
+    assigned = poly;
+    BOOST_CHECK( !assigned.IsTriangulationUpToDate() );
+
+    assigned.CacheTriangulation();
+    BOOST_CHECK( assigned.IsTriangulationUpToDate() );
+    BOOST_CHECK_EQUAL( assigned.TriangulatedPolyCount(), poly.TriangulatedPolyCount() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,156 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_dlist.cpp
+ * Test suite for the element table and the change count of DLISTs.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <base_struct.h>
+#include <core/iterators.h>
+
+
+class TEST_ITEM : public EDA_ITEM
+{
+public:
+    TEST_ITEM( int aValue ) :
+        EDA_ITEM( NOT_USED ),
+        m_value( aValue )
+    {}
+
+    TEST_ITEM* Next() const { return static_cast<TEST_ITEM*>( Pnext ); }
+
+    wxString GetClass() const override
+    {
+        return wxT( "TEST_ITEM" );
+    }
+
+#if defined(DEBUG)
+    void Show( int nestLevel, std::ostream& os ) const override
+    {
+        ShowDummy( os );
+    }
+#endif
+
+    int m_value;
+};
+
+
+/**
+ * Returns the values of the elements in table order.
+ */
+static std::vector<int> tableValues( DLIST<TEST_ITEM>& aList )
+{
+    std::vector<int> values;
+
+    for( unsigned ii = 0; ii < aList.GetSlotCount(); ++ii )
+        values.push_back( aList.GetSlot( ii )->m_value );
+
+    return values;
+}
+
+
+BOOST_AUTO_TEST_SUITE( DList )
+
+
+/**
+ * The table follows the list order, after insertions in the middle and removals.
+ */
+BOOST_AUTO_TEST_CASE( TableOrder )
+{
+    DLIST<TEST_ITEM> list;
+
+    for( int ii = 1; ii <= 4; ++ii )
+        list.PushBack( new TEST_ITEM( ii * 10 ) );
+
+    list.BuildTable();
+    BOOST_CHECK( tableValues( list ) == std::vector<int>( { 10, 20, 30, 40 } ) );
+
+    TEST_ITEM* third = list.GetFirst()->Next()->Next();
+
+    list.Insert( new TEST_ITEM( 25 ), third );
+    list.PushFront( new TEST_ITEM( 5 ) );
+    delete list.Remove( third );
+
+    list.BuildTable();
+    BOOST_CHECK( tableValues( list ) == std::vector<int>( { 5, 10, 20, 25, 40 } ) );
+}
+
+
+/**
+ * The table is only built on request: it is kept as is when the list changes.
+ */
+BOOST_AUTO_TEST_CASE( TableOnRequest )
+{
+    DLIST<TEST_ITEM> list;
+
+    BOOST_CHECK_EQUAL( list.GetSlotCount(), 0u );
+
+    list.PushBack( new TEST_ITEM( 1 ) );
+    BOOST_CHECK_EQUAL( list.GetSlotCount(), 0u );
+
+    list.BuildTable();
+    list.PushBack( new TEST_ITEM( 2 ) );
+    BOOST_CHECK( tableValues( list ) == std::vector<int>( { 1 } ) );
+
+    list.BuildTable();
+    BOOST_CHECK( tableValues( list ) == std::vector<int>( { 1, 2 } ) );
+
+    // Scans follow the links, whatever the table
+    int scanned = 0;
+
+    for( TEST_ITEM* item : DLIST_ITERATOR_WRAPPER<TEST_ITEM>( list ) )
+        scanned += item->m_value;
+
+    BOOST_CHECK_EQUAL( scanned, 3 );
+}
+
+
+/**
+ * The change count follows all additions and removals, table builds excluded.
+ */
+BOOST_AUTO_TEST_CASE( ChangeCount )
+{
+    DLIST<TEST_ITEM> list;
+
+    unsigned changes = list.GetChangeCount();
+
+    list.PushBack( new TEST_ITEM( 1 ) );
+    list.PushFront( new TEST_ITEM( 2 ) );
+    BOOST_CHECK_EQUAL( list.GetChangeCount(), changes + 2 );
+
+    changes = list.GetChangeCount();
+    list.BuildTable();
+    BOOST_CHECK_EQUAL( list.GetChangeCount(), changes );
+
+    delete list.Remove( list.GetFirst() );
+    BOOST_CHECK_EQUAL( list.GetChangeCount(), changes + 1 );
+
+    changes = list.GetChangeCount();
+    list.DeleteAll();
+    BOOST_CHECK_NE( list.GetChangeCount(), changes );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,100 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the keyword lookup of the lexers generated by TokenList2DsnLexer.cmake
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <map>
+#include <set>
+
+// Code under test
+#include <netlist_lexer.h>
+
+
+/**
+ * The token read by a NETLIST_LEXER from aText
+ */
+static int readToken( const std::string& aText )
+{
+    NETLIST_LEXER lexer( aText );
+
+    return lexer.NextTok();
+}
+
+
+BOOST_AUTO_TEST_SUITE( DsnLexer )
+
+
+/**
+ * The keywords are found, and the symbols close to them are not keywords (unless they are
+ * other keywords)
+ */
+BOOST_AUTO_TEST_CASE( Keywords )
+{
+    std::map<std::string, int> keywords;
+
+    for( int tok = 0; std::string( NETLIST_LEXER::TokenName( NL_T::T( tok ) ) )
+                      != "token too big"; tok++ )
+    {
+        keywords[NETLIST_LEXER::TokenName( NL_T::T( tok ) )] = tok;
+    }
+
+    BOOST_REQUIRE( !keywords.empty() );
+
+    std::set<std::string> symbols;
+
+    for( const auto& keyword : keywords )
+    {
+        const std::string& name = keyword.first;
+
+        BOOST_CHECK_EQUAL( readToken( name ), keyword.second );
+
+        for( size_t i = 1; i < name.size(); i++ )
+        {
+            symbols.insert( name.substr( 0, i ) );
+            symbols.insert( name.substr( i ) );
+            symbols.insert( name.substr( 0, i ) + "x" + name.substr( i ) );
+            symbols.insert( name.substr( 0, i - 1 ) + "_" + name.substr( i ) );
+        }
+
+        symbols.insert( name + "s" );
+        symbols.insert( "z" + name );
+    }
+
+    for( const std::string& symbol : symbols )
+    {
+        BOOST_TEST_CONTEXT( "Symbol: " << symbol )
+        {
+            auto it = keywords.find( symbol );
+            int  expected = it != keywords.end() ? it->second : int( DSN_SYMBOL );
+
+            BOOST_CHECK_EQUAL( readToken( symbol ), expected );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
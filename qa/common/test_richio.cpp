@@ -0,0 +1,223 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for MAPPED_FILE_LINE_READER and its use by DSNLEXER
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+// Code under test
+#include <richio.h>
+#include <dsnlexer.h>
+
+
+/**
+ * A temporary file holding some given text, removed when going out of scope
+ */
+class TEMP_TEXT_FILE
+{
+public:
+    TEMP_TEXT_FILE( const std::string& aText )
+    {
+        m_name = wxFileName::CreateTempFileName( "richio" );
+
+        wxFFile out( m_name, "wb" );
+        out.Write( aText.data(), aText.size() );
+    }
+
+    ~TEMP_TEXT_FILE()
+    {
+        wxRemoveFile( m_name );
+    }
+
+    const wxString& GetName() const
+    {
+        return m_name;
+    }
+
+private:
+    wxString m_name;
+};
+
+
+/**
+ * The lines read by ReadLine() of aReader
+ */
+static std::vector<std::string> readLines( LINE_READER& aReader )
+{
+    std::vector<std::string> lines;
+
+    while( aReader.ReadLine() )
+        lines.emplace_back( aReader.Line(), aReader.Length() );
+
+    return lines;
+}
+
+
+/**
+ * The lines read by ReadLineView() of aReader
+ */
+static std::vector<std::string> readLineViews( LINE_READER& aReader )
+{
+    std::vector<std::string> lines;
+
+    while( const char* line = aReader.ReadLineView() )
+        lines.emplace_back( line, aReader.Length() );
+
+    return lines;
+}
+
+
+/**
+ * The tokens and their texts, one per string, read by a DSNLEXER from aReader
+ */
+static std::vector<std::string> readTokens( LINE_READER* aReader )
+{
+    static const KEYWORD keywords[] = { { "module", 0 }, { "pad", 1 } };
+
+    DSNLEXER                 lexer( keywords, 2, aReader );
+    std::vector<std::string> tokens;
+
+    for( int tok = lexer.NextTok(); tok != DSN_EOF; tok = lexer.NextTok() )
+        tokens.push_back( std::to_string( tok ) + ":" + lexer.CurText() );
+
+    return tokens;
+}
+
+
+// clang-format off
+static const std::vector<std::string> texts = {
+    "",
+    "\n",
+    "single line without newline",
+    "(module foo\n  (pad 1 thru_hole)\n\n  (at 1.5 -2e3))\n",
+    "(descr \"plain\")\n(tags \"escaped \\\"quote\\\" \\x41\\101 \\\\\")\n",
+    "(symbol \"ending with an escape \\x4",
+    "(module bar (pad \"1\" smd))",
+};
+// clang-format on
+
+
+BOOST_AUTO_TEST_SUITE( MappedFileLineReader )
+
+
+/**
+ * ReadLine() and ReadLineView() give the lines of FILE_LINE_READER::ReadLine()
+ */
+BOOST_AUTO_TEST_CASE( Lines )
+{
+    for( const std::string& text : texts )
+    {
+        BOOST_TEST_CONTEXT( "Text: " << text )
+        {
+            TEMP_TEXT_FILE          file( text );
+            FILE_LINE_READER        fileReader( file.GetName() );
+            MAPPED_FILE_LINE_READER mappedReader( file.GetName() );
+
+            std::vector<std::string> expected = readLines( fileReader );
+            std::vector<std::string> lines = readLines( mappedReader );
+
+            BOOST_CHECK_EQUAL_COLLECTIONS( lines.begin(), lines.end(),
+                                           expected.begin(), expected.end() );
+            BOOST_CHECK_EQUAL( mappedReader.LineNumber(), fileReader.LineNumber() );
+
+            mappedReader.Rewind();
+            lines = readLineViews( mappedReader );
+
+            BOOST_CHECK_EQUAL_COLLECTIONS( lines.begin(), lines.end(),
+                                           expected.begin(), expected.end() );
+        }
+    }
+}
+
+
+/**
+ * A DSNLEXER reads the same tokens from the line views as from the lines of a
+ * FILE_LINE_READER
+ */
+BOOST_AUTO_TEST_CASE( Tokens )
+{
+    for( const std::string& text : texts )
+    {
+        BOOST_TEST_CONTEXT( "Text: " << text )
+        {
+            TEMP_TEXT_FILE          file( text );
+            FILE_LINE_READER        fileReader( file.GetName() );
+            MAPPED_FILE_LINE_READER mappedReader( file.GetName() );
+
+            std::vector<std::string> expected;
+            std::vector<std::string> tokens;
+            bool                     expectedError = false;
+            bool                     error = false;
+
+            try
+            {
+                expected = readTokens( &fileReader );
+            }
+            catch( const IO_ERROR& )
+            {
+                expectedError = true;
+            }
+
+            try
+            {
+                tokens = readTokens( &mappedReader );
+            }
+            catch( const IO_ERROR& )
+            {
+                error = true;
+            }
+
+            BOOST_CHECK_EQUAL( error, expectedError );
+            BOOST_CHECK_EQUAL_COLLECTIONS( tokens.begin(), tokens.end(),
+                                           expected.begin(), expected.end() );
+        }
+    }
+}
+
+
+/**
+ * CurLine() is the nul terminated current line, even when it is a view in the mapping
+ */
+BOOST_AUTO_TEST_CASE( CurLine )
+{
+    TEMP_TEXT_FILE          file( "(module a)\n(module b)" );
+    MAPPED_FILE_LINE_READER reader( file.GetName() );
+    DSNLEXER                lexer( nullptr, 0, &reader );
+
+    lexer.NextTok();
+    BOOST_CHECK_EQUAL( std::string( lexer.CurLine() ), "(module a)\n" );
+
+    for( int i = 0; i < 4; i++ )
+        lexer.NextTok();
+
+    BOOST_CHECK_EQUAL( std::string( lexer.CurLine() ), "(module b)" );
+    BOOST_CHECK_EQUAL( lexer.CurLineNumber(), 2 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,177 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_thread_pool.cpp
+ * Test suite for THREAD_POOL, TASK_GROUP and ParallelFor.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <thread_pool.h>
+
+#include <stdexcept>
+
+
+BOOST_AUTO_TEST_SUITE( ThreadPool )
+
+
+/**
+ * Every index of a parallel loop is visited exactly once.
+ */
+BOOST_AUTO_TEST_CASE( ParallelForVisitsAll )
+{
+    THREAD_POOL pool( 4 );
+
+    std::vector<std::atomic<int>> visits( 1000 );
+
+    for( auto& v : visits )
+        v = 0;
+
+    ParallelFor( visits.size(), [&]( size_t i ) { visits[i]++; }, 0, pool );
+
+    for( size_t i = 0; i < visits.size(); ++i )
+        BOOST_CHECK_EQUAL( visits[i], 1 );
+}
+
+
+/**
+ * Loops nested in the tasks of another loop complete, even with more outer iterations
+ * than workers (the waiting workers must run the inner tasks).
+ */
+BOOST_AUTO_TEST_CASE( NestedParallelFor )
+{
+    THREAD_POOL      pool( 2 );
+    std::atomic<int> count( 0 );
+
+    ParallelFor( 16, [&]( size_t )
+    {
+        ParallelFor( 16, [&]( size_t ) { count++; }, 0, pool );
+    }, 0, pool );
+
+    BOOST_CHECK_EQUAL( count, 16 * 16 );
+}
+
+
+/**
+ * The first exception thrown by a task is rethrown by Wait(), after all the tasks are
+ * finished.
+ */
+BOOST_AUTO_TEST_CASE( ExceptionForwarded )
+{
+    THREAD_POOL      pool( 3 );
+    TASK_GROUP       group( pool );
+    std::atomic<int> count( 0 );
+
+    for( int ii = 0; ii < 10; ++ii )
+    {
+        group.Run( [&, ii]()
+        {
+            count++;
+
+            if( ii == 5 )
+                throw std::runtime_error( "task failed" );
+        } );
+    }
+
+    BOOST_CHECK_THROW( group.Wait(), std::runtime_error );
+    BOOST_CHECK_EQUAL( count, 10 );
+    BOOST_CHECK_EQUAL( group.GetPendingCount(), 0u );
+
+    // The exception is only reported once
+    BOOST_CHECK_NO_THROW( group.Wait() );
+}
+
+
+/**
+ * WaitFor() returns when the timeout is elapsed if the tasks are still running.
+ */
+BOOST_AUTO_TEST_CASE( WaitForTimeout )
+{
+    THREAD_POOL       pool( 1 );
+    TASK_GROUP        group( pool );
+    std::atomic<bool> release( false );
+
+    group.Run( [&]()
+    {
+        while( !release )
+            std::this_thread::yield();
+    } );
+
+    BOOST_CHECK( !group.WaitFor( std::chrono::milliseconds( 10 ) ) );
+
+    release = true;
+
+    BOOST_CHECK( group.WaitFor( std::chrono::seconds( 10 ) ) );
+}
+
+
+/**
+ * A worker waiting for a group does not run the queued tasks of other groups, even when
+ * it has nothing else to do.
+ */
+BOOST_AUTO_TEST_CASE( WaitRunsOwnTasksOnly )
+{
+    THREAD_POOL       pool( 2 );
+    TASK_GROUP        outer( pool );
+    TASK_GROUP        other( pool );
+    std::atomic<bool> innerStarted( false );
+    std::atomic<bool> innerDone( false );
+    std::atomic<bool> otherQueued( false );
+    std::atomic<bool> otherRanFirst( false );
+
+    outer.Run( [&]()
+    {
+        TASK_GROUP inner( pool );
+
+        // The other worker runs this task, while this one waits for it
+        inner.Run( [&]()
+        {
+            innerStarted = true;
+
+            while( !otherQueued )
+                std::this_thread::yield();
+
+            std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+            innerDone = true;
+        } );
+
+        while( !innerStarted )
+            std::this_thread::yield();
+
+        inner.Wait();
+    } );
+
+    while( !innerStarted )
+        std::this_thread::yield();
+
+    other.Run( [&]() { otherRanFirst = !innerDone; } );
+    otherQueued = true;
+
+    outer.Wait();
+    other.Wait();
+
+    BOOST_CHECK( !otherRanFirst );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
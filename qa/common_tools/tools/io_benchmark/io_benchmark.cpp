@@ -25,6 +25,7 @@
 
 #include <wx/wx.h>
 #include <richio.h>
+#include <dsnlexer.h>
 
 #include <chrono>
 #include <ios>
@@ -157,6 +158,48 @@ static void bench_line_reader_reuse( const wxFileName& aFile, int aReps, BENCH_R
 }
 
 
+/**
+ * Benchmark using the line views of a given LINE_READER implementation.
+ * The LINE_READER is recreated for each cycle.
+ */
+template<typename LR>
+static void bench_line_view( const wxFileName& aFile, int aReps, BENCH_REPORT& report )
+{
+    for( int i = 0; i < aReps; ++i)
+    {
+        LR fstr( aFile.GetFullPath() );
+
+        while( const char* line = fstr.ReadLineView() )
+        {
+            report.linesRead++;
+            report.charAcc += (unsigned char) line[0];
+        }
+    }
+}
+
+
+/**
+ * Benchmark tokenizing the file with a DSNLEXER reading from a given LINE_READER
+ * implementation.  The accumulator sums the first char of the tokens.
+ * The LINE_READER is recreated for each cycle.
+ */
+template<typename LR>
+static void bench_dsnlexer( const wxFileName& aFile, int aReps, BENCH_REPORT& report )
+{
+    for( int i = 0; i < aReps; ++i)
+    {
+        LR       fstr( aFile.GetFullPath() );
+        DSNLEXER lexer( nullptr, 0, &fstr );
+
+        while( lexer.NextTok() != DSN_EOF )
+            report.charAcc += (unsigned char) lexer.CurText()[0];
+
+        // the line number is incremented at EOF
+        report.linesRead += lexer.CurLineNumber() - 1;
+    }
+}
+
+
 /**
  * Benchmark using STRING_LINE_READER on string data read into memory from a file
  * using std::ifstream, but read the data fresh from the file each time
@@ -313,6 +356,11 @@ static std::vector<BENCHMARK> benchmarkList =
     { 'F', bench_fstream_reuse, "std::fstream, reused" },
     { 'r', bench_line_reader<FILE_LINE_READER>, "RichIO FILE_L_R" },
     { 'R', bench_line_reader_reuse<FILE_LINE_READER>, "RichIO FILE_L_R, reused" },
+    { 'm', bench_line_reader<MAPPED_FILE_LINE_READER>, "RichIO MAPPED_L_R" },
+    { 'M', bench_line_reader_reuse<MAPPED_FILE_LINE_READER>, "RichIO MAPPED_L_R, reused" },
+    { 'v', bench_line_view<MAPPED_FILE_LINE_READER>, "RichIO MAPPED_L_R, views" },
+    { 'd', bench_dsnlexer<FILE_LINE_READER>, "DSNLEXER, FILE_L_R" },
+    { 'D', bench_dsnlexer<MAPPED_FILE_LINE_READER>, "DSNLEXER, MAPPED_L_R" },
     { 'n', bench_line_reader<IFSTREAM_LINE_READER>, "std::ifstream L_R" },
     { 'N', bench_line_reader_reuse<IFSTREAM_LINE_READER>, "std::ifstream L_R, reused" },
     { 's', bench_string_lr, "RichIO STRING_L_R"},
@@ -0,0 +1,223 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_drc_incremental.cpp
+ * Test that the incremental DRC run after a commit finds the errors a full run finds.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <algorithm>
+
+#include <class_board.h>
+#include <class_drawsegment.h>
+#include <class_marker_pcb.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <drc.h>
+
+
+/**
+ * Add a rectangular board outline from (aX0, aY0) to (aX1, aY1), in mm.
+ */
+static void addOutline( BOARD* aBoard, int aX0, int aY0, int aX1, int aY1 )
+{
+    const wxPoint corners[] = { wxPoint( Millimeter2iu( aX0 ), Millimeter2iu( aY0 ) ),
+                                wxPoint( Millimeter2iu( aX1 ), Millimeter2iu( aY0 ) ),
+                                wxPoint( Millimeter2iu( aX1 ), Millimeter2iu( aY1 ) ),
+                                wxPoint( Millimeter2iu( aX0 ), Millimeter2iu( aY1 ) ) };
+
+    for( int i = 0; i < 4; i++ )
+    {
+        auto segment = new DRAWSEGMENT( aBoard );
+
+        segment->SetStart( corners[i] );
+        segment->SetEnd( corners[( i + 1 ) % 4] );
+        segment->SetWidth( Millimeter2iu( 0.1 ) );
+        segment->SetLayer( Edge_Cuts );
+
+        aBoard->Add( segment );
+    }
+}
+
+
+/**
+ * Tracks of four nets, the first two too close to each other, and a footprint with
+ * two SMD pads too close to each other.
+ */
+struct DRC_INCREMENTAL_FIXTURE
+{
+    DRC_INCREMENTAL_FIXTURE() :
+            m_board( std::make_unique<BOARD>() ),
+            m_drc( m_board.get() )
+    {
+        for( int net = 1; net <= 5; net++ )
+            m_board->Add( new NETINFO_ITEM( m_board.get(), wxString::Format( "N%d", net ), net ) );
+
+        m_tracks.push_back( AddTrack( 0, 0, 10, 0, 1 ) );
+        m_tracks.push_back( AddTrack( 0, 0.3, 10, 0.3, 2 ) );
+        m_tracks.push_back( AddTrack( 0, 5, 10, 5, 3 ) );
+        m_tracks.push_back( AddTrack( 0, 10, 10, 10, 4 ) );
+
+        m_module = new MODULE( m_board.get() );
+        AddPad( 20, 0, 1 );
+        AddPad( 20, 1.1, 2 );
+        m_board->Add( m_module );
+
+        addOutline( m_board.get(), -10, -10, 40, 40 );
+
+        m_drc.SetIncrementalMode( true );
+    }
+
+    TRACK* AddTrack( double aX0, double aY0, double aX1, double aY1, int aNet )
+    {
+        auto track = new TRACK( m_board.get() );
+
+        track->SetStart( wxPoint( Millimeter2iu( aX0 ), Millimeter2iu( aY0 ) ) );
+        track->SetEnd( wxPoint( Millimeter2iu( aX1 ), Millimeter2iu( aY1 ) ) );
+        track->SetWidth( Millimeter2iu( 0.25 ) );
+        track->SetLayer( F_Cu );
+        track->SetNetCode( aNet );
+
+        m_board->Add( track, ADD_APPEND );
+        return track;
+    }
+
+    void AddPad( double aX, double aY, int aNet )
+    {
+        auto    pad = new D_PAD( m_module );
+        wxPoint pos( Millimeter2iu( aX ), Millimeter2iu( aY ) );
+
+        pad->SetShape( PAD_SHAPE_CIRCLE );
+        pad->SetAttribute( PAD_ATTRIB_SMD );
+        pad->SetLayerSet( D_PAD::SMDMask() );
+        pad->SetSize( wxSize( Millimeter2iu( 1 ), Millimeter2iu( 1 ) ) );
+        pad->SetPos0( pos );
+        pad->SetPosition( pos );
+        pad->SetNetCode( aNet );
+
+        m_module->Add( pad, ADD_APPEND );
+    }
+
+    /**
+     * @return the pairs of items of the markers.  Which item of a pair is the reference
+     * one, and therefore the error code, depend on the order the items are tested in,
+     * which differs between an incremental and a full run.
+     */
+    std::vector<std::pair<const void*, const void*>> MarkerItems() const
+    {
+        std::vector<std::pair<const void*, const void*>> items;
+
+        for( int i = 0; i < m_board->GetMARKERCount(); i++ )
+        {
+            const DRC_ITEM& item = m_board->GetMARKER( i )->GetReporter();
+
+            items.push_back( std::minmax( item.GetMainItemWeakRef(), item.GetAuxItemWeakRef() ) );
+        }
+
+        std::sort( items.begin(), items.end() );
+        return items;
+    }
+
+    /**
+     * Check that the markers left by the incremental DRC are the ones of a full run, then
+     * replace them by the ones of a full run.
+     */
+    void CheckSameAsFullRun()
+    {
+        const auto incremental = MarkerItems();
+
+        m_board->DeleteMARKERs();
+        m_drc.RunClearanceTests();
+
+        const auto full = MarkerItems();
+
+        BOOST_REQUIRE_EQUAL( incremental.size(), full.size() );
+        BOOST_CHECK( incremental == full );
+    }
+
+    std::unique_ptr<BOARD> m_board;
+    DRC                    m_drc;
+    std::vector<TRACK*>    m_tracks;
+    MODULE*                m_module;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( DrcIncremental, DRC_INCREMENTAL_FIXTURE )
+
+
+/**
+ * Modified, added and removed tracks and a moved footprint, passed to UpdateIncremental()
+ * as BOARD_COMMIT::Push() does, once the board is changed.
+ */
+BOOST_AUTO_TEST_CASE( SameMarkersAsFullRun )
+{
+    m_drc.RunClearanceTests();
+
+    // The two first tracks, and the two pads
+    BOOST_CHECK_EQUAL( MarkerItems().size(), 2u );
+
+    BOOST_TEST_CONTEXT( "Track moved next to another one" )
+    {
+        m_tracks[2]->Move( wxPoint( 0, Millimeter2iu( 5.3 ) ) );
+        m_drc.UpdateIncremental( { m_tracks[2] }, {}, m_board->GetItemListsChangeCount() );
+
+        BOOST_CHECK_EQUAL( MarkerItems().size(), 3u );
+        CheckSameAsFullRun();
+    }
+
+    BOOST_TEST_CONTEXT( "Track added over a pad" )
+    {
+        unsigned changeCount = m_board->GetItemListsChangeCount();
+        TRACK*   track = AddTrack( 15, 0, 19.8, 0, 5 );
+
+        m_drc.UpdateIncremental( { track }, {}, changeCount );
+
+        BOOST_CHECK_EQUAL( MarkerItems().size(), 4u );
+        CheckSameAsFullRun();
+    }
+
+    BOOST_TEST_CONTEXT( "Track removed" )
+    {
+        unsigned changeCount = m_board->GetItemListsChangeCount();
+
+        m_board->Remove( m_tracks[1] );
+        m_drc.UpdateIncremental( {}, { m_tracks[1] }, changeCount );
+        delete m_tracks[1];
+
+        BOOST_CHECK_EQUAL( MarkerItems().size(), 3u );
+        CheckSameAsFullRun();
+    }
+
+    BOOST_TEST_CONTEXT( "Footprint moved away from the track" )
+    {
+        m_module->Move( wxPoint( 0, Millimeter2iu( 20 ) ) );
+        m_drc.UpdateIncremental( { m_module }, {}, m_board->GetItemListsChangeCount() );
+
+        BOOST_CHECK_EQUAL( MarkerItems().size(), 2u );
+        CheckSameAsFullRun();
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,183 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_drc_parallel.cpp
+ * Test that the clearance tests give the same markers whatever the number of threads
+ * running them.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_drawsegment.h>
+#include <class_marker_pcb.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <drc.h>
+#include <thread_pool.h>
+
+
+/**
+ * Add a rectangular board outline from (aX0, aY0) to (aX1, aY1), in mm.
+ */
+static void addOutline( BOARD* aBoard, int aX0, int aY0, int aX1, int aY1 )
+{
+    const wxPoint corners[] = { wxPoint( Millimeter2iu( aX0 ), Millimeter2iu( aY0 ) ),
+                                wxPoint( Millimeter2iu( aX1 ), Millimeter2iu( aY0 ) ),
+                                wxPoint( Millimeter2iu( aX1 ), Millimeter2iu( aY1 ) ),
+                                wxPoint( Millimeter2iu( aX0 ), Millimeter2iu( aY1 ) ) };
+
+    for( int i = 0; i < 4; i++ )
+    {
+        auto segment = new DRAWSEGMENT( aBoard );
+
+        segment->SetStart( corners[i] );
+        segment->SetEnd( corners[( i + 1 ) % 4] );
+        segment->SetWidth( Millimeter2iu( 0.1 ) );
+        segment->SetLayer( Edge_Cuts );
+
+        aBoard->Add( segment );
+    }
+}
+
+
+/**
+ * A grid of tracks whose rows alternate nets and are too close to each other, and a row
+ * of through hole pads of alternating nets, too close to each other too.
+ */
+struct DRC_PARALLEL_FIXTURE
+{
+    DRC_PARALLEL_FIXTURE()
+    {
+        m_board = std::make_unique<BOARD>();
+
+        for( int net = 1; net <= NET_COUNT; net++ )
+            m_board->Add( new NETINFO_ITEM( m_board.get(), wxString::Format( "N%d", net ), net ) );
+
+        for( int row = 0; row < 40; row++ )
+        {
+            for( int col = 0; col < 10; col++ )
+            {
+                auto    track = new TRACK( m_board.get() );
+                wxPoint start( Millimeter2iu( col * 3 ), Millimeter2iu( row * 0.4 ) );
+
+                track->SetStart( start );
+                track->SetEnd( start + wxPoint( Millimeter2iu( 2.5 ), 0 ) );
+                track->SetWidth( Millimeter2iu( 0.25 ) );
+                track->SetLayer( F_Cu );
+                track->SetNetCode( 1 + ( row + col ) % NET_COUNT );
+
+                m_board->Add( track, ADD_APPEND );
+            }
+        }
+
+        auto module = new MODULE( m_board.get() );
+
+        for( int i = 0; i < 30; i++ )
+        {
+            auto    pad = new D_PAD( module );
+            wxPoint pos( Millimeter2iu( i * 0.9 ), Millimeter2iu( 20 ) );
+
+            pad->SetShape( PAD_SHAPE_CIRCLE );
+            pad->SetAttribute( PAD_ATTRIB_STANDARD );
+            pad->SetLayerSet( D_PAD::StandardMask() );
+            pad->SetSize( wxSize( Millimeter2iu( 0.8 ), Millimeter2iu( 0.8 ) ) );
+            pad->SetDrillSize( wxSize( Millimeter2iu( 0.5 ), Millimeter2iu( 0.5 ) ) );
+            pad->SetPos0( pos );
+            pad->SetPosition( pos );
+            pad->SetNetCode( 1 + i % NET_COUNT );
+
+            module->Add( pad, ADD_APPEND );
+        }
+
+        m_board->Add( module );
+
+        addOutline( m_board.get(), -10, -10, 40, 30 );
+
+        m_board->GetDesignSettings().m_HoleToHoleMin = Millimeter2iu( 0.5 );
+    }
+
+    /**
+     * Run the clearance tests with aThreadCount threads.
+     * @return the descriptions of the resulting markers, in board order.
+     */
+    std::vector<std::string> RunDrc( size_t aThreadCount )
+    {
+        THREAD_POOL pool( aThreadCount );
+        DRC         drc( m_board.get() );
+
+        m_board->DeleteMARKERs();
+
+        drc.SetThreadPool( pool );
+        drc.RunClearanceTests();
+
+        std::vector<std::string> markers;
+
+        for( int i = 0; i < m_board->GetMARKERCount(); i++ )
+        {
+            const MARKER_PCB* marker = m_board->GetMARKER( i );
+            const DRC_ITEM&   item = marker->GetReporter();
+
+            markers.push_back( wxString::Format( "%d %p %p (%d, %d)", item.GetErrorCode(),
+                                                 item.GetMainItemWeakRef(),
+                                                 item.GetAuxItemWeakRef(),
+                                                 marker->GetPosition().x,
+                                                 marker->GetPosition().y ).ToStdString() );
+        }
+
+        return markers;
+    }
+
+    static const int NET_COUNT = 3;
+
+    std::unique_ptr<BOARD> m_board;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( DrcParallel, DRC_PARALLEL_FIXTURE )
+
+
+/**
+ * The markers are added in item order, whatever the thread which found them.
+ */
+BOOST_AUTO_TEST_CASE( SameMarkersAsSerial )
+{
+    const std::vector<std::string> serial = RunDrc( 1 );
+
+    // Tracks, pads and holes all have errors
+    BOOST_CHECK_GT( serial.size(), 400u );
+
+    for( size_t threadCount : { 2, 4, 8 } )
+    {
+        BOOST_TEST_CONTEXT( threadCount << " threads" )
+        {
+            const std::vector<std::string> parallel = RunDrc( threadCount );
+
+            BOOST_CHECK_EQUAL_COLLECTIONS(
+                    parallel.begin(), parallel.end(), serial.begin(), serial.end() );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
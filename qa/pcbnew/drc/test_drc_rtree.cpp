@@ -0,0 +1,209 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+
+#include <drc/drc_rtree.h>
+
+
+/**
+ * A board with a few tracks, added to the board in the given order.
+ */
+struct DRC_RTREE_FIXTURE
+{
+    DRC_RTREE_FIXTURE()
+    {
+        m_board = std::make_unique<BOARD>();
+    }
+
+    TRACK* AddTrack( int aX0, int aY0, int aX1, int aY1, PCB_LAYER_ID aLayer )
+    {
+        auto track = new TRACK( m_board.get() );
+
+        track->SetStart( wxPoint( Millimeter2iu( aX0 ), Millimeter2iu( aY0 ) ) );
+        track->SetEnd( wxPoint( Millimeter2iu( aX1 ), Millimeter2iu( aY1 ) ) );
+        track->SetWidth( Millimeter2iu( 0.25 ) );
+        track->SetLayer( aLayer );
+
+        m_board->Add( track, ADD_APPEND );
+        return track;
+    }
+
+    VIA* AddVia( int aX, int aY )
+    {
+        auto via = new VIA( m_board.get() );
+
+        via->SetPosition( wxPoint( Millimeter2iu( aX ), Millimeter2iu( aY ) ) );
+        via->SetWidth( Millimeter2iu( 0.6 ) );
+        via->SetViaType( VIA_THROUGH );
+        via->SetLayerPair( F_Cu, B_Cu );
+
+        m_board->Add( via, ADD_APPEND );
+        return via;
+    }
+
+    D_PAD* AddPad( MODULE* aModule, int aX, int aY, LSET aLayers, int aDrill )
+    {
+        auto    pad = new D_PAD( aModule );
+        wxPoint pos( Millimeter2iu( aX ), Millimeter2iu( aY ) );
+
+        pad->SetShape( PAD_SHAPE_CIRCLE );
+        pad->SetAttribute( aDrill ? PAD_ATTRIB_HOLE_NOT_PLATED : PAD_ATTRIB_SMD );
+        pad->SetLayerSet( aLayers );
+        pad->SetSize( wxSize( Millimeter2iu( 1 ), Millimeter2iu( 1 ) ) );
+        pad->SetDrillSize( wxSize( Millimeter2iu( aDrill ), Millimeter2iu( aDrill ) ) );
+        pad->SetPos0( pos );
+        pad->SetPosition( pos );
+
+        aModule->Add( pad, ADD_APPEND );
+        return pad;
+    }
+
+    std::unique_ptr<BOARD> m_board;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( DrcRtree, DRC_RTREE_FIXTURE )
+
+
+/**
+ * Only items overlapping the clearance area on a common copper layer are candidates.
+ */
+BOOST_AUTO_TEST_CASE( QueryCollidingNeighbours )
+{
+    TRACK* ref   = AddTrack( 0, 0, 10, 0, F_Cu );
+    TRACK* close = AddTrack( 0, 0, 10, 0, F_Cu );    // overlapping
+    TRACK* far   = AddTrack( 0, 50, 10, 50, F_Cu );  // well away
+    TRACK* back  = AddTrack( 0, 0, 10, 0, B_Cu );    // same place, other layer
+    VIA*   via   = AddVia( 5, 0 );                   // through all layers
+
+    DRC_RTREE index;
+
+    for( TRACK* track : m_board->Tracks() )
+        index.Insert( track );
+
+    BOOST_CHECK_EQUAL( index.GetCount(), 5 );
+
+    std::vector<BOARD_CONNECTED_ITEM*> found;
+    index.QueryColliding( ref, found );
+
+    std::vector<BOARD_CONNECTED_ITEM*> expected = { close, via };
+    BOOST_CHECK_EQUAL_COLLECTIONS( found.begin(), found.end(), expected.begin(), expected.end() );
+
+    // The via is found once although it is indexed on all copper layers
+    index.QueryColliding( via, found );
+
+    expected = { ref, close, back };
+    BOOST_CHECK_EQUAL_COLLECTIONS( found.begin(), found.end(), expected.begin(), expected.end() );
+
+    index.QueryColliding( far, found );
+    BOOST_CHECK( found.empty() );
+}
+
+
+/**
+ * The insertion order restricts the candidates, like the list walk of DRC::doTrackDrc().
+ */
+BOOST_AUTO_TEST_CASE( QueryFollowingOnly )
+{
+    TRACK* a = AddTrack( 0, 0, 10, 0, F_Cu );
+    TRACK* b = AddTrack( 0, 0, 10, 0, F_Cu );
+    TRACK* c = AddTrack( 0, 0, 10, 0, F_Cu );
+
+    DRC_RTREE index;
+
+    for( TRACK* track : m_board->Tracks() )
+        index.Insert( track );
+
+    BOOST_CHECK_EQUAL( index.Order( a ), 0 );
+    BOOST_CHECK_EQUAL( index.Order( c ), 2 );
+
+    std::vector<BOARD_CONNECTED_ITEM*> found;
+    index.QueryColliding( b, found, index.Order( b ) );
+
+    BOOST_REQUIRE_EQUAL( found.size(), 1 );
+    BOOST_CHECK( found[0] == c );
+
+    index.Clear();
+    BOOST_CHECK_EQUAL( index.GetCount(), 0 );
+    BOOST_CHECK_EQUAL( index.Order( a ), -1 );
+}
+
+
+/**
+ * Pads with neither copper layers nor a drill are indexed (they have an order and can be
+ * removed) but are never candidates, as the list walks of the DRC skip them too.  A pad
+ * on technical layers with a hole is a candidate on all the copper layers.
+ */
+BOOST_AUTO_TEST_CASE( TechnicalPads )
+{
+    auto module = new MODULE( m_board.get() );
+    m_board->Add( module );
+
+    D_PAD* smd = AddPad( module, 5, 0, LSET( 2, F_Cu, F_Mask ), 0 );
+    D_PAD* paste = AddPad( module, 5, 0, LSET( 2, F_Paste, F_Mask ), 0 );
+    D_PAD* hole = AddPad( module, 5, 0, LSET( 2, F_Mask, B_Mask ), 1 );
+
+    TRACK* front = AddTrack( 0, 0, 10, 0, F_Cu );
+    TRACK* back = AddTrack( 0, 0, 10, 0, B_Cu );
+
+    DRC_RTREE index;
+
+    for( D_PAD* pad : module->Pads() )
+        index.Insert( pad );
+
+    BOOST_CHECK_EQUAL( index.GetCount(), 3 );
+    BOOST_CHECK_EQUAL( index.Order( paste ), 1 );
+    BOOST_CHECK( DRC_RTREE::ItemLayers( paste ).none() );
+
+    std::vector<BOARD_CONNECTED_ITEM*> found;
+    index.QueryColliding( front, found );
+
+    std::vector<BOARD_CONNECTED_ITEM*> expected = { smd, hole };
+    BOOST_CHECK_EQUAL_COLLECTIONS( found.begin(), found.end(), expected.begin(), expected.end() );
+
+    index.QueryColliding( back, found );
+
+    expected = { hole };
+    BOOST_CHECK_EQUAL_COLLECTIONS( found.begin(), found.end(), expected.begin(), expected.end() );
+
+    index.QueryColliding( paste, found );
+    BOOST_CHECK( found.empty() );
+
+    // The pad to pad test: the technical pad is not a neighbour of the others
+    index.QueryColliding( smd, found );
+
+    expected = { hole };
+    BOOST_CHECK_EQUAL_COLLECTIONS( found.begin(), found.end(), expected.begin(), expected.end() );
+
+    index.Remove( paste );
+    BOOST_CHECK_EQUAL( index.GetCount(), 2 );
+    BOOST_CHECK_EQUAL( index.Order( paste ), -1 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,239 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_connectivity_incremental.cpp
+ * Test suite for the incremental update of the connectivity clusters, checked against
+ * full cluster searches.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_track.h>
+
+#include <connectivity/connectivity_algo.h>
+
+#include <set>
+
+
+/**
+ * A board with two nets, and tracks added to both the board and an incremental
+ * connectivity algorithm.
+ */
+struct CONNECTIVITY_INCREMENTAL_FIXTURE
+{
+    CONNECTIVITY_INCREMENTAL_FIXTURE()
+    {
+        m_board = std::make_unique<BOARD>();
+        m_board->Add( new NETINFO_ITEM( m_board.get(), "GND", 1 ) );
+        m_board->Add( new NETINFO_ITEM( m_board.get(), "VCC", 2 ) );
+
+        m_algo.SetIncremental( true );
+    }
+
+    TRACK* AddTrack( int aX0, int aY0, int aX1, int aY1, int aNet, PCB_LAYER_ID aLayer = F_Cu )
+    {
+        auto track = new TRACK( m_board.get() );
+
+        track->SetStart( wxPoint( Millimeter2iu( aX0 ), Millimeter2iu( aY0 ) ) );
+        track->SetEnd( wxPoint( Millimeter2iu( aX1 ), Millimeter2iu( aY1 ) ) );
+        track->SetWidth( Millimeter2iu( 0.25 ) );
+        track->SetLayer( aLayer );
+        track->SetNetCode( aNet );
+
+        m_board->Add( track, ADD_APPEND );
+        m_algo.Add( track );
+        return track;
+    }
+
+    void RemoveTrack( TRACK* aTrack )
+    {
+        m_algo.Remove( aTrack );
+        m_board->Remove( aTrack );
+        delete aTrack;
+    }
+
+    void MoveTrack( TRACK* aTrack, int aDx, int aDy )
+    {
+        m_algo.Remove( aTrack );
+        aTrack->Move( wxPoint( Millimeter2iu( aDx ), Millimeter2iu( aDy ) ) );
+        m_algo.Add( aTrack );
+    }
+
+    typedef std::set<std::set<const BOARD_CONNECTED_ITEM*>> PARTITION;
+
+    static PARTITION Partition( const CN_CONNECTIVITY_ALGO::CLUSTERS& aClusters )
+    {
+        PARTITION partition;
+
+        for( const auto& cluster : aClusters )
+        {
+            std::set<const BOARD_CONNECTED_ITEM*> parents;
+
+            for( auto item : *cluster )
+                parents.insert( item->Parent() );
+
+            partition.insert( parents );
+        }
+
+        return partition;
+    }
+
+    /**
+     * Checks the incrementally updated clusters are those found by a full search of the
+     * same items.
+     */
+    void CheckClusters()
+    {
+        CN_CONNECTIVITY_ALGO reference;
+        reference.SetIncremental( false );
+
+        for( auto track : m_board->Tracks() )
+            reference.Add( track );
+
+        BOOST_CHECK( Partition( m_algo.GetClusters() ) == Partition( reference.GetClusters() ) );
+    }
+
+    std::unique_ptr<BOARD> m_board;
+    CN_CONNECTIVITY_ALGO   m_algo;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ConnectivityIncremental, CONNECTIVITY_INCREMENTAL_FIXTURE )
+
+
+/**
+ * Adding items merges the clusters they connect, only within a net.
+ */
+BOOST_AUTO_TEST_CASE( AddMergesClusters )
+{
+    AddTrack( 0, 0, 10, 0, 1 );
+    AddTrack( 20, 0, 30, 0, 1 );
+    AddTrack( 10, 5, 20, 5, 2 );
+
+    // The first call makes the full search
+    BOOST_CHECK_EQUAL( m_algo.GetClusters().size(), 3 );
+    CheckClusters();
+
+    // Joins the two GND tracks, under the VCC one
+    AddTrack( 10, 0, 20, 0, 1 );
+    BOOST_CHECK_EQUAL( m_algo.GetClusters().size(), 2 );
+    CheckClusters();
+
+    AddTrack( 10, 5, 10, 10, 2 );
+    BOOST_CHECK_EQUAL( m_algo.GetClusters().size(), 2 );
+    CheckClusters();
+}
+
+
+/**
+ * Removing an item splits its cluster only if it was the single connection between its
+ * neighbours.
+ */
+BOOST_AUTO_TEST_CASE( RemoveSplitsClusters )
+{
+    AddTrack( 0, 0, 10, 0, 1 );
+    TRACK* bridge = AddTrack( 10, 0, 20, 0, 1 );
+    AddTrack( 20, 0, 30, 0, 1 );
+    AddTrack( 30, 0, 30, 10, 1 );
+    AddTrack( 30, 10, 0, 10, 1 );
+    TRACK* loop = AddTrack( 0, 10, 0, 0, 1 );
+
+    // Crosses the bridge, but is not connected to it
+    AddTrack( 15, -5, 15, 5, 2 );
+
+    BOOST_CHECK_EQUAL( m_algo.GetClusters().size(), 2 );
+    CheckClusters();
+
+    // The GND tracks are still connected through the loop
+    RemoveTrack( bridge );
+    BOOST_CHECK_EQUAL( m_algo.GetClusters().size(), 2 );
+    CheckClusters();
+
+    RemoveTrack( loop );
+    BOOST_CHECK_EQUAL( m_algo.GetClusters().size(), 3 );
+    CheckClusters();
+}
+
+
+/**
+ * Moved items leave their cluster and join the clusters at their new position.
+ */
+BOOST_AUTO_TEST_CASE( MoveItems )
+{
+    AddTrack( 0, 0, 10, 0, 1 );
+    TRACK* middle = AddTrack( 10, 0, 20, 0, 1 );
+    AddTrack( 20, 0, 30, 0, 1 );
+    AddTrack( 20, 20, 30, 20, 1 );
+
+    m_algo.GetClusters();
+
+    MoveTrack( middle, 0, 20 );
+    CheckClusters();
+
+    MoveTrack( middle, 0, -20 );
+    CheckClusters();
+
+    for( int ii = 0; ii < 5; ++ii )
+    {
+        MoveTrack( middle, 5, 0 );
+        CheckClusters();
+    }
+}
+
+
+/**
+ * The anchor positions read by the connection search follow the moved and removed items.
+ */
+BOOST_AUTO_TEST_CASE( AnchorPositions )
+{
+    std::vector<TRACK*> tracks;
+
+    for( int ii = 0; ii < 6; ++ii )
+        tracks.push_back( AddTrack( ii * 10, 0, ii * 10 + 10, 5, 1 + ii % 2 ) );
+
+    m_algo.GetClusters();
+
+    RemoveTrack( tracks[0] );
+    MoveTrack( tracks[2], 0, 5 );
+    RemoveTrack( tracks[3] );
+
+    // Drops the removed items
+    m_algo.GetClusters();
+    CheckClusters();
+
+    CN_LIST& list = m_algo.ItemList();
+
+    BOOST_CHECK_EQUAL( list.Size(), 4 );
+
+    for( auto item : list )
+    {
+        auto track = static_cast<TRACK*>( item->Parent() );
+
+        BOOST_CHECK( item->AnchorPos( 0 ) == VECTOR2I( track->GetStart() ) );
+        BOOST_CHECK( item->AnchorPos( 1 ) == VECTOR2I( track->GetEnd() ) );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
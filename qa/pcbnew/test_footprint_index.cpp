@@ -0,0 +1,199 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_footprint_index.cpp
+ * Test that the footprint list is read from the library indices written by a previous
+ * read, unless the library changed since.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <map>
+
+#include <footprint_info_impl.h>
+#include <fp_lib_table.h>
+
+#include <wx/dir.h>
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/textfile.h>
+
+
+/**
+ * A temporary directory holding the "lib" and "other" libraries and the index directory,
+ * removed when going out of scope.
+ */
+struct FOOTPRINT_INDEX_FIXTURE
+{
+    FOOTPRINT_INDEX_FIXTURE()
+    {
+        m_dir = wxFileName::CreateTempFileName( "fpindex" );
+        wxRemoveFile( m_dir );
+        wxFileName::Mkdir( m_dir );
+
+        m_indexDir = wxFileName( m_dir, "index" ).GetFullPath();
+        wxFileName::Mkdir( m_indexDir );
+
+        for( const wxString& nickname : { "lib", "other" } )
+        {
+            wxString path = wxFileName( m_dir, nickname + ".pretty" ).GetFullPath();
+
+            wxFileName::Mkdir( path );
+            m_table.InsertRow( new FP_LIB_TABLE_ROW( nickname, path, "KiCad", wxEmptyString ) );
+        }
+    }
+
+    ~FOOTPRINT_INDEX_FIXTURE()
+    {
+        wxFileName::Rmdir( m_dir, wxPATH_RMDIR_RECURSIVE );
+    }
+
+    /**
+     * Write a footprint of the given description in a library.
+     */
+    void WriteFootprint( const wxString& aNickname, const wxString& aName,
+                         const wxString& aDescription )
+    {
+        wxFileName fn( m_dir, aName + ".kicad_mod" );
+        fn.AppendDir( aNickname + ".pretty" );
+
+        wxFFile out( fn.GetFullPath(), "wb" );
+        out.Write( wxString::Format( "(module %s (layer F.Cu) (tedit 5C000000)\n"
+                                     "  (descr \"%s\")\n"
+                                     "  (pad 1 smd rect (at 0 0) (size 1 1) (layers F.Cu))\n"
+                                     ")\n",
+                                     aName, aDescription ) );
+    }
+
+    /**
+     * Read the footprint list with a new FOOTPRINT_LIST_IMPL, as a new KiCad session would.
+     * @return the descriptions of the footprints, by library and name.
+     */
+    std::map<wxString, wxString> ReadList()
+    {
+        FOOTPRINT_LIST_IMPL list;
+        list.SetIndexDir( m_indexDir );
+
+        BOOST_REQUIRE( list.ReadFootprintFiles( &m_table ) );
+
+        std::map<wxString, wxString> descriptions;
+
+        for( const std::unique_ptr<FOOTPRINT_INFO>& fpinfo : list.GetList() )
+        {
+            descriptions[fpinfo->GetLibNickname() + ":" + fpinfo->GetFootprintName()] =
+                    fpinfo->GetDescription();
+        }
+
+        return descriptions;
+    }
+
+    /**
+     * @return the files of the index directory.
+     */
+    wxArrayString IndexFiles() const
+    {
+        wxArrayString files;
+        wxDir::GetAllFiles( m_indexDir, &files, "*.fp-index", wxDIR_FILES );
+        files.Sort();
+        return files;
+    }
+
+    /**
+     * Replace aOld by aNew in the lines of an index file.
+     */
+    static void EditIndex( const wxString& aFile, const wxString& aOld, const wxString& aNew )
+    {
+        wxTextFile indexFile( aFile );
+
+        BOOST_REQUIRE( indexFile.Open() );
+
+        for( size_t ii = 0; ii < indexFile.GetLineCount(); ++ii )
+        {
+            if( indexFile[ii] == aOld )
+                indexFile[ii] = aNew;
+        }
+
+        BOOST_REQUIRE( indexFile.Write() );
+    }
+
+    wxString     m_dir;
+    wxString     m_indexDir;
+    FP_LIB_TABLE m_table;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( FootprintIndex, FOOTPRINT_INDEX_FIXTURE )
+
+
+/**
+ * The index written by a read is used by the next one, until its library changes.
+ */
+BOOST_AUTO_TEST_CASE( SaveReloadStale )
+{
+    WriteFootprint( "lib", "R1", "first" );
+    WriteFootprint( "other", "C1", "capacitor" );
+
+    BOOST_TEST_CONTEXT( "Libraries parsed and indexed" )
+    {
+        auto descriptions = ReadList();
+
+        BOOST_CHECK_EQUAL( descriptions.size(), 2u );
+        BOOST_CHECK_EQUAL( descriptions["lib:R1"], "first" );
+        BOOST_CHECK_EQUAL( descriptions["other:C1"], "capacitor" );
+
+        // One index per library, named after it
+        wxArrayString files = IndexFiles();
+
+        BOOST_REQUIRE_EQUAL( files.size(), 2u );
+        BOOST_CHECK( wxFileName( files[0] ).GetName().StartsWith( "lib-" ) );
+        BOOST_CHECK( wxFileName( files[1] ).GetName().StartsWith( "other-" ) );
+    }
+
+    // A description only found in the index tells whether it was read
+    EditIndex( IndexFiles()[0], "first", "indexed" );
+
+    BOOST_TEST_CONTEXT( "Index reloaded" )
+    {
+        auto descriptions = ReadList();
+
+        BOOST_CHECK_EQUAL( descriptions.size(), 2u );
+        BOOST_CHECK_EQUAL( descriptions["lib:R1"], "indexed" );
+    }
+
+    WriteFootprint( "lib", "R2", "second" );
+
+    BOOST_TEST_CONTEXT( "Stale index rejected" )
+    {
+        auto descriptions = ReadList();
+
+        BOOST_CHECK_EQUAL( descriptions.size(), 3u );
+        BOOST_CHECK_EQUAL( descriptions["lib:R1"], "first" );
+        BOOST_CHECK_EQUAL( descriptions["lib:R2"], "second" );
+        BOOST_CHECK_EQUAL( descriptions["other:C1"], "capacitor" );
+
+        // The index was rewritten for the new library
+        BOOST_CHECK_EQUAL( IndexFiles().size(), 2u );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
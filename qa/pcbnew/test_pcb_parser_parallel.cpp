@@ -0,0 +1,188 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_pcb_parser_parallel.cpp
+ * Test suite for the parsing of the board items on worker threads, checked against
+ * the sequential parsing.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <kicad_plugin.h>
+#include <pcb_parser.h>
+#include <richio.h>
+
+
+/**
+ * A board with enough items for several parsing chunks, with quoted parentheses, comments,
+ * several records on a line and a net declared after the items using it.
+ *
+ * @param aBadSegment the index of a segment with a parse error, or -1
+ */
+static std::string boardText( int aBadSegment = -1 )
+{
+    std::string text =
+            "(kicad_pcb (version 20171130) (host pcbnew 5.1.0)\n"
+            "  (general (thickness 1.6))\n"
+            "  (page A4)\n"
+            "  (layers\n"
+            "    (0 F.Cu signal)\n"
+            "    (31 B.Cu signal)\n"
+            "    (37 F.SilkS user)\n"
+            "    (44 Edge.Cuts user)\n"
+            "  )\n"
+            "  (net 0 \"\")\n"
+            "  (net 1 GND)\n"
+            "  (net 2 \"Net-(R1-Pad1)\")\n";
+
+    for( int i = 0; i < 40; i++ )
+    {
+        std::string n = std::to_string( i );
+
+        text += "  (module R_0603 (layer F.Cu) (tedit 0) (tstamp " + n + ")\n"
+                "    (at " + n + " 10)\n"
+                "    (fp_text reference R" + n + " (at 0 0) (layer F.SilkS)\n"
+                "      (effects (font (size 1 1) (thickness 0.15))))\n"
+                "    (pad 1 smd rect (at -0.8 0) (size 0.8 0.9) (layers F.Cu)\n"
+                "      (net 2 \"Net-(R1-Pad1)\"))\n"
+                "    (pad 2 smd rect (at 0.8 0) (size 0.8 0.9) (layers F.Cu) (net 1 GND))\n"
+                "  )\n";
+    }
+
+    text += "# a comment line between the records\n"
+            "  (gr_text \"quoted (\\\"parentheses\\\"\" (at 0 0) (layer F.SilkS)\n"
+            "    (effects (font (size 1 1) (thickness 0.15))))\n"
+            "  (gr_line (start 0 0) (end 50 0) (layer Edge.Cuts) (width 0.15))"
+            " (gr_line (start 50 0) (end 50 50) (layer Edge.Cuts) (width 0.15))\n";
+
+    for( int i = 0; i < 300; i++ )
+    {
+        std::string n = std::to_string( i );
+        std::string width = i == aBadSegment ? "oops" : "0.25";
+
+        text += "  (segment (start " + n + " 0) (end " + n + " 5) (width " + width
+                + ") (layer F.Cu) (net " + std::to_string( i % 3 ) + "))\n";
+    }
+
+    text += "  (zone (net 1) (net_name GND) (layer F.Cu) (tstamp 0) (hatch edge 0.508)\n"
+            "    (connect_pads (clearance 0.508))\n"
+            "    (min_thickness 0.254)\n"
+            "    (fill (arc_segments 16) (thermal_gap 0.508) (thermal_bridge_width 0.508))\n"
+            "    (polygon (pts (xy 0 0) (xy 20 0) (xy 20 20) (xy 0 20)))\n"
+            "  )\n"
+            "  (net 3 LATE)\n";
+
+    for( int i = 0; i < 100; i++ )
+    {
+        std::string n = std::to_string( i );
+
+        text += "  (via (at " + n + " 7) (size 0.8) (drill 0.4) (layers F.Cu B.Cu) (net "
+                + std::to_string( i % 4 ) + "))\n";
+    }
+
+    text += ")\n";
+
+    return text;
+}
+
+
+/**
+ * The board parsed from aText, formatted by PCB_IO
+ */
+static std::string parseAndFormat( const std::string& aText, bool aParallel )
+{
+    STRING_LINE_READER reader( aText, "parallel test board" );
+    PCB_PARSER         parser( &reader );
+
+    parser.SetParallelLoad( aParallel );
+
+    std::unique_ptr<BOARD_ITEM> board( parser.Parse() );
+
+    BOOST_REQUIRE( board );
+    BOOST_REQUIRE_EQUAL( board->Type(), PCB_T );
+
+    PCB_IO io;
+
+    io.Format( board.get() );
+
+    return io.GetStringOutput( true );
+}
+
+
+/**
+ * The message of the parse error of aText, or an empty string
+ */
+static std::string parseError( const std::string& aText, bool aParallel )
+{
+    try
+    {
+        parseAndFormat( aText, aParallel );
+    }
+    catch( const IO_ERROR& e )
+    {
+        return TO_UTF8( e.What() );
+    }
+
+    return std::string();
+}
+
+
+BOOST_AUTO_TEST_SUITE( PcbParserParallel )
+
+
+/**
+ * The parallel parsing gives the board of the sequential parsing, items in the same order
+ */
+BOOST_AUTO_TEST_CASE( SameBoard )
+{
+    const std::string text = boardText();
+    const std::string expected = parseAndFormat( text, false );
+
+    BOOST_CHECK( expected.find( "LATE" ) != std::string::npos );
+    BOOST_CHECK_EQUAL( parseAndFormat( text, true ), expected );
+}
+
+
+/**
+ * The parallel parsing reports the error of the sequential parsing, at the same line and
+ * offset
+ */
+BOOST_AUTO_TEST_CASE( SameError )
+{
+    for( int bad : { 0, 137, 299 } )
+    {
+        BOOST_TEST_CONTEXT( "Bad segment: " << bad )
+        {
+            const std::string text = boardText( bad );
+            const std::string expected = parseError( text, false );
+
+            BOOST_CHECK( !expected.empty() );
+            BOOST_CHECK_EQUAL( parseError( text, true ), expected );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,189 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file test_pns_batch_router.cpp
+ * Test suite for PNS_BATCH_ROUTER, the router of the unconnected edges of a board.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+
+#include <connectivity/connectivity_data.h>
+#include <router/pns_batch_router.h>
+
+
+/**
+ * Pads of two nets on the front layer, with a track of another net between the pads of
+ * the first net.
+ */
+struct PNS_BATCH_ROUTER_FIXTURE
+{
+    PNS_BATCH_ROUTER_FIXTURE()
+    {
+        m_board = std::make_unique<BOARD>();
+        m_board->Add( new NETINFO_ITEM( m_board.get(), "A", 1 ) );
+        m_board->Add( new NETINFO_ITEM( m_board.get(), "B", 2 ) );
+        m_board->Add( new NETINFO_ITEM( m_board.get(), "C", 3 ) );
+
+        auto module = new MODULE( m_board.get() );
+
+        addPad( module, 0, 0, 1 );
+        addPad( module, 10, 0, 1 );
+        addPad( module, 0, 20, 2 );
+        addPad( module, 10, 20, 2 );
+
+        m_board->Add( module );
+
+        addTrack( m_board.get(), 5, -2, 5, 2, 3 );
+
+        m_board->BuildConnectivity();
+    }
+
+    static void addTrack( BOARD* aBoard, int aX0, int aY0, int aX1, int aY1, int aNet )
+    {
+        auto track = new TRACK( aBoard );
+
+        track->SetStart( wxPoint( Millimeter2iu( aX0 ), Millimeter2iu( aY0 ) ) );
+        track->SetEnd( wxPoint( Millimeter2iu( aX1 ), Millimeter2iu( aY1 ) ) );
+        track->SetWidth( Millimeter2iu( 0.25 ) );
+        track->SetLayer( F_Cu );
+        track->SetNetCode( aNet );
+
+        aBoard->Add( track );
+    }
+
+    static void addPad( MODULE* aModule, int aX, int aY, int aNet )
+    {
+        auto pad = new D_PAD( aModule );
+        wxPoint pos( Millimeter2iu( aX ), Millimeter2iu( aY ) );
+
+        pad->SetShape( PAD_SHAPE_RECT );
+        pad->SetAttribute( PAD_ATTRIB_SMD );
+        pad->SetLayerSet( D_PAD::SMDMask() );
+        pad->SetSize( wxSize( Millimeter2iu( 1 ), Millimeter2iu( 1 ) ) );
+        pad->SetPos0( pos );
+        pad->SetPosition( pos );
+        pad->SetNetCode( aNet );
+
+        aModule->Add( pad );
+    }
+
+    std::unique_ptr<BOARD> m_board;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( PnsBatchRouter, PNS_BATCH_ROUTER_FIXTURE )
+
+
+/**
+ * Both connections are routed, the first one around the track in its way.
+ */
+BOOST_AUTO_TEST_CASE( RouteAll )
+{
+    BOOST_CHECK_EQUAL( m_board->GetConnectivity()->GetUnconnectedCount(), 2u );
+
+    PNS_BATCH_ROUTER router( m_board.get() );
+    router.SetThreadCount( 2 );
+
+    BOOST_CHECK_EQUAL( router.Route(), 2 );
+    BOOST_CHECK_EQUAL( router.GetStats().m_failed, 0 );
+    BOOST_CHECK_EQUAL( m_board->GetConnectivity()->GetUnconnectedCount(), 0u );
+}
+
+
+/**
+ * Only the connections of the selected nets are routed.
+ */
+BOOST_AUTO_TEST_CASE( SelectedNets )
+{
+    PNS_BATCH_ROUTER router( m_board.get() );
+    router.SetNets( { 2 } );
+
+    BOOST_CHECK_EQUAL( router.Route(), 1 );
+    BOOST_CHECK_EQUAL( m_board->GetConnectivity()->GetUnconnectedCount(), 1u );
+}
+
+
+/**
+ * A connection which cannot be routed, as its end pad is enclosed by a ring of tracks of
+ * another net, does not rip up the route of the other connection: it crosses the straight
+ * way of the connection, but the walkaround gets around it and stops at the ring. The
+ * tracks not made by the router are kept.
+ */
+BOOST_AUTO_TEST_CASE( RipupOnlyBlockers )
+{
+    for( int passes : { 0, 2 } )
+    {
+        BOOST_TEST_CONTEXT( "Rip-up passes: " << passes )
+        {
+            auto board = std::make_unique<BOARD>();
+            board->Add( new NETINFO_ITEM( board.get(), "A", 1 ) );
+            board->Add( new NETINFO_ITEM( board.get(), "B", 2 ) );
+            board->Add( new NETINFO_ITEM( board.get(), "C", 3 ) );
+
+            auto module = new MODULE( board.get() );
+
+            addPad( module, 0, 0, 1 );
+            addPad( module, 10, 0, 1 );
+            addPad( module, 4, -3, 2 );
+            addPad( module, 4, 3, 2 );
+
+            board->Add( module );
+
+            addTrack( board.get(), 8, -2, 12, -2, 3 );
+            addTrack( board.get(), 12, -2, 12, 2, 3 );
+            addTrack( board.get(), 12, 2, 8, 2, 3 );
+            addTrack( board.get(), 8, 2, 8, -2, 3 );
+
+            board->BuildConnectivity();
+
+            BOOST_REQUIRE_EQUAL( board->GetConnectivity()->GetUnconnectedCount(), 2u );
+
+            PNS_BATCH_ROUTER router( board.get() );
+            router.SetRipupPasses( passes );
+
+            BOOST_CHECK_EQUAL( router.Route(), 1 );
+            BOOST_CHECK_EQUAL( router.GetStats().m_failed, 1 );
+            BOOST_CHECK_EQUAL( router.GetStats().m_rippedUp, 0 );
+            BOOST_CHECK_EQUAL( board->GetConnectivity()->GetUnconnectedCount(), 1u );
+
+            int ringTracks = 0;
+
+            for( TRACK* track : board->Tracks() )
+            {
+                if( track->GetNetCode() == 3 )
+                    ringTracks++;
+            }
+
+            BOOST_CHECK_EQUAL( ringTracks, 4 );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
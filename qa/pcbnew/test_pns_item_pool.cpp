@@ -0,0 +1,158 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_pns_item_pool.cpp
+ * Test suite for PNS::ITEM_POOL and the allocation of the router items in node branches.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <thread>
+
+#include <router/pns_item_pool.h>
+#include <router/pns_node.h>
+#include <router/pns_segment.h>
+#include <router/pns_via.h>
+
+
+BOOST_AUTO_TEST_SUITE( PnsItemPool )
+
+
+/**
+ * Freed blocks are reused before the pool grows, and Trim() only releases unused pools.
+ */
+BOOST_AUTO_TEST_CASE( ReuseAndTrim )
+{
+    PNS::ITEM_POOL pool( 40, 4 );
+
+    BOOST_CHECK_EQUAL( pool.GetBlockSize() % alignof( std::max_align_t ), 0u );
+
+    std::vector<void*> blocks;
+
+    for( int ii = 0; ii < 6; ++ii )
+        blocks.push_back( pool.Allocate() );
+
+    BOOST_CHECK_EQUAL( pool.GetUsedCount(), 6u );
+    BOOST_CHECK_EQUAL( pool.GetCapacity(), 8u );
+
+    void* freed = blocks.back();
+    pool.Free( freed );
+    blocks.back() = pool.Allocate();
+
+    BOOST_CHECK_EQUAL( blocks.back(), freed );
+    BOOST_CHECK( !pool.Trim() );
+
+    for( void* block : blocks )
+        pool.Free( block );
+
+    BOOST_CHECK( pool.Trim() );
+    BOOST_CHECK_EQUAL( pool.GetCapacity(), 0u );
+}
+
+
+/**
+ * Blocks freed by another thread are reused by the owner thread.
+ */
+BOOST_AUTO_TEST_CASE( FreeFromOtherThread )
+{
+    PNS::ITEM_POOL pool( 40, 4 );
+
+    std::vector<void*> blocks;
+
+    for( int ii = 0; ii < 4; ++ii )
+        blocks.push_back( pool.Allocate() );
+
+    std::thread( [&]()
+            {
+                BOOST_CHECK( !pool.IsOwnerThread() );
+
+                for( void* block : blocks )
+                    pool.Free( block );
+            } ).join();
+
+    BOOST_CHECK_EQUAL( pool.GetUsedCount(), 0u );
+
+    for( void*& block : blocks )
+        block = pool.Allocate();
+
+    // No new chunk was needed
+    BOOST_CHECK_EQUAL( pool.GetCapacity(), 4u );
+
+    for( void* block : blocks )
+        pool.Free( block );
+}
+
+
+/**
+ * The items created in branches of the world go back to the pools of the session when
+ * the branches are killed, while the committed ones stay in the world.
+ */
+BOOST_AUTO_TEST_CASE( BranchItems )
+{
+    PNS::ITEM_POOLS pools;
+
+    {
+        PNS::ITEM_POOLS::SCOPE scope( pools );
+        PNS::NODE              world;
+
+        for( int ii = 0; ii < 10; ++ii )
+        {
+            world.Add( std::make_unique<PNS::SEGMENT>(
+                    SEG( VECTOR2I( ii * 1000, 0 ), VECTOR2I( ii * 1000, 1000 ) ), 1 ) );
+        }
+
+        PNS::NODE* branch = world.Branch();
+
+        for( int ii = 0; ii < 20; ++ii )
+        {
+            branch->Add( std::make_unique<PNS::SEGMENT>(
+                    SEG( VECTOR2I( ii * 1000, 2000 ), VECTOR2I( ii * 1000, 3000 ) ), 2 ) );
+            branch->Add( std::unique_ptr<PNS::VIA>( new PNS::VIA( VECTOR2I( ii * 1000, 4000 ),
+                    LAYER_RANGE( F_Cu, B_Cu ), 500, 200, 2 ) ) );
+        }
+
+        BOOST_CHECK_EQUAL( pools.GetUsedCount(), 50u );
+
+        world.KillChildren();
+
+        BOOST_CHECK_EQUAL( pools.GetUsedCount(), 10u );
+
+        branch = world.Branch();
+        branch->Add( std::make_unique<PNS::SEGMENT>(
+                SEG( VECTOR2I( 0, 5000 ), VECTOR2I( 1000, 5000 ) ), 3 ) );
+
+        world.Commit( branch );
+
+        BOOST_CHECK_EQUAL( pools.GetUsedCount(), 11u );
+    }
+
+    BOOST_CHECK_EQUAL( pools.GetUsedCount(), 0u );
+
+    // Items created out of a scope come from the heap
+    auto seg = std::make_unique<PNS::SEGMENT>( SEG( VECTOR2I( 0, 0 ), VECTOR2I( 1000, 0 ) ), 1 );
+
+    BOOST_CHECK_EQUAL( pools.GetUsedCount(), 0u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,96 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file test_pns_node.cpp
+ * Test suite for the branches of PNS::NODE, which share the layer sub-indices of their
+ * parent until they modify them.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <router/pns_node.h>
+#include <router/pns_segment.h>
+
+
+BOOST_AUTO_TEST_SUITE( PnsNode )
+
+
+static PNS::SEGMENT* addSegment( PNS::NODE* aNode, int aY, int aLayer, int aNet )
+{
+    auto seg = std::make_unique<PNS::SEGMENT>(
+            SEG( VECTOR2I( 0, aY ), VECTOR2I( 100000, aY ) ), aNet );
+    seg->SetLayer( aLayer );
+
+    PNS::SEGMENT* rv = seg.get();
+    aNode->Add( std::move( seg ) );
+    return rv;
+}
+
+
+static int countColliding( PNS::NODE* aNode, int aY, int aLayer )
+{
+    PNS::SEGMENT probe( SEG( VECTOR2I( 50000, aY - 1000 ), VECTOR2I( 50000, aY + 1000 ) ), 100 );
+    probe.SetLayer( aLayer );
+
+    PNS::NODE::OBSTACLES obstacles;
+    return aNode->QueryColliding( &probe, obstacles );
+}
+
+
+/**
+ * Items removed from a branch of a branch stay in the parent branch, and items added to
+ * the parent after branching are not seen by the existing child.
+ */
+BOOST_AUTO_TEST_CASE( SharedIndex )
+{
+    PNS::NODE world;
+
+    addSegment( &world, 0, F_Cu, 1 );
+
+    PNS::NODE* branch = world.Branch();
+    PNS::SEGMENT* segTop = addSegment( branch, 1000000, F_Cu, 2 );
+    addSegment( branch, 2000000, B_Cu, 3 );
+
+    PNS::NODE* child = branch->Branch();
+
+    BOOST_CHECK_EQUAL( countColliding( child, 0, F_Cu ), 1 );
+    BOOST_CHECK_EQUAL( countColliding( child, 1000000, F_Cu ), 1 );
+    BOOST_CHECK_EQUAL( countColliding( child, 2000000, B_Cu ), 1 );
+
+    child->Remove( segTop );
+
+    BOOST_CHECK_EQUAL( countColliding( child, 1000000, F_Cu ), 0 );
+    BOOST_CHECK_EQUAL( countColliding( branch, 1000000, F_Cu ), 1 );
+
+    addSegment( branch, 2500000, B_Cu, 4 );
+
+    BOOST_CHECK_EQUAL( countColliding( branch, 2500000, B_Cu ), 1 );
+    BOOST_CHECK_EQUAL( countColliding( child, 2500000, B_Cu ), 0 );
+    BOOST_CHECK_EQUAL( countColliding( child, 2000000, B_Cu ), 1 );
+
+    world.KillChildren();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
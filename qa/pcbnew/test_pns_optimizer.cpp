@@ -0,0 +1,190 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file test_pns_optimizer.cpp
+ * Test suite for the obstacle cache of PNS::OPTIMIZER, which must not change the
+ * optimized lines.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <router/pns_line.h>
+#include <router/pns_node.h>
+#include <router/pns_optimizer.h>
+#include <router/pns_segment.h>
+
+
+BOOST_AUTO_TEST_SUITE( PnsOptimizer )
+
+
+static const int MM = 1000000;
+static const int WIDTH = 200000;
+
+
+static PNS::SEGMENT* addObstacle( PNS::NODE* aNode, const VECTOR2I& aA, const VECTOR2I& aB )
+{
+    auto seg = std::make_unique<PNS::SEGMENT>( SEG( aA, aB ), 1 );
+    seg->SetWidth( WIDTH );
+    seg->SetLayer( F_Cu );
+
+    PNS::SEGMENT* rv = seg.get();
+    aNode->Add( std::move( seg ) );
+    return rv;
+}
+
+
+/**
+ * A staircase of 1 mm steps rising 0.5 mm, from (0, aY) to (6 mm, aY + 3 mm)
+ */
+static PNS::LINE staircase( int aY, int aNet )
+{
+    SHAPE_LINE_CHAIN chain;
+
+    for( int i = 0; i < 6; i++ )
+    {
+        chain.Append( VECTOR2I( i * MM, aY + i * MM / 2 ) );
+        chain.Append( VECTOR2I( ( i + 1 ) * MM, aY + i * MM / 2 ) );
+    }
+
+    chain.Append( VECTOR2I( 6 * MM, aY + 3 * MM ) );
+
+    PNS::LINE line;
+    line.SetShape( chain );
+    line.SetWidth( WIDTH );
+    line.SetNet( aNet );
+    line.SetLayer( F_Cu );
+
+    return line;
+}
+
+
+/**
+ * Optimizes each line in turn and replaces it in the world when it changed, as
+ * SHOVE::runOptimizer() does
+ */
+static void optimizeAll( PNS::OPTIMIZER& aOptimizer, PNS::NODE* aWorld,
+                         std::vector<PNS::LINE>& aLines )
+{
+    for( PNS::LINE& line : aLines )
+    {
+        if( !line.IsLinked() )
+            continue;
+
+        PNS::LINE optimized;
+
+        if( aOptimizer.Optimize( &line, &optimized ) )
+        {
+            aOptimizer.CacheRemove( &line );
+            aWorld->Remove( line );
+            line.SetShape( optimized.CLine() );
+            aWorld->Add( line );
+        }
+    }
+}
+
+
+/**
+ * The shapes of the lines after each optimization pass of staircases close enough to
+ * block each other, with obstacles in the way of the longest shortcuts. Some obstacles
+ * and lines are removed from the world between the passes.
+ */
+static std::vector<SHAPE_LINE_CHAIN> optimizeStaircases( bool aUseCache )
+{
+    PNS::NODE                  world;
+    std::vector<PNS::LINE>     lines;
+    std::vector<PNS::SEGMENT*> obstacles;
+
+    for( int i = 0; i < 5; i++ )
+    {
+        int y = i * 32 * MM / 10;
+
+        lines.push_back( staircase( y, i + 2 ) );
+        world.Add( lines.back() );
+
+        obstacles.push_back( addObstacle( &world, VECTOR2I( 28 * MM / 10, y ),
+                                          VECTOR2I( 32 * MM / 10, y ) ) );
+        obstacles.push_back( addObstacle( &world, VECTOR2I( 28 * MM / 10, y + 3 * MM ),
+                                          VECTOR2I( 32 * MM / 10, y + 3 * MM ) ) );
+    }
+
+    PNS::OPTIMIZER optimizer( &world );
+    optimizer.SetEffortLevel( PNS::OPTIMIZER::MERGE_SEGMENTS );
+    optimizer.SetCollisionMask( PNS::ITEM::ANY_T );
+    optimizer.SetUseCache( aUseCache );
+
+    std::vector<SHAPE_LINE_CHAIN> shapes;
+
+    auto pass = [&]()
+    {
+        optimizeAll( optimizer, &world, lines );
+
+        for( const PNS::LINE& line : lines )
+            shapes.push_back( line.CLine() );
+    };
+
+    pass();
+
+    // Every other obstacle, and a line, are removed: the next pass finds shorter paths
+    // if none of them is left in the cache
+    for( size_t i = 0; i < obstacles.size(); i += 2 )
+    {
+        optimizer.CacheRemove( obstacles[i] );
+        world.Remove( obstacles[i] );
+    }
+
+    optimizer.CacheRemove( &lines[2] );
+    world.Remove( lines[2] );
+
+    pass();
+
+    return shapes;
+}
+
+
+/**
+ * The lines optimized with the obstacle cache are the ones optimized against the world
+ * only, before and after items are removed from the world.
+ */
+BOOST_AUTO_TEST_CASE( CacheKeepsResults )
+{
+    const std::vector<SHAPE_LINE_CHAIN> expected = optimizeStaircases( false );
+    const std::vector<SHAPE_LINE_CHAIN> cached = optimizeStaircases( true );
+
+    BOOST_REQUIRE_EQUAL( cached.size(), expected.size() );
+
+    // The staircases are optimized (so the cache is queried)
+    BOOST_CHECK_LT( expected[0].PointCount(), staircase( 0, 2 ).PointCount() );
+
+    for( size_t i = 0; i < expected.size(); i++ )
+    {
+        BOOST_TEST_CONTEXT( "Line " << i % 5 << ", pass " << i / 5 )
+        {
+            BOOST_CHECK_EQUAL( cached[i].PointCount(), expected[i].PointCount() );
+            BOOST_CHECK( cached[i].CompareGeometry( expected[i] ) );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
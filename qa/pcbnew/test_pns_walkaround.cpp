@@ -0,0 +1,131 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file test_pns_walkaround.cpp
+ * Test suite for PNS::WALKAROUND, whose directions walked concurrently must give the
+ * path of the serial walk.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <router/pns_line.h>
+#include <router/pns_node.h>
+#include <router/pns_router.h>
+#include <router/pns_segment.h>
+#include <router/pns_walkaround.h>
+
+
+BOOST_AUTO_TEST_SUITE( PnsWalkaround )
+
+
+static const int MM = 1000000;
+static const int WIDTH = 200000;
+
+
+static void addObstacle( PNS::NODE* aNode, const VECTOR2I& aA, const VECTOR2I& aB )
+{
+    auto seg = std::make_unique<PNS::SEGMENT>( SEG( aA, aB ), 1 );
+    seg->SetWidth( WIDTH );
+    seg->SetLayer( F_Cu );
+    aNode->Add( std::move( seg ) );
+}
+
+
+static PNS::LINE straightLine( const VECTOR2I& aA, const VECTOR2I& aB )
+{
+    PNS::LINE line;
+    line.SetShape( SHAPE_LINE_CHAIN( aA, aB ) );
+    line.SetWidth( WIDTH );
+    line.SetNet( 2 );
+    line.SetLayer( F_Cu );
+
+    return line;
+}
+
+
+/**
+ * Walls of unequal lengths across the lines, so that one direction gets around first,
+ * a pocket that only one direction can leave, and a closed box around the end of the
+ * last line.
+ */
+struct PNS_WALKAROUND_FIXTURE
+{
+    PNS_WALKAROUND_FIXTURE()
+    {
+        addObstacle( &m_world, VECTOR2I( 5 * MM, -2 * MM ), VECTOR2I( 5 * MM, 6 * MM ) );
+        addObstacle( &m_world, VECTOR2I( 10 * MM, -7 * MM ), VECTOR2I( 10 * MM, 3 * MM ) );
+        addObstacle( &m_world, VECTOR2I( 15 * MM, -3 * MM ), VECTOR2I( 15 * MM, 3 * MM ) );
+
+        addObstacle( &m_world, VECTOR2I( 20 * MM, 8 * MM ), VECTOR2I( 30 * MM, 8 * MM ) );
+        addObstacle( &m_world, VECTOR2I( 30 * MM, 8 * MM ), VECTOR2I( 30 * MM, 14 * MM ) );
+        addObstacle( &m_world, VECTOR2I( 30 * MM, 14 * MM ), VECTOR2I( 24 * MM, 14 * MM ) );
+
+        addObstacle( &m_world, VECTOR2I( 40 * MM, -2 * MM ), VECTOR2I( 44 * MM, -2 * MM ) );
+        addObstacle( &m_world, VECTOR2I( 44 * MM, -2 * MM ), VECTOR2I( 44 * MM, 2 * MM ) );
+        addObstacle( &m_world, VECTOR2I( 44 * MM, 2 * MM ), VECTOR2I( 40 * MM, 2 * MM ) );
+        addObstacle( &m_world, VECTOR2I( 40 * MM, 2 * MM ), VECTOR2I( 40 * MM, -2 * MM ) );
+    }
+
+    PNS::WALKAROUND::WALKAROUND_STATUS Walk( const PNS::LINE& aInitial, bool aParallel,
+                                             PNS::LINE& aWalked )
+    {
+        m_router.Settings().SetParallelCandidates( aParallel );
+
+        PNS::WALKAROUND walkaround( &m_world, &m_router );
+        return walkaround.Route( aInitial, aWalked, false );
+    }
+
+    PNS::ROUTER m_router;
+    PNS::NODE   m_world;
+};
+
+
+BOOST_FIXTURE_TEST_CASE( ParallelPicksSerialPath, PNS_WALKAROUND_FIXTURE )
+{
+    const std::vector<PNS::LINE> initial = {
+        straightLine( VECTOR2I( 0, 0 ), VECTOR2I( 20 * MM, 0 ) ),
+        straightLine( VECTOR2I( 0, 2 * MM ), VECTOR2I( 12 * MM, -1 * MM ) ),
+        straightLine( VECTOR2I( 20 * MM, 11 * MM ), VECTOR2I( 35 * MM, 11 * MM ) ),
+        straightLine( VECTOR2I( 26 * MM, 11 * MM ), VECTOR2I( 35 * MM, 11 * MM ) ),
+        straightLine( VECTOR2I( 35 * MM, 0 ), VECTOR2I( 42 * MM, 0 ) ),
+    };
+
+    for( size_t i = 0; i < initial.size(); i++ )
+    {
+        BOOST_TEST_CONTEXT( "Line " << i )
+        {
+            PNS::LINE serial, parallel;
+
+            auto serialStatus = Walk( initial[i], false, serial );
+            auto parallelStatus = Walk( initial[i], true, parallel );
+
+            BOOST_CHECK_EQUAL( parallelStatus, serialStatus );
+            BOOST_CHECK_EQUAL( parallel.PointCount(), serial.PointCount() );
+            BOOST_CHECK( parallel.CLine().CompareGeometry( serial.CLine() ) );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,161 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_ratsnest_incremental.cpp
+ * Test suite for the update of the ratsnest of a net after edits, checked against the
+ * ratsnest computed from scratch.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_track.h>
+
+#include <connectivity/connectivity_data.h>
+#include <ratsnest_data.h>
+
+
+/**
+ * A grid of unconnected tracks of a single net.
+ */
+struct RATSNEST_INCREMENTAL_FIXTURE
+{
+    RATSNEST_INCREMENTAL_FIXTURE()
+    {
+        m_board = std::make_unique<BOARD>();
+        m_board->Add( new NETINFO_ITEM( m_board.get(), "GND", 1 ) );
+
+        for( int x = 0; x < 8; x++ )
+        {
+            for( int y = 0; y < 8; y++ )
+            {
+                auto track = new TRACK( m_board.get() );
+
+                track->SetStart( wxPoint( Millimeter2iu( x * 10 ), Millimeter2iu( y * 10 ) ) );
+                track->SetEnd( wxPoint( Millimeter2iu( x * 10 + 3 ), Millimeter2iu( y * 10 ) ) );
+                track->SetWidth( Millimeter2iu( 0.25 ) );
+                track->SetLayer( F_Cu );
+                track->SetNetCode( 1 );
+
+                m_board->Add( track, ADD_APPEND );
+                m_tracks.push_back( track );
+            }
+        }
+
+        m_connectivity.Build( m_board.get() );
+    }
+
+    static uint64_t RatsnestLength( CONNECTIVITY_DATA& aConnectivity )
+    {
+        uint64_t length = 0;
+
+        for( const CN_EDGE& edge : aConnectivity.GetRatsnestForNet( 1 )->GetUnconnected() )
+            length += edge.GetWeight();
+
+        return length;
+    }
+
+    /**
+     * Checks the updated ratsnest has the length of a ratsnest computed from scratch.
+     */
+    void CheckRatsnest()
+    {
+        CONNECTIVITY_DATA reference;
+        reference.Build( m_board.get() );
+
+        BOOST_CHECK_EQUAL( m_connectivity.GetRatsnestForNet( 1 )->GetUnconnected().size(),
+                           reference.GetRatsnestForNet( 1 )->GetUnconnected().size() );
+        BOOST_CHECK_EQUAL( RatsnestLength( m_connectivity ), RatsnestLength( reference ) );
+    }
+
+    std::unique_ptr<BOARD> m_board;
+    std::vector<TRACK*>    m_tracks;
+    CONNECTIVITY_DATA      m_connectivity;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( RatsnestIncremental, RATSNEST_INCREMENTAL_FIXTURE )
+
+
+/**
+ * Tracks moved inside the net update the ratsnest without rebuilding the triangulation.
+ */
+BOOST_AUTO_TEST_CASE( MoveInside )
+{
+    BOOST_CHECK_EQUAL( m_connectivity.GetRatsnestForNet( 1 )->GetUnconnected().size(), 63 );
+
+    for( int ii : { 9, 18, 27, 36, 45, 27 } )
+    {
+        m_tracks[ii]->Move( wxPoint( Millimeter2iu( 1 ), Millimeter2iu( 2 ) ) );
+        m_connectivity.Update( m_tracks[ii] );
+        m_connectivity.RecalculateRatsnest();
+
+        CheckRatsnest();
+    }
+}
+
+
+/**
+ * Connecting and disconnecting tracks changes the clusters, and so the ratsnest.
+ */
+BOOST_AUTO_TEST_CASE( ConnectAndDisconnect )
+{
+    // Joins the start of a track to the end of its left neighbour
+    TRACK* track = m_tracks[20];
+
+    track->Move( wxPoint( Millimeter2iu( -7 ), 0 ) );
+    m_connectivity.Update( track );
+    m_connectivity.RecalculateRatsnest();
+
+    BOOST_CHECK_EQUAL( m_connectivity.GetRatsnestForNet( 1 )->GetUnconnected().size(), 62 );
+    CheckRatsnest();
+
+    track->Move( wxPoint( Millimeter2iu( 7 ), 0 ) );
+    m_connectivity.Update( track );
+    m_connectivity.RecalculateRatsnest();
+
+    BOOST_CHECK_EQUAL( m_connectivity.GetRatsnestForNet( 1 )->GetUnconnected().size(), 63 );
+    CheckRatsnest();
+}
+
+
+/**
+ * Tracks moved out of the hull of the net need a new triangulation.
+ */
+BOOST_AUTO_TEST_CASE( MoveOutside )
+{
+    m_tracks[0]->Move( wxPoint( Millimeter2iu( -50 ), Millimeter2iu( -50 ) ) );
+    m_connectivity.Update( m_tracks[0] );
+    m_connectivity.RecalculateRatsnest();
+
+    CheckRatsnest();
+
+    m_tracks[0]->Move( wxPoint( Millimeter2iu( 50 ), Millimeter2iu( 50 ) ) );
+    m_connectivity.Update( m_tracks[0] );
+    m_connectivity.RecalculateRatsnest();
+
+    CheckRatsnest();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,137 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_zone_filler_tiles.cpp
+ * Test that a zone filled by tiles gets the same copper as a zone filled in one piece.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <zone_filler.h>
+
+
+BOOST_AUTO_TEST_SUITE( ZoneFillerTiles )
+
+
+/**
+ * @return the copper area of aPolys, whose holes may be linked to their outline.
+ */
+static double copperArea( const SHAPE_POLY_SET& aPolys )
+{
+    double area = 0.0;
+
+    for( int ii = 0; ii < aPolys.OutlineCount(); ii++ )
+    {
+        area += std::abs( aPolys.COutline( ii ).Area() );
+
+        for( int jj = 0; jj < aPolys.HoleCount( ii ); jj++ )
+            area -= std::abs( aPolys.CHole( ii, jj ).Area() );
+    }
+
+    return area;
+}
+
+
+/**
+ * Fill a 50 mm square zone with no net, crossed by a grid of diagonal tracks of another
+ * net, some of them crossing each other.
+ * @param aTilingThreshold is given to ZONE_FILLER::SetTilingThreshold().
+ * @return the filled polygons of the zone.
+ */
+static SHAPE_POLY_SET fillZone( int aTilingThreshold )
+{
+    BOARD board;
+
+    board.Add( new NETINFO_ITEM( &board, "N1", 1 ) );
+
+    for( int row = 0; row < 12; row++ )
+    {
+        for( int col = 0; col < 12; col++ )
+        {
+            auto    track = new TRACK( &board );
+            wxPoint start( Millimeter2iu( 2 + col * 4 ), Millimeter2iu( 2 + row * 4 ) );
+            int     length = Millimeter2iu( ( col + row ) % 3 == 0 ? 7 : 3 );
+
+            track->SetStart( start );
+            track->SetEnd( start + wxPoint( length, length ) );
+            track->SetWidth( Millimeter2iu( 0.3 ) );
+            track->SetLayer( F_Cu );
+            track->SetNetCode( 1 );
+
+            board.Add( track, ADD_APPEND );
+        }
+    }
+
+    auto zone = new ZONE_CONTAINER( &board );
+
+    zone->SetLayer( F_Cu );
+    zone->SetZoneClearance( Millimeter2iu( 0.2 ) );
+    zone->SetMinThickness( Millimeter2iu( 0.25 ) );
+
+    SHAPE_POLY_SET* outline = zone->Outline();
+    outline->NewOutline();
+    outline->Append( 0, 0 );
+    outline->Append( Millimeter2iu( 50 ), 0 );
+    outline->Append( Millimeter2iu( 50 ), Millimeter2iu( 50 ) );
+    outline->Append( 0, Millimeter2iu( 50 ) );
+
+    board.Add( zone );
+
+    ZONE_FILLER filler( &board );
+    filler.SetTilingThreshold( aTilingThreshold );
+
+    BOOST_REQUIRE( filler.Fill( { zone } ) );
+
+    return zone->GetFilledPolysList();
+}
+
+
+/**
+ * The tile seams can add vertices to the fill, but not change its copper.
+ */
+BOOST_AUTO_TEST_CASE( SameCopperAsUntiled )
+{
+    const SHAPE_POLY_SET untiled = fillZone( 0 );
+    const SHAPE_POLY_SET tiled = fillZone( 1 );
+
+    const double area = copperArea( untiled );
+
+    // The tracks make holes, and some holes are merged
+    BOOST_CHECK_LT( area, 50.0 * 50.0 * Millimeter2iu( 1 ) * Millimeter2iu( 1 ) );
+    BOOST_CHECK_EQUAL( tiled.OutlineCount(), untiled.OutlineCount() );
+
+    // The copper found in one fill only must be negligible (rounding of the seams)
+    SHAPE_POLY_SET onlyUntiled = untiled;
+    onlyUntiled.BooleanSubtract( tiled, SHAPE_POLY_SET::PM_FAST );
+
+    SHAPE_POLY_SET onlyTiled = tiled;
+    onlyTiled.BooleanSubtract( untiled, SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_CHECK_LT( copperArea( onlyUntiled ), area * 1e-6 );
+    BOOST_CHECK_LT( copperArea( onlyTiled ), area * 1e-6 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
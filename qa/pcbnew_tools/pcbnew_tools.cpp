@@ -23,10 +23,14 @@
 
 #include <qa_utils/utility_program.h>
 
+#include "tools/board_scan/board_scan.h"
 #include "tools/drc_tool/drc_tool.h"
 #include "tools/pcb_parser/pcb_parser_tool.h"
+#include "tools/pns_index_branch/pns_index_branch.h"
+#include "tools/pns_item_alloc/pns_item_alloc.h"
 #include "tools/polygon_generator/polygon_generator.h"
 #include "tools/polygon_triangulation/polygon_triangulation.h"
+#include "tools/router_replay/router_replay.h"
 
 /**
  * List of registered tools.
@@ -35,10 +39,14 @@
  * it's effective enough. When you have a new tool, add it to this list.
  */
 const static std::vector<KI_TEST::UTILITY_PROGRAM*> known_tools = {
+    &board_scan_tool,
     &drc_tool,
     &pcb_parser_tool,
+    &pns_index_branch_tool,
+    &pns_item_alloc_tool,
     &polygon_generator_tool,
     &polygon_triangulation_tool,
+    &router_replay_tool,
 };
 
 
@@ -0,0 +1,106 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "board_scan.h"
+
+#include <class_board.h>
+#include <class_track.h>
+
+#include <profile.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+
+int board_scan_main( int argc, char** argv )
+{
+    int trackCount = ( argc > 1 ) ? std::atoi( argv[1] ) : 200000;
+    int scanCount = ( argc > 2 ) ? std::atoi( argv[2] ) : 200;
+
+    if( trackCount <= 0 || scanCount <= 0 )
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    BOARD board;
+
+    // Edited boards do not keep their tracks in allocation order
+    std::vector<TRACK*> tracks;
+
+    for( int ii = 0; ii < trackCount; ++ii )
+    {
+        auto track = new TRACK( &board );
+        track->SetWidth( ii % 8 );
+        tracks.push_back( track );
+    }
+
+    std::shuffle( tracks.begin(), tracks.end(), std::mt19937( 1 ) );
+
+    for( TRACK* track : tracks )
+        board.m_Track.PushBack( track );
+
+    long long widths = 0;
+
+    {
+        PROF_COUNTER counter( "scans following the links" );
+
+        for( int ii = 0; ii < scanCount; ++ii )
+        {
+            for( TRACK* track : board.Tracks() )
+                widths += track->GetWidth();
+        }
+
+        counter.Show();
+    }
+
+    {
+        PROF_COUNTER counter( "table build" );
+        board.m_Track.BuildTable();
+        counter.Show();
+    }
+
+    {
+        PROF_COUNTER counter( "scans of the table" );
+
+        for( int ii = 0; ii < scanCount; ++ii )
+        {
+            for( unsigned slot = 0; slot < board.m_Track.GetSlotCount(); ++slot )
+                widths += board.m_Track.GetSlot( slot )->GetWidth();
+        }
+
+        counter.Show();
+    }
+
+    // Uses the sum, so that the scans are not optimized out
+    return widths > 0 ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::TOOL_SPECIFIC;
+}
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM board_scan_tool = {
+    "board_scan",
+    "Benchmark the scans of the board tracks through their links and through a table",
+    board_scan_main,
+};
@@ -0,0 +1,119 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "pns_index_branch.h"
+
+#include <router/pns_index.h>
+#include <router/pns_segment.h>
+
+#include <profile.h>
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+
+/**
+ * Copies of the index of a chain of aDepth branches, as NODE::Branch() makes them, each
+ * branch replacing 20 front layer segments of the world.
+ * @param aRebuild re-inserts the items of the parent index in each branch, as branching
+ * did before the sub-indices were shared.
+ */
+static void branchChain( const std::string& aName,
+                         const std::vector<std::unique_ptr<PNS::SEGMENT>>& aWorld, int aDepth,
+                         bool aRebuild )
+{
+    std::vector<std::unique_ptr<PNS::SEGMENT>> replacements;
+    PNS::INDEX                                 index;
+
+    for( const auto& seg : aWorld )
+        index.Add( seg.get() );
+
+    PROF_COUNTER counter( aName );
+
+    for( int depth = 0; depth < aDepth; ++depth )
+    {
+        PNS::INDEX branch;
+
+        if( aRebuild )
+        {
+            for( PNS::ITEM* item : index )
+                branch.Add( item );
+        }
+        else
+        {
+            branch = index;
+        }
+
+        for( int ii = 0; ii < 20; ++ii )
+        {
+            PNS::SEGMENT* old = aWorld[( ( depth * 20 + ii ) * 4 ) % aWorld.size()].get();
+
+            replacements.push_back( std::unique_ptr<PNS::SEGMENT>( old->Clone() ) );
+
+            if( branch.Contains( old ) )
+                branch.Replace( old, replacements.back().get() );
+        }
+
+        index = branch;
+    }
+
+    counter.Show();
+}
+
+
+int pns_index_branch_main( int argc, char** argv )
+{
+    int depth = ( argc > 1 ) ? std::atoi( argv[1] ) : 30;
+
+    if( depth <= 0 )
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    const PCB_LAYER_ID layers[] = { F_Cu, In1_Cu, In2_Cu, B_Cu };
+
+    std::vector<std::unique_ptr<PNS::SEGMENT>> world;
+
+    for( int ii = 0; ii < 20000; ++ii )
+    {
+        VECTOR2I start( ( ii % 200 ) * 1000, ( ii / 200 ) * 1000 );
+        auto     seg = std::make_unique<PNS::SEGMENT>( SEG( start, start + VECTOR2I( 500, 0 ) ),
+                                                       ii % 500 );
+
+        seg->SetLayer( layers[ii % 4] );
+        world.push_back( std::move( seg ) );
+    }
+
+    branchChain( "rebuilt index", world, depth, true );
+    branchChain( "shared sub-indices", world, depth, false );
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM pns_index_branch_tool = {
+    "pns_index_branch",
+    "Benchmark the copies of the router index made by node branches",
+    pns_index_branch_main,
+};
@@ -0,0 +1,134 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "pns_item_alloc.h"
+
+#include <router/pns_item_pool.h>
+#include <router/pns_node.h>
+#include <router/pns_segment.h>
+#include <router/pns_via.h>
+
+#include <profile.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+/**
+ * The allocation pattern of the shove and walkaround iterations: a branch of the world
+ * gets new segments and vias, and is killed.
+ */
+static void branchAndKill( PNS::NODE& aWorld, int aIterations )
+{
+    for( int iter = 0; iter < aIterations; ++iter )
+    {
+        PNS::NODE* branch = aWorld.Branch();
+
+        for( int ii = 0; ii < 200; ++ii )
+        {
+            branch->Add( std::make_unique<PNS::SEGMENT>(
+                    SEG( VECTOR2I( ii * 1000, 2000 ), VECTOR2I( ii * 1000, 3000 ) ), 2 ) );
+
+            if( ii % 4 == 0 )
+            {
+                branch->Add( std::unique_ptr<PNS::VIA>( new PNS::VIA(
+                        VECTOR2I( ii * 1000, 4000 ), LAYER_RANGE( F_Cu, B_Cu ), 500, 200, 2 ) ) );
+            }
+        }
+
+        aWorld.KillChildren();
+    }
+}
+
+
+/**
+ * Runs branchAndKill() on aThreads threads at once, each with its own world, and with
+ * its own session pools if aPooled is set.
+ */
+static void runSessions( const std::string& aName, int aThreads, bool aPooled,
+                         int aIterations )
+{
+    PROF_COUNTER counter( aName );
+
+    std::vector<std::thread> threads;
+
+    for( int ii = 0; ii < aThreads; ++ii )
+    {
+        threads.emplace_back( [aPooled, aIterations]()
+                {
+                    PNS::ITEM_POOLS pools;
+                    std::unique_ptr<PNS::ITEM_POOLS::SCOPE> scope;
+
+                    if( aPooled )
+                        scope.reset( new PNS::ITEM_POOLS::SCOPE( pools ) );
+
+                    PNS::NODE world;
+
+                    for( int jj = 0; jj < 1000; ++jj )
+                    {
+                        world.Add( std::make_unique<PNS::SEGMENT>(
+                                SEG( VECTOR2I( jj * 1000, 0 ), VECTOR2I( jj * 1000, 1000 ) ),
+                                1 ) );
+                    }
+
+                    branchAndKill( world, aIterations );
+                } );
+    }
+
+    for( std::thread& thread : threads )
+        thread.join();
+
+    counter.Show();
+}
+
+
+int pns_item_alloc_main( int argc, char** argv )
+{
+    int iterations = ( argc > 1 ) ? std::atoi( argv[1] ) : 2000;
+
+    if( iterations <= 0 )
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    int threadCount = std::max<int>( std::thread::hardware_concurrency(), 2 );
+
+    runSessions( "heap, 1 thread", 1, false, iterations );
+    runSessions( "pools, 1 thread", 1, true, iterations );
+    runSessions( "heap, " + std::to_string( threadCount ) + " threads", threadCount, false,
+                 iterations );
+    runSessions( "pools, " + std::to_string( threadCount ) + " threads", threadCount, true,
+                 iterations );
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM pns_item_alloc_tool = {
+    "pns_item_alloc",
+    "Benchmark the allocation of router items in node branches",
+    pns_item_alloc_main,
+};
@@ -0,0 +1,433 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "router_replay.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include <common.h>
+#include <core/optional.h>
+
+#include <wx/cmdline.h>
+
+#include <class_board.h>
+
+#include <router/pns_kicad_iface.h>
+#include <router/pns_logger.h>
+#include <router/pns_node.h>
+#include <router/pns_router.h>
+#include <router/pns_sizes_settings.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/scoped_timer.h>
+
+
+using REPLAY_DURATION = std::chrono::microseconds;
+
+using EVENT_ENTRY = PNS::LOGGER::EVENT_ENTRY;
+
+
+/**
+ * The cost of a replayed router call
+ */
+struct REPLAY_STEP
+{
+    REPLAY_DURATION m_duration;
+    uint64_t        m_collisionQueries;
+    uint64_t        m_branches;
+};
+
+
+/**
+ * Replays recorded router calls on a board, through the same router interface as the
+ * routing tools, but without any view or tool to commit the changes.
+ */
+class ROUTER_REPLAY
+{
+public:
+    /**
+     * @param aModeOverride is the routing mode used instead of the recorded ones, if set
+     */
+    ROUTER_REPLAY( BOARD& aBoard, OPT<PNS::PNS_MODE> aModeOverride ) :
+            m_board( aBoard ),
+            m_modeOverride( aModeOverride )
+    {
+        m_iface.SetBoard( &m_board );
+
+        m_router.SetInterface( &m_iface );
+        m_router.ClearWorld();
+        m_router.SyncWorld();
+
+        // The mode of the logs recorded without the settings
+        PNS::ROUTING_SETTINGS settings;
+        settings.SetMode( m_modeOverride ? *m_modeOverride : PNS::RM_Shove );
+        m_router.LoadSettings( settings );
+    }
+
+    ~ROUTER_REPLAY()
+    {
+        m_router.StopRouting();
+        m_router.ClearWorld();
+    }
+
+    /**
+     * Replays one call, and returns its cost.
+     */
+    REPLAY_STEP Replay( const EVENT_ENTRY& aEvent )
+    {
+        PNS::NODE::STATS& stats = PNS::NODE::Stats();
+        stats.Reset();
+
+        REPLAY_STEP step{};
+
+        {
+            SCOPED_TIMER<REPLAY_DURATION> timer( step.m_duration );
+            call( aEvent );
+        }
+
+        step.m_collisionQueries = stats.m_collisionQueries;
+        step.m_branches = stats.m_branches;
+        return step;
+    }
+
+private:
+    /**
+     * Finds the item the recorded call was given: an item of the recorded kind and net
+     * under the event position, on the given layer if possible.
+     */
+    PNS::ITEM* pickItem( const EVENT_ENTRY& aEvent, int aLayer )
+    {
+        if( aEvent.m_itemKind == 0 )
+            return nullptr;
+
+        PNS::ITEM* found = nullptr;
+
+        for( PNS::ITEM* item : m_router.QueryHoverItems( aEvent.m_p ).Items() )
+        {
+            if( item->Kind() != aEvent.m_itemKind || item->Net() != aEvent.m_itemNet )
+                continue;
+
+            if( aLayer < 0 || item->Layers().Overlaps( aLayer ) )
+                return item;
+
+            if( !found )
+                found = item;
+        }
+
+        return found;
+    }
+
+    /**
+     * Applies the routing settings a route or drag was started with.
+     */
+    void loadSettings( const EVENT_ENTRY& aEvent )
+    {
+        if( !aEvent.m_hasSettings )
+            return;
+
+        PNS::ROUTING_SETTINGS settings( aEvent.m_settings );
+
+        if( m_modeOverride )
+            settings.SetMode( *m_modeOverride );
+
+        m_router.LoadSettings( settings );
+    }
+
+    void call( const EVENT_ENTRY& aEvent )
+    {
+        switch( aEvent.m_type )
+        {
+        case PNS::LOGGER::EVT_START_ROUTE:
+        {
+            PNS::ITEM* item = pickItem( aEvent, aEvent.m_layer );
+
+            loadSettings( aEvent );
+            m_router.SetMode( static_cast<PNS::ROUTER_MODE>( aEvent.m_arg ) );
+
+            if( aEvent.m_hasSettings )
+            {
+                m_router.UpdateSizes( aEvent.m_sizes );
+            }
+            else
+            {
+                PNS::SIZES_SETTINGS sizes( m_router.Sizes() );
+                sizes.Init( &m_board, item );
+                m_router.UpdateSizes( sizes );
+            }
+
+            m_router.StartRouting( aEvent.m_p, item, aEvent.m_layer );
+            break;
+        }
+
+        case PNS::LOGGER::EVT_START_DRAG:
+            loadSettings( aEvent );
+            m_router.StartDragging( aEvent.m_p, pickItem( aEvent, -1 ), aEvent.m_arg );
+            break;
+
+        case PNS::LOGGER::EVT_MOVE:
+            m_router.Move( aEvent.m_p, pickItem( aEvent, m_router.GetCurrentLayer() ) );
+            break;
+
+        case PNS::LOGGER::EVT_FIX:
+            m_router.FixRoute( aEvent.m_p, pickItem( aEvent, m_router.GetCurrentLayer() ),
+                               aEvent.m_arg != 0 );
+            break;
+
+        case PNS::LOGGER::EVT_ABORT:
+            m_router.StopRouting();
+            break;
+
+        case PNS::LOGGER::EVT_SWITCH_LAYER:
+            m_router.SwitchLayer( aEvent.m_layer );
+            break;
+
+        case PNS::LOGGER::EVT_TOGGLE_VIA:
+            m_router.ToggleViaPlacement();
+            break;
+
+        case PNS::LOGGER::EVT_FLIP_POSTURE:
+            m_router.FlipPosture();
+            break;
+        }
+    }
+
+    BOARD&             m_board;
+    OPT<PNS::PNS_MODE> m_modeOverride;
+    PNS_KICAD_IFACE    m_iface;
+    PNS::ROUTER        m_router;
+};
+
+
+static std::string eventName( PNS::LOGGER::EVENT_TYPE aType )
+{
+    switch( aType )
+    {
+    case PNS::LOGGER::EVT_START_ROUTE:  return "start-route";
+    case PNS::LOGGER::EVT_START_DRAG:   return "start-drag";
+    case PNS::LOGGER::EVT_MOVE:         return "move";
+    case PNS::LOGGER::EVT_FIX:          return "fix";
+    case PNS::LOGGER::EVT_ABORT:        return "abort";
+    case PNS::LOGGER::EVT_SWITCH_LAYER: return "switch-layer";
+    case PNS::LOGGER::EVT_TOGGLE_VIA:   return "toggle-via";
+    case PNS::LOGGER::EVT_FLIP_POSTURE: return "flip-posture";
+    }
+
+    return "unknown";
+}
+
+
+/**
+ * Nearest-rank percentile of sorted durations
+ */
+static long long percentile( const std::vector<long long>& aSorted, int aPercent )
+{
+    if( aSorted.empty() )
+        return 0;
+
+    size_t rank = ( aSorted.size() * aPercent + 99 ) / 100;
+    return aSorted[ std::max<size_t>( rank, 1 ) - 1 ];
+}
+
+
+static void reportSteps( const std::map<PNS::LOGGER::EVENT_TYPE,
+                                        std::vector<REPLAY_STEP>>& aSteps )
+{
+    printf( "%-14s %8s %10s %10s %10s %10s %12s %10s\n", "call", "count", "p50 (us)",
+            "p90 (us)", "p99 (us)", "max (us)", "queries", "branches" );
+
+    for( const auto& kindSteps : aSteps )
+    {
+        std::vector<long long> durations;
+        uint64_t               queries = 0;
+        uint64_t               branches = 0;
+
+        for( const REPLAY_STEP& step : kindSteps.second )
+        {
+            durations.push_back( step.m_duration.count() );
+            queries += step.m_collisionQueries;
+            branches += step.m_branches;
+        }
+
+        std::sort( durations.begin(), durations.end() );
+
+        printf( "%-14s %8zu %10lld %10lld %10lld %10lld %12llu %10llu\n",
+                eventName( kindSteps.first ).c_str(), durations.size(),
+                percentile( durations, 50 ), percentile( durations, 90 ),
+                percentile( durations, 99 ), durations.back(),
+                (unsigned long long) queries, (unsigned long long) branches );
+    }
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "v",
+            "verbose",
+            _( "print the cost of each replayed call" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "m",
+            "mode",
+            _( "routing mode replacing the recorded one: shove, walkaround or mark" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "repeat",
+            _( "number of times the session is replayed (default 1)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "board file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "router event log" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+/**
+ * Tool-specific return codes
+ */
+enum REPLAY_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+int router_replay_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program replays the router calls recorded during an interactive routing "
+               "session (set RouterEventLog to the file to record to in the advanced config, "
+               "and save the log with the router debug dump), on the board the session started "
+               "from, with the recorded routing settings and sizes. It reports the latency "
+               "percentiles, collision queries and node branches of each kind of call." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+
+    OPT<PNS::PNS_MODE> mode;
+    wxString           modeName;
+
+    if( cl_parser.Found( "mode", &modeName ) )
+    {
+        if( modeName == "shove" )
+            mode = PNS::RM_Shove;
+        else if( modeName == "walkaround" )
+            mode = PNS::RM_Walkaround;
+        else if( modeName == "mark" )
+            mode = PNS::RM_MarkObstacles;
+        else
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long repeat = 1;
+    cl_parser.Found( "repeat", &repeat );
+
+    const std::string boardFile = cl_parser.GetParam( 0 ).ToStdString();
+    const std::string eventFile = cl_parser.GetParam( 1 ).ToStdString();
+
+    std::vector<EVENT_ENTRY> events;
+
+    if( !PNS::LOGGER::LoadEvents( eventFile, events ) )
+    {
+        std::cerr << "Cannot read the router events from " << eventFile << std::endl;
+        return REPLAY_RET_CODES::LOAD_FAILED;
+    }
+
+    std::map<PNS::LOGGER::EVENT_TYPE, std::vector<REPLAY_STEP>> steps;
+
+    for( long ii = 0; ii < repeat; ++ii )
+    {
+        // The replayed calls modify the board, so each replay starts from the file again
+        std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( boardFile );
+
+        if( !board )
+            return REPLAY_RET_CODES::LOAD_FAILED;
+
+        ROUTER_REPLAY replay( *board, mode );
+
+        for( const EVENT_ENTRY& event : events )
+        {
+            REPLAY_STEP step = replay.Replay( event );
+            steps[event.m_type].push_back( step );
+
+            if( verbose )
+            {
+                printf( "%-14s (%d, %d): %lld us, %llu queries, %llu branches\n",
+                        eventName( event.m_type ).c_str(), event.m_p.x, event.m_p.y,
+                        (long long) step.m_duration.count(),
+                        (unsigned long long) step.m_collisionQueries,
+                        (unsigned long long) step.m_branches );
+            }
+        }
+    }
+
+    reportSteps( steps );
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM router_replay_tool = {
+    "router_replay",
+    "Replay a recorded routing session and profile the router",
+    router_replay_main_func,
+};